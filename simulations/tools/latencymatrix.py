@@ -0,0 +1,115 @@
+#!/usr/bin/python
+
+"""
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// Authors: agent
+//
+"""
+
+# Converts measured RTTs into a latency matrix file for the
+# latencyMatrixFile parameter of the SimpleUnderlayConfigurator
+# (see src/underlay/simpleunderlay/LatencyMatrix.h).
+#
+# The input is either a text matrix with one row of RTTs in ms per line
+# (King/Meridian format) or a list of "src dest rtt" triples. Negative
+# or missing RTTs are replaced by the RTT of the reverse direction or,
+# if that is missing as well, by the median of all measured RTTs.
+
+import sys
+import struct
+import numpy as np
+from optparse import OptionParser
+
+MAGIC = "OSRTT\0\0\0"
+VERSION = 1
+
+parser = OptionParser(usage="%prog [options] input output.rtt")
+parser.add_option("-t", "--triples", action="store_true", dest="triples",
+                  default=False, help="input contains src dest rtt triples")
+parser.add_option("-r", "--resolution", type="float", dest="resolution",
+                  default=0.1, help="resolution of the stored RTTs in ms")
+parser.add_option("-s", "--scale", type="float", dest="scale",
+                  default=1.0, help="factor to convert the input RTTs to ms "
+                  "(e.g. 0.001 for King data in us)")
+
+(options, args) = parser.parse_args()
+
+if len(args) != 2:
+    parser.error("input and output file required")
+
+def readMatrix(fileName):
+    rows = []
+    for line in open(fileName):
+        fields = line.split()
+        if len(fields) == 0 or fields[0].startswith("#"):
+            continue
+        rows.append([float(x) for x in fields])
+    n = len(rows)
+    for row in rows:
+        if len(row) != n:
+            sys.exit("matrix is not square")
+    return np.array(rows, dtype=np.float64)
+
+def readTriples(fileName):
+    triples = []
+    n = 0
+    for line in open(fileName):
+        fields = line.split()
+        if len(fields) == 0 or fields[0].startswith("#"):
+            continue
+        if len(fields) != 3:
+            sys.exit("invalid triple: " + line.strip())
+        (src, dest, rtt) = (int(fields[0]), int(fields[1]), float(fields[2]))
+        triples.append((src, dest, rtt))
+        n = max(n, src + 1, dest + 1)
+    matrix = np.empty((n, n), dtype=np.float64)
+    matrix.fill(-1)
+    for (src, dest, rtt) in triples:
+        matrix[src, dest] = rtt
+    return matrix
+
+if options.triples:
+    rtts = readTriples(args[0])
+else:
+    rtts = readMatrix(args[0])
+
+rtts *= options.scale
+n = rtts.shape[0]
+
+# fill in missing measurements
+missing = rtts < 0
+rtts[missing] = rtts.T[missing]
+missing = rtts < 0
+np.fill_diagonal(missing, False)
+if missing.any():
+    rtts[missing] = np.median(rtts[rtts > 0])
+np.fill_diagonal(rtts, 0)
+
+quantized = np.round(rtts / options.resolution)
+clipped = (quantized > 0xffff).sum()
+quantized = np.clip(quantized, 0, 0xffff).astype(np.uint16)
+
+out = open(args[1], "wb")
+out.write(struct.pack("=8sIId", MAGIC, VERSION, n,
+                      options.resolution * 0.001))
+quantized.tofile(out)
+out.close()
+
+print "%d x %d RTTs written to %s (%d filled in, %d clipped)" % \
+    (n, n, args[1], missing.sum(), clipped)
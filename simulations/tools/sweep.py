@@ -0,0 +1,266 @@
+#!/usr/bin/python
+
+"""
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// Authors: agent
+//
+"""
+
+# Executes all runs (repetitions x parameter combinations) of one or more
+# configs in parallel on all local cores and aggregates the results.
+#
+# Runs are executed in batches of consecutive run numbers by a single
+# OverSim process, so files like the nodeCoordinateSource of the
+# SimpleUnderlay are only parsed once per batch. While the runs finish,
+# all scalars are appended to OUTDIR/scalars.csv. At the end
+# OUTDIR/summary.csv contains mean, standard deviation and confidence
+# interval of the GlobalStatistics scalars for every config and
+# combination of iteration variables.
+#
+# Example (in the simulations directory):
+#   ../simulations/tools/sweep.py -f omnetpp.ini -o nightly Chord Kademlia
+
+import os
+import re
+import sys
+import csv
+import math
+import time
+import shlex
+import threading
+import subprocess
+from optparse import OptionParser
+
+try:
+    import Queue as queue
+except ImportError:
+    import queue
+
+try:
+    from multiprocessing import cpu_count
+except ImportError:
+    def cpu_count():
+        return 1
+
+# two-sided 95% quantiles of the t distribution for 1..30 degrees of freedom
+T_TABLE_95 = [12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262,
+              2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101,
+              2.093, 2.086, 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052,
+              2.048, 2.045, 2.042]
+
+def tQuantile(level, df):
+    try:
+        import scipy.stats
+        return scipy.stats.t.ppf((1 + level) / 2.0, df)
+    except ImportError:
+        if level != 0.95:
+            sys.exit("Error: confidence levels other than 0.95 need scipy")
+        if df <= len(T_TABLE_95):
+            return T_TABLE_95[df - 1]
+        return 1.960
+
+def parseRunFilter(runFilter, numRuns):
+    if not runFilter:
+        return list(range(numRuns))
+    runs = []
+    for part in runFilter.split(","):
+        if ".." in part:
+            first, last = part.split("..")
+            runs.extend(range(int(first), int(last) + 1))
+        else:
+            runs.append(int(part))
+    return [run for run in runs if run < numRuns]
+
+def getNumRuns(options, config):
+    cmd = [options.executable, "-u", "Cmdenv", "-f", options.inifile,
+           "-x", config]
+    proc = subprocess.Popen(cmd, stdout=subprocess.PIPE,
+                            stderr=subprocess.STDOUT)
+    output = proc.communicate()[0].decode("utf-8", "replace")
+    match = re.search(r"Number of runs: (\d+)", output)
+    if proc.returncode != 0 or not match:
+        sys.exit("Error: can't determine the number of runs of config " +
+                 config + ":\n" + output)
+    return int(match.group(1))
+
+def parseScalarFile(fileName):
+    """Returns (attributes, [(module, name, value)]) of a .sca file"""
+    attrs = {}
+    scalars = []
+    f = open(fileName)
+    for line in f:
+        if line.startswith("scalar "):
+            fields = shlex.split(line)
+            if len(fields) == 4:
+                scalars.append((fields[1], fields[2], float(fields[3])))
+        elif line.startswith("attr "):
+            fields = shlex.split(line)
+            if len(fields) == 3:
+                attrs[fields[1]] = fields[2]
+    f.close()
+    return attrs, scalars
+
+class Sweep:
+    def __init__(self, options):
+        self.options = options
+        self.lock = threading.Lock()
+        self.jobs = queue.Queue()
+        self.numJobs = 0
+        self.numDone = 0
+        self.failed = []
+        self.samples = {}
+        self.summaryRegex = re.compile(options.summary)
+
+        self.rawDir = os.path.join(options.outdir, "raw")
+        self.logDir = os.path.join(options.outdir, "logs")
+        for d in [self.rawDir, self.logDir]:
+            if not os.path.isdir(d):
+                os.makedirs(d)
+
+        self.scalarFile = open(os.path.join(options.outdir, "scalars.csv"),
+                               "w")
+        self.scalarWriter = csv.writer(self.scalarFile)
+        self.scalarWriter.writerow(["config", "run", "repetition",
+                                    "itervars", "module", "name", "value"])
+
+    def addJobs(self, config, runs):
+        for i in range(0, len(runs), self.options.batch):
+            self.jobs.put((config, runs[i:i + self.options.batch]))
+            self.numJobs += 1
+
+    def runJob(self, config, runs):
+        runList = ",".join([str(run) for run in runs])
+        cmd = [self.options.executable, "-u", "Cmdenv",
+               "-f", self.options.inifile, "-c", config,
+               "--cmdenv-runs-to-execute=" + runList,
+               "--cmdenv-express-mode=true",
+               "--result-dir=" + self.rawDir,
+               "--output-scalar-file=${resultdir}/${configname}-${runnumber}.sca"]
+
+        log = open(os.path.join(self.logDir, "%s-%d.log" % (config, runs[0])),
+                   "w")
+        start = time.time()
+        returnCode = subprocess.call(cmd, stdout=log, stderr=subprocess.STDOUT)
+        log.close()
+
+        results = []
+        for run in runs:
+            fileName = os.path.join(self.rawDir, "%s-%d.sca" % (config, run))
+            if os.path.exists(fileName):
+                results.append((run, parseScalarFile(fileName)))
+
+        self.lock.acquire()
+        try:
+            self.numDone += 1
+            if returnCode != 0 or len(results) != len(runs):
+                self.failed.append((config, runList))
+            for run, (attrs, scalars) in results:
+                self.addResults(config, run, attrs, scalars)
+            self.scalarFile.flush()
+            sys.stdout.write("[%d/%d] %s run %s %s (%.1fs)\n" %
+                             (self.numDone, self.numJobs, config, runList,
+                              returnCode == 0 and "done" or "FAILED",
+                              time.time() - start))
+            sys.stdout.flush()
+        finally:
+            self.lock.release()
+
+    def addResults(self, config, run, attrs, scalars):
+        itervars = attrs.get("iterationvars", "")
+        repetition = attrs.get("repetition", "")
+        for module, name, value in scalars:
+            self.scalarWriter.writerow([config, run, repetition, itervars,
+                                        module, name, repr(value)])
+            if self.summaryRegex.search(module + " " + name):
+                key = (config, itervars, module, name)
+                self.samples.setdefault(key, []).append(value)
+
+    def worker(self):
+        while True:
+            try:
+                config, runs = self.jobs.get_nowait()
+            except queue.Empty:
+                return
+            self.runJob(config, runs)
+
+    def run(self):
+        threads = []
+        for i in range(min(self.options.jobs, self.numJobs)):
+            thread = threading.Thread(target=self.worker)
+            thread.start()
+            threads.append(thread)
+        for thread in threads:
+            thread.join()
+        self.scalarFile.close()
+
+    def writeSummary(self):
+        f = open(os.path.join(self.options.outdir, "summary.csv"), "w")
+        writer = csv.writer(f)
+        writer.writerow(["config", "itervars", "module", "name", "n", "mean",
+                         "stddev", "ci_low", "ci_high"])
+        for key in sorted(self.samples.keys()):
+            values = [v for v in self.samples[key] if not math.isnan(v)]
+            n = len(values)
+            if n == 0:
+                continue
+            mean = sum(values) / n
+            stddev = 0.0
+            halfWidth = 0.0
+            if n > 1:
+                stddev = math.sqrt(sum([(v - mean) ** 2 for v in values]) /
+                                   (n - 1))
+                halfWidth = (tQuantile(self.options.level, n - 1) *
+                             stddev / math.sqrt(n))
+            writer.writerow(list(key) + [n, repr(mean), repr(stddev),
+                                         repr(mean - halfWidth),
+                                         repr(mean + halfWidth)])
+        f.close()
+
+parser = OptionParser(usage="%prog [options] config [config ...]")
+parser.add_option("-f", "--inifile", default="omnetpp.ini", help="Read the configs from INIFILE (default: omnetpp.ini)")
+parser.add_option("-x", "--executable", default="../src/OverSim", help="Path to the OverSim binary (default: ../src/OverSim)")
+parser.add_option("-j", "--jobs", type="int", default=cpu_count(), help="Number of parallel simulations (default: number of cores)")
+parser.add_option("-b", "--batch", type="int", default=4, help="Number of consecutive runs executed by one process (default: 4)")
+parser.add_option("-r", "--runs", help="Only execute the given runs, e.g. 0..9,12 (default: all runs)")
+parser.add_option("-o", "--outdir", default="sweep", help="Write results to OUTDIR (default: sweep)")
+parser.add_option("-s", "--summary", default="globalStatistics", help="Summarize scalars whose \"module name\" matches the regexp SUMMARY (default: globalStatistics)")
+parser.add_option("-c", "--confidence-level", type="float", default=0.95, dest="level", help="Confidence level of the intervals in summary.csv (default: 0.95)")
+(options, args) = parser.parse_args()
+
+if len(args) < 1:
+    parser.error("No config given")
+if options.jobs < 1 or options.batch < 1:
+    parser.error("jobs and batch must be positive")
+
+sweep = Sweep(options)
+for config in args:
+    runs = parseRunFilter(options.runs, getNumRuns(options, config))
+    sweep.addJobs(config, runs)
+
+start = time.time()
+sweep.run()
+sweep.writeSummary()
+
+sys.stdout.write("Executed %d jobs with %d processes in %.1fs\n" %
+                 (sweep.numJobs, options.jobs, time.time() - start))
+
+if sweep.failed:
+    for config, runList in sweep.failed:
+        sys.stdout.write("Failed: %s run %s\n" % (config, runList))
+    sys.exit(1)
@@ -0,0 +1,94 @@
+#!/usr/bin/python
+
+"""
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// Authors: agent
+//
+"""
+
+# Creates binary request traces for the workloadTrace parameter of
+# DHTTestApp and KBRTestApp (see src/common/WorkloadGenerator.h).
+#
+# Either converts a text file with one "GET <keyId>" or "PUT <keyId>"
+# request per line or generates a Zipf distributed trace.
+
+import sys
+import struct
+import random
+import bisect
+from optparse import OptionParser
+
+MAGIC = "OSWKLD01"
+GET = 0
+PUT = 1
+
+parser = OptionParser(usage="%prog [options] output.wkld")
+parser.add_option("-i", "--input", type="string", dest="input",
+                  help="convert the text trace INPUT")
+parser.add_option("-n", "--requests", type="int", dest="requests",
+                  default=100000, help="number of generated requests")
+parser.add_option("-k", "--keys", type="int", dest="keys", default=10000,
+                  help="number of keys of generated traces")
+parser.add_option("-s", "--skew", type="float", dest="skew", default=1.0,
+                  help="Zipf exponent of generated traces")
+parser.add_option("-r", "--read-ratio", type="float", dest="readRatio",
+                  default=0.9, help="fraction of GET requests")
+parser.add_option("--seed", type="int", dest="seed", default=1,
+                  help="random seed")
+
+(options, args) = parser.parse_args()
+
+if len(args) != 1:
+    parser.error("no output file given")
+
+def textRequests(fileName):
+    for line in open(fileName):
+        fields = line.split()
+        if len(fields) == 0 or fields[0].startswith("#"):
+            continue
+        if len(fields) != 2 or fields[0] not in ("GET", "PUT"):
+            sys.exit("invalid request: " + line.strip())
+        yield (int(fields[1]), fields[0] == "PUT" and PUT or GET)
+
+def zipfRequests():
+    random.seed(options.seed)
+    cdf = []
+    total = 0.0
+    for rank in range(1, options.keys + 1):
+        total += 1.0 / rank ** options.skew
+        cdf.append(total)
+    for i in xrange(options.requests):
+        keyId = bisect.bisect_left(cdf, random.random() * total)
+        op = random.random() < options.readRatio and GET or PUT
+        yield (keyId, op)
+
+if options.input:
+    requests = textRequests(options.input)
+else:
+    requests = zipfRequests()
+
+out = open(args[0], "wb")
+out.write(MAGIC)
+count = 0
+for (keyId, op) in requests:
+    out.write(struct.pack("!II", keyId, op))
+    count += 1
+out.close()
+
+print "%d requests written to %s" % (count, args[0])
@@ -36,6 +36,7 @@ using namespace std;
 DHT::DHT()
 {
     dataStorage = NULL;
+    batchLookupTimer = NULL;
 }
 
 DHT::~DHT()
@@ -49,6 +50,8 @@ DHT::~DHT()
 
     pendingRpcs.clear();
 
+    cancelAndDelete(batchLookupTimer);
+
     if (dataStorage != NULL) {
         dataStorage->clear();
     }
@@ -68,15 +71,22 @@ void DHT::initializeApp(int stage)
     secureMaintenance = par("secureMaintenance");
     invalidDataAttack = par("invalidDataAttack");
     maintenanceAttack = par("maintenanceAttack");
+    batchLookups = par("batchLookups");
+
+    batchLookupTimer = new cMessage("batch_lookup_timer");
 
     maintenanceMessages = 0;
     normalMessages = 0;
     numBytesMaintenance = 0;
     numBytesNormal = 0;
+    numBatchLookups = 0;
+    numSavedLookupRpcs = 0;
     WATCH(maintenanceMessages);
     WATCH(normalMessages);
     WATCH(numBytesNormal);
     WATCH(numBytesMaintenance);
+    WATCH(numBatchLookups);
+    WATCH(numSavedLookupRpcs);
     WATCH_MAP(pendingRpcs);
 
     initializeDHT();
@@ -93,6 +103,11 @@ void DHT::initializeDHT()
 
 void DHT::handleTimerEvent(cMessage* msg)
 {
+    if (msg == batchLookupTimer) {
+        sendQueuedLookups();
+        return;
+    }
+
     DHTTtlTimer* msg_timer = dynamic_cast<DHTTtlTimer*> (msg);
 
     if (msg_timer) {
@@ -108,6 +123,27 @@ void DHT::handleTimerEvent(cMessage* msg)
     }
 }
 
+void DHT::restoreData(const OverlayKey& key, uint32_t kind, uint32_t id,
+                      const BinaryValue& value, simtime_t ttl,
+                      bool isModifiable, const NodeHandle& sourceNode,
+                      bool responsible)
+{
+    Enter_Method_Silent();
+
+    // add ttl timer
+    DHTTtlTimer *timerMsg = new DHTTtlTimer("ttl_timer");
+    timerMsg->setKey(key);
+    timerMsg->setKind(kind);
+    timerMsg->setId(id);
+
+    // Only schedule a removal if the TTL > 0
+    if (ttl > 0)
+        scheduleAt(simTime() + ttl, timerMsg);
+
+    dataStorage->addData(key, kind, id, value, timerMsg, isModifiable,
+                         sourceNode, responsible);
+}
+
 bool DHT::handleRpcCall(BaseCallMessage* msg)
 {
     RPC_SWITCH_START(msg)
@@ -151,6 +187,15 @@ void DHT::handleRpcResponse(BaseResponseMessage* msg, cPolymorphic* context,
            << endl;
         break;
     }
+    RPC_ON_RESPONSE(BatchLookup) {
+        EV << "[DHT::handleRpcResponse()]\n"
+           << "    BatchLookup RPC Response received: id=" << rpcId
+           << " msg=" << *_BatchLookupResponse << " rtt=" << rtt
+           << endl;
+        handleBatchLookupResponse(_BatchLookupResponse,
+                                  check_and_cast<BatchLookupContext*>(context));
+        break;
+    }
     RPC_SWITCH_END()
 }
 
@@ -174,7 +219,7 @@ void DHT::handleRpcTimeout(BaseCallMessage* msg, const TransportAddress& dest,
         if (it->second.numFailed / (double)it->second.numSent >= 0.5) {
             DHTputCAPIResponse* capiPutRespMsg = new DHTputCAPIResponse();
             capiPutRespMsg->setIsSuccess(false);
-            sendRpcResponse(it->second.putCallMsg, capiPutRespMsg);
+            sendCapiResponse(it->second.putCallMsg, capiPutRespMsg);
             //cout << "timeout 1" << endl;
             pendingRpcs.erase(rpcId);
         }
@@ -214,7 +259,7 @@ void DHT::handleRpcTimeout(BaseCallMessage* msg, const TransportAddress& dest,
                 // no one else
                 DHTgetCAPIResponse* capiGetRespMsg = new DHTgetCAPIResponse();
                 capiGetRespMsg->setIsSuccess(false);
-                sendRpcResponse(it->second.getCallMsg,
+                sendCapiResponse(it->second.getCallMsg,
                                 capiGetRespMsg);
                 //cout << "DHT: GET failed: timeout (no one else)" << endl;
                 pendingRpcs.erase(rpcId);
@@ -284,7 +329,7 @@ void DHT::handleRpcTimeout(BaseCallMessage* msg, const TransportAddress& dest,
                     // no more nodes to ask -> get failed
                     DHTgetCAPIResponse* capiGetRespMsg = new DHTgetCAPIResponse();
                     capiGetRespMsg->setIsSuccess(false);
-                    sendRpcResponse(it->second.getCallMsg, capiGetRespMsg);
+                    sendCapiResponse(it->second.getCallMsg, capiGetRespMsg);
                     //cout << "DHT: GET failed: timeout2 (no one else)" << endl;
                     pendingRpcs.erase(rpcId);
                 }
@@ -504,10 +549,7 @@ void DHT::handlePutCAPIRequest(DHTputCAPICall* capiPutMsg)
 void DHT::sendPutLookupCall(DHTputCAPICall* capiPutMsg, int rpcId)
 {
     // asks the replica list
-    LookupCall* lookupCall = new LookupCall();
-    lookupCall->setKey(capiPutMsg->getKey());
-    lookupCall->setNumSiblings(numReplica);
-    sendInternalRpcCall(OVERLAY_COMP, lookupCall, NULL, -1, 0, rpcId);
+    sendLookupCall(capiPutMsg->getKey(), rpcId);
 
     PendingRpcsEntry entry;
     entry.putCallMsg = capiPutMsg;
@@ -523,10 +565,7 @@ void DHT::handleGetCAPIRequest(DHTgetCAPICall* capiGetMsg)
 void DHT::sendGetLookupCall(DHTgetCAPICall* capiGetMsg, int rpcId)
 {
     // asks the replica list
-    LookupCall* lookupCall = new LookupCall();
-    lookupCall->setKey(capiGetMsg->getKey());
-    lookupCall->setNumSiblings(numReplica);
-    sendInternalRpcCall(OVERLAY_COMP, lookupCall, NULL, -1, 0, rpcId);
+    sendLookupCall(capiGetMsg->getKey(), rpcId);
 
     PendingRpcsEntry entry;
     entry.getCallMsg = capiGetMsg;
@@ -534,6 +573,105 @@ void DHT::sendGetLookupCall(DHTgetCAPICall* capiGetMsg, int rpcId)
     pendingRpcs.insert(make_pair(rpcId, entry));
 }
 
+void DHT::sendLookupCall(const OverlayKey& key, int rpcId)
+{
+    if (batchLookups) {
+        // requests of the same time (e.g. bulk requests of an
+        // application) share one batch lookup
+        queuedLookups.push_back(make_pair(key, rpcId));
+        if (!batchLookupTimer->isScheduled()) {
+            scheduleAt(simTime(), batchLookupTimer);
+        }
+        return;
+    }
+
+    LookupCall* lookupCall = new LookupCall();
+    lookupCall->setKey(key);
+    lookupCall->setNumSiblings(numReplica);
+    sendInternalRpcCall(OVERLAY_COMP, lookupCall, NULL, -1, 0, rpcId);
+}
+
+void DHT::sendQueuedLookups()
+{
+    if (queuedLookups.size() == 1) {
+        // nothing to coalesce
+        LookupCall* lookupCall = new LookupCall();
+        lookupCall->setKey(queuedLookups[0].first);
+        lookupCall->setNumSiblings(numReplica);
+        sendInternalRpcCall(OVERLAY_COMP, lookupCall, NULL, -1, 0,
+                            queuedLookups[0].second);
+    } else if (queuedLookups.size() > 1) {
+        BatchLookupCall* batchCall = new BatchLookupCall();
+        BatchLookupContext* context = new BatchLookupContext();
+
+        batchCall->setKeysArraySize(queuedLookups.size());
+        batchCall->setNumSiblings(numReplica);
+        for (uint32_t i = 0; i < queuedLookups.size(); i++) {
+            batchCall->setKeys(i, queuedLookups[i].first);
+            context->rpcIds.push_back(queuedLookups[i].second);
+        }
+
+        sendInternalRpcCall(OVERLAY_COMP, batchCall, context);
+    }
+
+    queuedLookups.clear();
+}
+
+void DHT::handleBatchLookupResponse(BatchLookupResponse* batchMsg,
+                                    BatchLookupContext* context)
+{
+    RECORD_STATS(numBatchLookups++;
+                 numSavedLookupRpcs += batchMsg->getSavedRpcs());
+
+    for (uint32_t i = 0; i < batchMsg->getResultsArraySize(); i++) {
+        const LookupResult& result = batchMsg->getResults(i);
+
+        if (context->rpcIds.empty()) {
+            if (result.getIsValid() && (result.getSiblingsArraySize() > 0)) {
+                repairReplicas(context->failedNode, result.getKey(),
+                               result.getSiblings(result.getSiblingsArraySize()
+                                                  - 1));
+            }
+            continue;
+        }
+
+        // hand the result to the pending request like a single lookup
+        LookupResponse lookupMsg;
+        lookupMsg.setKey(result.getKey());
+        lookupMsg.setHopCount(result.getHopCount());
+        lookupMsg.setIsValid(result.getIsValid());
+        lookupMsg.setSiblingsArraySize(result.getSiblingsArraySize());
+        for (uint32_t j = 0; j < result.getSiblingsArraySize(); j++) {
+            lookupMsg.setSiblings(j, result.getSiblings(j));
+        }
+
+        handleLookupResponse(&lookupMsg, context->rpcIds[i]);
+    }
+
+    delete context;
+}
+
+void DHT::repairReplicas(const NodeHandle& failedNode, const OverlayKey& key,
+                         const NodeHandle& lastSibling)
+{
+    // the failed node was no replica, if the last sibling is closer
+    if (lastSibling == overlay->getThisNode() ||
+        overlay->distance(failedNode.getKey(), key) >=
+        overlay->distance(lastSibling.getKey(), key)) {
+        return;
+    }
+
+    DhtDataVector* records = dataStorage->getDataVector(key);
+
+    for (uint32_t i = 0; i < records->size(); i++) {
+        if ((*records)[i].second.responsible) {
+            sendMaintenancePutCall(lastSibling, key, (*records)[i].second);
+        }
+    }
+
+    delete records;
+}
+
 void DHT::handleDumpDhtRequest(DHTdumpCall* call)
 {
     DHTdumpResponse* response = new DHTdumpResponse();
@@ -569,7 +707,7 @@ void DHT::handlePutResponse(DHTPutResponse* dhtMsg, int rpcId)
 
         DHTputCAPIResponse* capiPutRespMsg = new DHTputCAPIResponse();
         capiPutRespMsg->setIsSuccess(true);
-        sendRpcResponse(it->second.putCallMsg, capiPutRespMsg);
+        sendCapiResponse(it->second.putCallMsg, capiPutRespMsg);
         pendingRpcs.erase(rpcId);
     }
 }
@@ -592,7 +730,7 @@ void DHT::handleGetResponse(DHTGetResponse* dhtMsg, int rpcId)
                 capiGetRespMsg->setResult(i, dhtMsg->getResult(i));
             }
             capiGetRespMsg->setIsSuccess(true);
-            sendRpcResponse(it->second.getCallMsg, capiGetRespMsg);
+            sendCapiResponse(it->second.getCallMsg, capiGetRespMsg);
             pendingRpcs.erase(rpcId);
             return;
         }
@@ -661,7 +799,7 @@ void DHT::handleGetResponse(DHTGetResponse* dhtMsg, int rpcId)
                 capiGetRespMsg->setResultArraySize(1);
                 capiGetRespMsg->setResult(0, result);
                 capiGetRespMsg->setIsSuccess(false);
-                sendRpcResponse(it->second.getCallMsg, capiGetRespMsg);
+                sendCapiResponse(it->second.getCallMsg, capiGetRespMsg);
 #if 0
                 cout << "DHT: GET failed: hash (no one else)" << endl;
                 cout << "numResponses: " << it->second.numResponses
@@ -707,7 +845,7 @@ void DHT::handleGetResponse(DHTGetResponse* dhtMsg, int rpcId)
             capiGetRespMsg->setResultArraySize(1);
             capiGetRespMsg->setResult(0, result);
             capiGetRespMsg->setIsSuccess(false);
-            sendRpcResponse(it->second.getCallMsg, capiGetRespMsg);
+            sendCapiResponse(it->second.getCallMsg, capiGetRespMsg);
             //cout << "DHT: GET failed: hash2 (no one else)" << endl;
             pendingRpcs.erase(rpcId);
         }
@@ -727,6 +865,9 @@ void DHT::update(const NodeHandle& node, bool joined)
        << endl;
 
     if (secureMaintenance) {
+        // keys, whose replicas are repaired by one batch lookup
+        std::vector<OverlayKey> repairKeys;
+
         for (it = dataStorage->begin(); it != dataStorage->end(); it++) {
             if (it->second.responsible) {
                 NodeVector* siblings = overlay->local_lookup(it->first,
@@ -758,8 +899,17 @@ void DHT::update(const NodeHandle& node, bool joined)
                     if (overlay->distance(node.getKey(), it->first) <
                         overlay->distance(siblings->back().getKey(), it->first)) {
 
-                        sendMaintenancePutCall(siblings->back(), it->first,
-                                               it->second);
+                        if (!batchLookups) {
+                            sendMaintenancePutCall(siblings->back(), it->first,
+                                                   it->second);
+                        } else {
+                            // the local routing table may not know the new
+                            // replica, so look it up (once per key)
+                            if (repairKeys.empty() ||
+                                (repairKeys.back() != it->first)) {
+                                repairKeys.push_back(it->first);
+                            }
+                        }
                     }
                 }
 
@@ -767,6 +917,20 @@ void DHT::update(const NodeHandle& node, bool joined)
             }
         }
 
+        if (repairKeys.size() > 0) {
+            BatchLookupCall* batchCall = new BatchLookupCall();
+            BatchLookupContext* context = new BatchLookupContext();
+
+            batchCall->setKeysArraySize(repairKeys.size());
+            batchCall->setNumSiblings(numReplica);
+            for (uint32_t i = 0; i < repairKeys.size(); i++) {
+                batchCall->setKeys(i, repairKeys[i]);
+            }
+            context->failedNode = node;
+
+            sendInternalRpcCall(OVERLAY_COMP, batchCall, context);
+        }
+
         return;
     }
 
@@ -858,7 +1022,7 @@ void DHT::handleLookupResponse(LookupResponse* lookupMsg, int rpcId)
             DHTputCAPIResponse* capiPutRespMsg = new DHTputCAPIResponse();
             capiPutRespMsg->setIsSuccess(false);
             //cout << "DHT::lookup failed" << endl;
-            sendRpcResponse(it->second.putCallMsg, capiPutRespMsg);
+            sendCapiResponse(it->second.putCallMsg, capiPutRespMsg);
             pendingRpcs.erase(rpcId);
             return;
         }
@@ -921,7 +1085,7 @@ void DHT::handleLookupResponse(LookupResponse* lookupMsg, int rpcId)
             capiGetRespMsg->setResult(0, result);
             capiGetRespMsg->setIsSuccess(false);
             //cout << "DHT: lookup failed 2" << endl;
-            sendRpcResponse(it->second.getCallMsg, capiGetRespMsg);
+            sendCapiResponse(it->second.getCallMsg, capiGetRespMsg);
             pendingRpcs.erase(rpcId);
             return;
         }
@@ -957,10 +1121,30 @@ void DHT::handleLookupResponse(LookupResponse* lookupMsg, int rpcId)
     }
 }
 
+void DHT::sendCapiResponse(BaseCallMessage* call,
+                           BaseResponseMessage* response)
+{
+    // latency between the application request and the response
+    double latency = SIMTIME_DBL(simTime() - call->getArrivalTime());
+
+    if (dynamic_cast<DHTputCAPICall*>(call)) {
+        RECORD_STATS(putLatencyHistogram.record(latency));
+    } else {
+        RECORD_STATS(getLatencyHistogram.record(latency));
+    }
+
+    sendRpcResponse(call, response);
+}
+
 void DHT::finishApp()
 {
     simtime_t time = globalStatistics->calcMeasuredLifetime(creationTime);
 
+    globalStatistics->mergePercentiles("DHT: PUT Latency (s)",
+                                       putLatencyHistogram);
+    globalStatistics->mergePercentiles("DHT: GET Latency (s)",
+                                       getLatencyHistogram);
+
     if (time >= GlobalStatistics::MIN_MEASURED) {
         globalStatistics->addStdDev("DHT: Sent Maintenance Messages/s",
                                     maintenanceMessages / time);
@@ -970,6 +1154,13 @@ void DHT::finishApp()
                                     numBytesMaintenance / time);
         globalStatistics->addStdDev("DHT: Sent Normal Bytes/s",
                                     numBytesNormal / time);
+
+        if (batchLookups) {
+            globalStatistics->addStdDev("DHT: Sent Batch Lookups/s",
+                                        numBatchLookups / time);
+            globalStatistics->addStdDev("DHT: Saved Lookup RPCs/s",
+                                        numSavedLookupRpcs / time);
+        }
     }
 }
 
@@ -47,6 +47,29 @@ public:
     DHT();
     virtual ~DHT();
 
+    /**
+     * Returns the local data storage (used by GlobalCheckpoint)
+     */
+    DHTDataStorage* getDataStorage() { return dataStorage; };
+
+    /**
+     * Adds a data item restored from a checkpoint to the local
+     * data storage
+     *
+     * @param key the key of the data item
+     * @param kind the kind of the data item
+     * @param id the id of the data item
+     * @param value the value of the data item
+     * @param ttl the remaining time to live, 0 for unlimited
+     * @param isModifiable true, if the data item may be modified
+     * @param sourceNode the node that stored the data item
+     * @param responsible true, if this node is responsible for the key
+     */
+    void restoreData(const OverlayKey& key, uint32_t kind, uint32_t id,
+                     const BinaryValue& value, simtime_t ttl,
+                     bool isModifiable, const NodeHandle& sourceNode,
+                     bool responsible);
+
 protected:
     enum PendingRpcsStates {
         INIT = 0,
@@ -86,6 +109,16 @@ protected:
     friend std::ostream& operator<<(std::ostream& Stream,
                                             const PendingRpcsEntry& entry);
 
+    /**
+     * Context of a BatchLookupCall
+     */
+    class BatchLookupContext : public cPolymorphic
+    {
+    public:
+        std::vector<int> rpcIds; /**< rpcIds of the requests of the keys, empty for replica repair */
+        NodeHandle failedNode; /**< the failed sibling, whose replicas are repaired */
+    };
+
     void initializeApp(int stage);
     virtual void initializeDHT();
     void finishApp();
@@ -108,11 +141,50 @@ protected:
     void handleDumpDhtRequest(DHTdumpCall* call);
     void update(const NodeHandle& node, bool joined);
     void handleLookupResponse(LookupResponse* lookupMsg, int rpcId);
+
+    /**
+     * Looks up the replica list of a put or get request. If batchLookups
+     * is set, the lookup is queued and sent together with the lookups
+     * of the other requests of the same simulation time.
+     *
+     * @param key the key of the request
+     * @param rpcId the rpcId of the pending request
+     */
+    void sendLookupCall(const OverlayKey& key, int rpcId);
+
+    /**
+     * Sends the queued lookups of put and get requests as one batch lookup
+     */
+    void sendQueuedLookups();
+
+    /**
+     * Hands the results of a batch lookup to the pending requests or
+     * to the replica repair
+     */
+    void handleBatchLookupResponse(BatchLookupResponse* batchMsg,
+                                   BatchLookupContext* context);
+
+    /**
+     * Secure maintenance: copies the records of a key to its last
+     * sibling, if this sibling replaces the failed node in the replica set
+     *
+     * @param failedNode the failed sibling
+     * @param key the key of the records
+     * @param lastSibling the last sibling of the key found by a lookup
+     */
+    void repairReplicas(const NodeHandle& failedNode, const OverlayKey& key,
+                        const NodeHandle& lastSibling);
     void sendMaintenancePutCall(const TransportAddress& dest,
                                 const OverlayKey& key,
                                 const DhtDataEntry& entry);
     int resultValuesBitLength(DHTGetResponse* msg);
 
+    /**
+     * Sends the response to a put or get request of the application
+     * and records the latency of the request
+     */
+    void sendCapiResponse(BaseCallMessage* call, BaseResponseMessage* response);
+
     uint numReplica;
     int numGetRequests;
     double ratioIdentical;
@@ -121,9 +193,18 @@ protected:
     double numBytesMaintenance;
     double numBytesNormal;
 
+    LogHistogram putLatencyHistogram; /**< latencies of application put requests */
+    LogHistogram getLatencyHistogram; /**< latencies of application get requests */
+
     bool secureMaintenance; /**< use a secure maintenance algorithm based on majority decisions */
     bool invalidDataAttack; /**< if node is malicious, it tries a invalidData attack */
     bool maintenanceAttack; /**< if node is malicious, it tries a maintenanceData attack */
+    bool batchLookups; /**< coalesce concurrent overlay lookups into batch lookups */
+
+    std::vector<std::pair<OverlayKey, int> > queuedLookups; /**< lookups waiting for the next batch lookup */
+    cMessage* batchLookupTimer; /**< sends the queued lookups */
+    double numBatchLookups; /**< number of sent batch lookups */
+    double numSavedLookupRpcs; /**< FindNode RPCs saved by batch lookups */
 
     typedef std::map<uint32_t, PendingRpcsEntry> PendingRpcs;
     PendingRpcs pendingRpcs; /**< a map of all pending RPC operations */
@@ -64,6 +64,30 @@ void DHTDataStorage::handleMessage(cMessage* msg)
     error("This module doesn't handle messages!");
 }
 
+void DHTDataStorage::reportMemory(MemoryReport& report)
+{
+    // large values are shared between copies, but accounted to every
+    // item; ttl messages are accounted to the future event set
+    double bytes = 0;
+    for (DhtDataMap::const_iterator it = dataMap.begin();
+            it != dataMap.end(); ++it) {
+        bytes += MemoryReport::treeNodeBytes(sizeof(OverlayKey) +
+                                             sizeof(DhtDataEntry));
+        if (it->second.value.size() > BinaryValue::INLINE_SIZE) {
+            bytes += it->second.value.size();
+        }
+        for (SiblingVoteMap::const_iterator vote =
+                it->second.siblingVote.begin();
+                vote != it->second.siblingVote.end(); ++vote) {
+            bytes += MemoryReport::treeNodeBytes(sizeof(BinaryValue) +
+                                                 sizeof(NodeVector)) +
+                     vote->second.capacity() * sizeof(NodeHandle);
+        }
+    }
+
+    report.add("DHTDataStorage: data items", dataMap.size(), bytes);
+}
+
 void DHTDataStorage::clear()
 {
     map<OverlayKey, DhtDataEntry>::iterator iter;
@@ -35,6 +35,7 @@
 #include <InitStages.h>
 #include <BinaryValue.h>
 #include <NodeVector.h>
+#include <MemoryReport.h>
 #include <CommonMessages_m.h>
 
 /**
@@ -65,7 +66,7 @@ typedef std::vector<std::pair<OverlayKey, DhtDataEntry> > DhtDataVector;
 typedef std::vector<DhtDumpEntry> DhtDumpVector;
 typedef std::multimap<OverlayKey, DhtDataEntry> DhtDataMap;
 
-class DHTDataStorage : public cSimpleModule
+class DHTDataStorage : public cSimpleModule, public MemoryReporter
 {
   public:
 
@@ -88,6 +89,13 @@ class DHTDataStorage : public cSimpleModule
      */
     virtual void clear();
 
+    /**
+     * Reports the stored data items
+     *
+     * @param report the memory report
+     */
+    virtual void reportMemory(MemoryReport& report);
+
     /**
      * Returns a pointer to the requested stored data item
      *
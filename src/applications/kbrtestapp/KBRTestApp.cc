@@ -69,6 +69,11 @@ void KBRTestApp::initializeApp(int stage)
     msgHandleBufSize = par("msgHandleBufSize");
     onlyLookupInoffensiveNodes = par("onlyLookupInoffensiveNodes");
 
+    keyPoolSize = par("keyPoolSize");
+    workload.initialize(par("keySkew"), par("keyDriftInterval"), 1,
+                        par("workloadTrace").stdstringValue());
+    useWorkload = (workload.hasTrace() || ((double)par("keySkew") > 0));
+
     numSent = 0;
     bytesSent = 0;
     numDelivered = 0;
@@ -259,6 +264,8 @@ void KBRTestApp::handleRpcResponse(BaseResponseMessage* msg,
                              bytesRpcDelivered += msg->getByteLength());
                 RECORD_STATS(globalStatistics->recordOutVector(
                         "KBRTestApp: RPC Success Latency", SIMTIME_DBL(rtt)));
+                RECORD_STATS(globalStatistics->recordPercentiles(
+                        "KBRTestApp: RPC Success Latency", SIMTIME_DBL(rtt)));
                 RECORD_STATS(globalStatistics->recordOutVector(
                         "KBRTestApp: RPC Total Latency", SIMTIME_DBL(rtt)));
                 RECORD_STATS(rpcSuccLatencyCount++;
@@ -345,6 +352,8 @@ void KBRTestApp::handleLookupResponse(LookupResponse* msg,
             RECORD_STATS(numLookupSuccess++);
             RECORD_STATS(globalStatistics->recordOutVector(
                    "KBRTestApp: Lookup Success Latency", SIMTIME_DBL(latency)));
+            RECORD_STATS(globalStatistics->recordPercentiles(
+                   "KBRTestApp: Lookup Success Latency", SIMTIME_DBL(latency)));
             RECORD_STATS(globalStatistics->recordOutVector(
                    "KBRTestApp: Lookup Total Latency", SIMTIME_DBL(latency)));
             RECORD_STATS(globalStatistics->recordOutVector(
@@ -451,6 +460,12 @@ std::pair<OverlayKey, TransportAddress> KBRTestApp::createDestKey()
                                                    onlyLookupInoffensiveNodes);
         return std::make_pair(handle.getKey(), handle);
     }
+    if (useWorkload) {
+        uint32_t keyId;
+        workload.nextRequest(keyPoolSize, keyId);
+        return std::make_pair(WorkloadGenerator::getKeyForId(keyId),
+                              TransportAddress::UNSPECIFIED_NODE);
+    }
     // generate random destination key
     return std::make_pair(OverlayKey::random(), TransportAddress::UNSPECIFIED_NODE);
 }
@@ -493,6 +508,8 @@ void KBRTestApp::evaluateData(simtime_t latency, int hopCount, long int bytes)
                                                    "Count", hopCount));
     RECORD_STATS(globalStatistics->recordOutVector("KBRTestApp: One-way Latency",
                                                    SIMTIME_DBL(latency)));
+    RECORD_STATS(globalStatistics->recordPercentiles("KBRTestApp: One-way Latency",
+                                                     SIMTIME_DBL(latency)));
 }
 
 void KBRTestApp::finishApp()
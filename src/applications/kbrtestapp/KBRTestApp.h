@@ -29,6 +29,7 @@
 #include <OverlayKey.h>
 
 #include "BaseApp.h"
+#include <WorkloadGenerator.h>
 
 class KBRTestMessage;
 class KbrTestCall;
@@ -136,6 +137,9 @@ private:
     bool lookupNodeIds;  //!< lookup only existing nodeIDs
     bool nodeIsLeavingSoon; //!< true if the node is going to be killed shortly
     bool onlyLookupInoffensiveNodes; //!< if true only search for inoffensive nodes (use together with lookupNodeIds)
+    uint32_t keyPoolSize; //!< number of destination keys for skewed workloads
+    bool useWorkload; //!< destination keys are chosen by the workload generator
+    WorkloadGenerator workload; //!< key popularity and request trace
 
     uint32_t numSent;
     uint32_t bytesSent;
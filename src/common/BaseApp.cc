@@ -33,6 +33,7 @@
 #include <GlobalNodeListAccess.h>
 #include <GlobalStatisticsAccess.h>
 #include <UnderlayConfiguratorAccess.h>
+#include <EventProfiler.h>
 
 #include "BaseApp.h"
 
@@ -136,6 +137,8 @@ void BaseApp::initializeApp(int stage)
 // Process messages passed up from the overlay.
 void BaseApp::handleMessage(cMessage* msg)
 {
+    EventProfilerScope profile(this, "handleMessage", msg);
+
     if (internalHandleMessage(msg)) {
         return;
     }
@@ -459,6 +462,8 @@ void BaseApp::sendReadyMessage(bool ready)
 
 void BaseApp::finish()
 {
+    finishRpcStatistics();
+
     // record scalar data
     simtime_t time = globalStatistics->calcMeasuredLifetime(creationTime);
 
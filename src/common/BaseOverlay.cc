@@ -38,10 +38,14 @@
 #include <UnderlayConfiguratorAccess.h>
 #include <GlobalStatisticsAccess.h>
 #include <GlobalParametersAccess.h>
+#include <GlobalCheckpointAccess.h>
+#include <EventProfiler.h>
+#include <MessageDispatch.h>
 
 #include <LookupListener.h>
 #include <RecursiveLookup.h>
 #include <IterativeLookup.h>
+#include <BatchLookup.h>
 
 #include <BootstrapList.h>
 
@@ -135,6 +139,7 @@ void BaseOverlay::initialize(int stage)
         routeMsgAcks = par("routeMsgAcks");
         recNumRedundantNodes = par("recNumRedundantNodes");
         recordRoute = par("recordRoute");
+        visitedHopsFilter = par("visitedHopsFilter");
 
         // set base lookup parameters
         iterativeLookupConfig.redundantNodes = par("lookupRedundantNodes");
@@ -158,6 +163,11 @@ void BaseOverlay::initialize(int stage)
             par("lookupVisitOnlyOnce");
         iterativeLookupConfig.acceptLateSiblings =
             par("lookupAcceptLateSiblings");
+        iterativeLookupConfig.hedgedRpcs = par("lookupHedgedRpcs");
+        iterativeLookupConfig.hedgeDelay = par("lookupHedgeDelay");
+
+        lookupCache.initialize(par("lookupCacheSize"),
+                               par("lookupCacheTTL"));
 
         recursiveLookupConfig.redundantNodes = par("lookupRedundantNodes");
         recursiveLookupConfig.numRetries = 0; //TODO
@@ -187,6 +197,8 @@ void BaseOverlay::initialize(int stage)
         bytesDropped = 0;
         numFindNodeSent = 0;
         bytesFindNodeSent = 0;
+        numHedgedRpcs = 0;
+        numHedgeWins = 0;
         numFindNodeResponseSent = 0;
         bytesFindNodeResponseSent = 0;
         numFailedNodeSent = 0;
@@ -306,6 +318,14 @@ void BaseOverlay::finish()
 {
     finishOverlay();
 
+    finishRpcStatistics();
+    globalStatistics->mergePercentiles("IterativeLookup: Lookup Duration (s)",
+                                       lookupDurationHistogram);
+    globalStatistics->mergePercentiles("IterativeLookup: Lookup Hop Count",
+                                       lookupHopHistogram);
+    globalStatistics->mergePercentiles("IterativeLookup: Hedge Time Saved (s)",
+                                       hedgeSavedHistogram);
+
     simtime_t time = globalStatistics->calcMeasuredLifetime(creationTime);
 
     if (time >= GlobalStatistics::MIN_MEASURED) {
@@ -333,6 +353,24 @@ void BaseOverlay::finish()
 
         globalStatistics->addStdDev("BaseOverlay: Join Retries", joinRetries);
 
+        if (lookupCache.isEnabled()) {
+            uint32_t cacheLookups = lookupCache.getNumHits() +
+                lookupCache.getNumMisses();
+            globalStatistics->addStdDev("BaseOverlay: Lookup Cache Hits/s",
+                                        lookupCache.getNumHits() / time);
+            globalStatistics->addStdDev("BaseOverlay: Lookup Cache Misses/s",
+                                        lookupCache.getNumMisses() / time);
+            globalStatistics->addStdDev("BaseOverlay: Lookup Cache Stale/s",
+                                        lookupCache.getNumStale() / time);
+            globalStatistics->addStdDev("BaseOverlay: Lookup Cache Invalidated/s",
+                                        lookupCache.getNumInvalidated() / time);
+            if (cacheLookups > 0) {
+                globalStatistics->addStdDev("BaseOverlay: Lookup Cache Hit Ratio",
+                                            (double)lookupCache.getNumHits() /
+                                            cacheLookups);
+            }
+        }
+
         globalStatistics->addStdDev("BaseOverlay: Sent App Data Messages/s",
                                     numAppDataSent / time);
         globalStatistics->addStdDev("BaseOverlay: Sent App Data Bytes/s",
@@ -362,6 +400,15 @@ void BaseOverlay::finish()
                                     numFindNodeSent / time);
         globalStatistics->addStdDev("BaseOverlay: Sent FindNode Bytes/s",
                                     bytesFindNodeSent / time);
+        if (iterativeLookupConfig.hedgedRpcs) {
+            globalStatistics->addStdDev("IterativeLookup: Hedged FindNode "
+                                        "Messages/s", numHedgedRpcs / time);
+            if (numHedgedRpcs > 0) {
+                globalStatistics->addStdDev("IterativeLookup: Hedge Win Ratio",
+                                            (double)numHedgeWins /
+                                            numHedgedRpcs);
+            }
+        }
 
         globalStatistics->addStdDev("BaseOverlay: Sent FindNodeResponse Messages/s",
                                     numFindNodeResponseSent / time);
@@ -598,10 +645,17 @@ void BaseOverlay::join(const OverlayKey& nodeID)
             thisNode.setKey(nodeID);
         } else if (thisNode.getKey().isUnspecified()) {
             std::string nodeIdStr = par("nodeId").stdstringValue();
+            GlobalCheckpoint* globalCheckpoint = GlobalCheckpointAccess().get();
+            OverlayKey restoredKey;
 
             if (nodeIdStr.size()) {
                 // manual configuration of nodeId in ini file
                 thisNode.setKey(OverlayKey(nodeIdStr));
+            } else if (globalCheckpoint &&
+                       globalCheckpoint->restoreKey(thisNode.getIp(),
+                                                    restoredKey)) {
+                // nodeId of a node restored from a checkpoint
+                thisNode.setKey(restoredKey);
             } else {
                 setOwnNodeID();
             }
@@ -616,9 +670,40 @@ void BaseOverlay::join(const OverlayKey& nodeID)
         }
     }
 
+    if (globalNodeList->deferJoin(this)) {
+        return;
+    }
+
     joinOverlay();
 }
 
+void BaseOverlay::reportMemory(MemoryReport& report)
+{
+    BaseRpc::reportMemory(report);
+
+    // the state of the lookups is dominated by their candidate lists,
+    // which aren't accounted here
+    report.add("BaseOverlay: lookups", lookups.size() + batchLookups.size(),
+               lookups.size() *
+               MemoryReport::hashNodeBytes(sizeof(IterativeLookup)) +
+               batchLookups.size() *
+               MemoryReport::treeNodeBytes(sizeof(BatchLookup)));
+}
+
+void BaseOverlay::joinWarmStart(const OracleRing& ring, size_t pos)
+{
+    Enter_Method_Silent();
+
+    if (!installOracleState(ring, pos)) {
+        joinOverlay();
+    }
+}
+
+bool BaseOverlay::installOracleState(const OracleRing& ring, size_t pos)
+{
+    return false;
+}
+
 void BaseOverlay::joinForeignPartition(const NodeHandle& node)
 {
     throw cRuntimeError("BaseOverlay::joinForeignPartition(): "
@@ -651,6 +736,9 @@ void BaseOverlay::callUpdate(const NodeHandle& node, bool joined)
                << "    (" << node << ", " << joined << ") left"
                << endl;
         }
+
+        // joins change the responsibility in our own neighborhood
+        lookupCache.removeNode(joined ? thisNode : node);
     }
 
     KBRupdate* updateMsg = new KBRupdate("UPDATE");
@@ -699,6 +787,16 @@ int BaseOverlay::getMaxNumRedundantNodes()
 //private
 void BaseOverlay::handleMessage(cMessage* msg)
 {
+    EventProfilerScope profile(this, "handleMessage", msg);
+
+    // cases of the dispatch table (see MessageDispatchTable)
+    enum {
+        HEDGE_TIMER_CASE, COMMON_API_CASE, KBR_ROUTE_CASE, KBR_FORWARD_CASE,
+        COMP_READY_CASE
+    };
+    static MessageDispatchTable dispatchTable;
+    MessageDispatchTable::Entry& msgTypes = dispatchTable.getEntry(msg);
+
     if (msg->getArrivalGate() == udpGate) {
         UDPControlInfo* udpControlInfo =
             check_and_cast<UDPControlInfo*>(msg->removeControlInfo());
@@ -756,12 +854,23 @@ void BaseOverlay::handleMessage(cMessage* msg)
         }
     }
 
+    // process hedge timers of iterative lookups
+    else if (msg->isSelfMessage() &&
+             dispatchCast<IterativeLookupHedgeTimer>(msgTypes,
+                                                     HEDGE_TIMER_CASE,
+                                                     msg) != NULL) {
+        IterativeLookupHedgeTimer* timer =
+            static_cast<IterativeLookupHedgeTimer*>(msg);
+        timer->lookup->handleHedgeTimer(timer);
+    }
+
     // process timer events and rpc timeouts
     else if (internalHandleMessage(msg)) return;
 
     // process CommonAPIMessages from App
-    else if (dynamic_cast<CommonAPIMessage*>(msg) != NULL) {
-        if (dynamic_cast<KBRroute*>(msg) != NULL) {
+    else if (dispatchCast<CommonAPIMessage>(msgTypes, COMMON_API_CASE,
+                                            msg) != NULL) {
+        if (dispatchCast<KBRroute>(msgTypes, KBR_ROUTE_CASE, msg) != NULL) {
             KBRroute* apiMsg = static_cast<KBRroute*>(msg);
 
             std::vector<TransportAddress> sourceRoute;
@@ -771,7 +880,8 @@ void BaseOverlay::handleMessage(cMessage* msg)
             route(apiMsg->getDestKey(), static_cast<CompType>(apiMsg->getDestComp()),
                   static_cast<CompType>(apiMsg->getSrcComp()), apiMsg->decapsulate(),
                           sourceRoute);
-        } else if (dynamic_cast<KBRforward*>(msg) != NULL) {
+        } else if (dispatchCast<KBRforward>(msgTypes, KBR_FORWARD_CASE,
+                                            msg) != NULL) {
             KBRforward* apiMsg = static_cast<KBRforward*>(msg);
             OverlayCtrlInfo* overlayCtrlInfo =
                 check_and_cast<OverlayCtrlInfo*>
@@ -815,7 +925,8 @@ void BaseOverlay::handleMessage(cMessage* msg)
         handleAppMessage(msg);
     } else if(msg->arrivedOn("tcpIn")) {
         handleTCPMessage(msg);
-    } else if (dynamic_cast<CompReadyMessage*>(msg)) {
+    } else if (dispatchCast<CompReadyMessage>(msgTypes, COMP_READY_CASE,
+                                              msg) != NULL) {
         CompReadyMessage* readyMsg = static_cast<CompReadyMessage*>(msg);
         if (((bool)par("joinOnApplicationRequest") == false) &&
             readyMsg->getReady() &&
@@ -907,6 +1018,10 @@ void BaseOverlay::handleBaseOverlayMessage(BaseOverlayMessage* msg,
             }
         }
 
+        if (visitedHopsFilter) {
+            addVisitedHop(baseRouteMsg, overlayCtrlInfo->getLastHop());
+        }
+
         overlayCtrlInfo->setSrcNode(baseRouteMsg->getSrcNode());
 
         // decapsulate msg if node is sibling for destKey
@@ -1083,6 +1198,7 @@ void BaseOverlay::setOverlayReady(bool ready)
         bootstrapList->registerBootstrapNode(thisNode);
     } else {
         bootstrapList->removeBootstrapNode(thisNode);
+        lookupCache.clear();
     }
 
     if (globalParameters->getPrintStateToStdOut()) {
@@ -1209,6 +1325,11 @@ void BaseOverlay::initLookups()
 
 void BaseOverlay::finishLookups()
 {
+    // batch lookups abort their single lookups themselves
+    while (batchLookups.size() > 0) {
+        (*batchLookups.begin())->abortLookup();
+    }
+
     while (lookups.size() > 0) {
         (*lookups.begin())->abortLookup();
     }
@@ -1221,10 +1342,13 @@ private:
     BaseOverlay* overlay;
     BaseOverlayMessage* msg;
     GlobalStatistics* globalStatistics;
+    int numSiblings;
 public:
-    SendToKeyListener( BaseOverlay* overlay, BaseOverlayMessage* msg ) {
+    SendToKeyListener( BaseOverlay* overlay, BaseOverlayMessage* msg,
+                       int numSiblings = 1 ) {
         this->overlay = overlay;
         this->msg = msg;
+        this->numSiblings = numSiblings;
         globalStatistics = overlay->globalStatistics;
         pendingLookups++;
     }
@@ -1242,6 +1366,10 @@ public:
         if (dynamic_cast<BaseRouteMessage*>(msg)) {
             BaseRouteMessage* routeMsg = static_cast<BaseRouteMessage*>(msg);
             if (lookup->isValid()) {
+                if (routeMsg->getStatType() == APP_DATA_STAT) {
+                    overlay->lookupCache.put(routeMsg->getDestKey(),
+                                             numSiblings, lookup->getResult());
+                }
                 if (lookup->getResult().size()==0) {
                     EV << "[SendToKeyListener::lookupFinished()]\n"
                           "    [ERROR] SendToKeyListener: Valid result, "
@@ -1275,6 +1403,8 @@ public:
             response->setKey(call->getKey());
             response->setHopCount(overlay->isCountAccumulatedHops() ? lookup->getAccumulatedHops() : lookup->getMinHops());
             if (lookup->isValid()) {
+                overlay->lookupCache.put(call->getKey(), numSiblings,
+                                         lookup->getResult());
                 response->setIsValid(true);
                 response->setSiblingsArraySize(lookup->getResult().size());
                 for (uint32_t i=0; i<lookup->getResult().size(); i++) {
@@ -1435,11 +1565,28 @@ void BaseOverlay::sendToKey(const OverlayKey& key, BaseOverlayMessage* msg,
         || (routingType == EXHAUSTIVE_ITERATIVE_ROUTING)
         ) {
 
+        std::vector<NodeHandle> cachedSiblings;
+
+        // application data is sent to cached siblings directly
+        if (lookupCache.isEnabled() &&
+            (routeMsg->getStatType() == APP_DATA_STAT) &&
+            lookupCache.get(routeMsg->getDestKey(), numSiblings,
+                            cachedSiblings)) {
+            for (uint32_t i = 0; i < cachedSiblings.size(); i++) {
+                sendRouteMessage(cachedSiblings[i],
+                                 static_cast<BaseRouteMessage*>
+                                     (routeMsg->dup()),
+                                 routeMsgAcks);
+            }
+            delete routeMsg;
+            return;
+        }
+
         // create lookup and sent to key
         AbstractLookup* lookup = createLookup(routingType, routeMsg, NULL,
                                     (routeMsg->getStatType() == APP_DATA_STAT));
         lookup->lookup(routeMsg->getDestKey(), numSiblings, hopCountMax,
-                       0, new SendToKeyListener(this, routeMsg));
+                       0, new SendToKeyListener(this, routeMsg, numSiblings));
     } else  {
         // recursive routing
         NodeVector* nextHops = findNode(routeMsg->getDestKey(),
@@ -1498,19 +1645,13 @@ void BaseOverlay::sendToKey(const OverlayKey& key, BaseOverlayMessage* msg,
             isSibling = isSiblingFor(thisNode, routeMsg->getDestKey(),
                                      numSiblings, &err);
 
-            // if route is recorded we can do a real loop detection
-            std::set<TransportAddress> visitedHops;
-            for (uint32_t i = 0; i < routeMsg->getVisitedHopsArraySize(); ++i) {
-                visitedHops.insert(routeMsg->getVisitedHops(i));
-            }
-
             for (uint32_t index = 0; nextHop == NULL && nextHops->size() > index;
                  ++index) {
                 nextHop = &((*nextHops)[index]);
                 // loop detection
                 if (((overlayCtrlInfo->getLastHop() == *nextHop) &&
                      (*nextHop != thisNode)) ||
-                     (visitedHops.find(*nextHop) != visitedHops.end()) ||
+                     isVisitedHop(routeMsg, *nextHop) ||
                      // do not forward msg to source node
                     ((*nextHop == routeMsg->getSrcNode()) &&
                      (thisNode != routeMsg->getSrcNode())) ||
@@ -1596,6 +1737,72 @@ bool BaseOverlay::checkFindNode(BaseRouteMessage* routeMsg)
     return false;
 }
 
+static const uint32_t VISITED_FILTER_WORDS = 4;
+static const uint32_t VISITED_FILTER_BITS = VISITED_FILTER_WORDS * 32;
+static const int VISITED_FILTER_HASHES = 3;
+
+// spreads the ip/port hash of a TransportAddress over all 32 bits
+static inline uint32_t visitedHopHash(const TransportAddress& hop)
+{
+    uint32_t h = (uint32_t)hop.hash();
+    h ^= h >> 16;
+    h *= 0x85ebca6bU;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35U;
+    h ^= h >> 16;
+    return h;
+}
+
+void BaseOverlay::addVisitedHop(BaseRouteMessage* msg,
+                                const TransportAddress& hop)
+{
+    if (hop.isUnspecified()) {
+        return;
+    }
+
+    if (msg->getVisitedHopsFilterArraySize() != VISITED_FILTER_WORDS) {
+        msg->setVisitedHopsFilterArraySize(VISITED_FILTER_WORDS);
+        for (uint32_t i = 0; i < VISITED_FILTER_WORDS; i++) {
+            msg->setVisitedHopsFilter(i, 0);
+        }
+    }
+
+    uint32_t h = visitedHopHash(hop);
+    for (int i = 0; i < VISITED_FILTER_HASHES; i++, h >>= 7) {
+        uint32_t bit = h % VISITED_FILTER_BITS;
+        msg->setVisitedHopsFilter(bit / 32, msg->getVisitedHopsFilter(bit / 32)
+                                  | (1U << (bit % 32)));
+    }
+}
+
+bool BaseOverlay::isVisitedHop(const BaseRouteMessage* msg,
+                               const TransportAddress& hop) const
+{
+    if (msg->getVisitedHopsFilterArraySize() == VISITED_FILTER_WORDS) {
+        uint32_t h = visitedHopHash(hop);
+        for (int i = 0; i < VISITED_FILTER_HASHES; i++, h >>= 7) {
+            uint32_t bit = h % VISITED_FILTER_BITS;
+            if (!(msg->getVisitedHopsFilter(bit / 32) & (1U << (bit % 32)))) {
+                return false;
+            }
+        }
+
+        // no recorded route to rule out a false positive
+        if (msg->getVisitedHopsArraySize() == 0) {
+            return true;
+        }
+    }
+
+    // if route is recorded we can do a real loop detection
+    for (uint32_t i = 0; i < msg->getVisitedHopsArraySize(); ++i) {
+        if (msg->getVisitedHops(i) == hop) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 //protected: create a lookup class
 AbstractLookup* BaseOverlay::createLookup(RoutingType routingType,
                                           const BaseOverlayMessage* msg,
@@ -1637,6 +1844,25 @@ void BaseOverlay::removeLookup(AbstractLookup* lookup)
     lookups.erase(lookup);
 }
 
+BatchLookup* BaseOverlay::createBatchLookup(RoutingType routingType,
+                                            bool appLookup)
+{
+    if (routingType == DEFAULT_ROUTING) {
+        routingType = defaultRoutingType;
+    }
+
+    BatchLookup* batch = new BatchLookup(this, routingType,
+                                         iterativeLookupConfig, appLookup);
+    batchLookups.insert(batch);
+
+    return batch;
+}
+
+void BaseOverlay::removeBatchLookup(BatchLookup* batch)
+{
+    batchLookups.erase(batch);
+}
+
 //virtual public
 OverlayKey BaseOverlay::distance(const OverlayKey& x,
                                  const OverlayKey& y,
@@ -1678,8 +1904,10 @@ bool BaseOverlay::internalHandleRpcCall(BaseCallMessage* msg)
     // call rpc stubs
     RPC_SWITCH_START( msg );
     RPC_DELEGATE( FindNode, findNodeRpc );
+    RPC_DELEGATE( MultiFindNode, multiFindNodeRpc );
     RPC_DELEGATE( FailedNode, failedNodeRpc );
     RPC_DELEGATE( Lookup, lookupRpc );
+    RPC_DELEGATE( BatchLookup, batchLookupRpc );
     RPC_DELEGATE( NextHop, nextHopRpc );
     RPC_SWITCH_END( );
 
@@ -1718,6 +1946,7 @@ void BaseOverlay::internalHandleRpcTimeout(BaseCallMessage* msg,
             // remove node from local routing tables
             // + route message again if possible
             assert(!dest.isUnspecified() && destKey.isUnspecified());
+            lookupCache.removeNode(dest);
             if (handleFailedNode(dest)) {
                 if (!tempMsg->getDestKey().isUnspecified()) {
                     // TODO: msg is resent only in recursive mode
@@ -1831,6 +2060,12 @@ void BaseOverlay::countFindNodeCall( const FindNodeCall* call )
                  bytesFindNodeSent += call->getByteLength());
 }
 
+void BaseOverlay::countMultiFindNodeCall( const MultiFindNodeCall* call )
+{
+    RECORD_STATS(numFindNodeSent++;
+                 bytesFindNodeSent += call->getByteLength());
+}
+
 void BaseOverlay::countFailedNodeCall( const FailedNodeCall* call )
 {
     RECORD_STATS(numFailedNodeSent++;
@@ -1914,11 +2149,63 @@ void BaseOverlay::findNodeRpc( FindNodeCall* call )
     sendRpcResponse(call, findNodeResponse);
 }
 
+void BaseOverlay::multiFindNodeRpc( MultiFindNodeCall* call )
+{
+    // if this node is malicious don't answer a findNodeCall
+    if (isMalicious() && dropFindNodeAttack) {
+        EV << "[BaseOverlay::multiFindNodeRpc() @ " << thisNode.getIp()
+           << " (" << thisNode.getKey().toString(16) << ")]\n"
+           << "    Node ignores multiFindNodeCall because this node is malicious"
+           << endl;
+        delete call;
+        return;
+    }
+
+    MultiFindNodeResponse* multiFindNodeResponse =
+        new MultiFindNodeResponse("MultiFindNodeResponse");
+
+    int numSiblings = call->getExhaustiveIterative() ? -1 :
+                                                       call->getNumSiblings();
+    uint32_t resultsLength = 0;
+
+    multiFindNodeResponse->setResultsArraySize(call->getLookupKeysArraySize());
+    for (uint32_t i = 0; i < call->getLookupKeysArraySize(); i++) {
+        const OverlayKey& key = call->getLookupKeys(i);
+        FindNodeResult& result = multiFindNodeResponse->getResults(i);
+
+        // findNode() extensions are never merged into MultiFindNodeCalls
+        NodeVector* nextHops = findNode(key, call->getNumRedundantNodes(),
+                                        numSiblings, NULL);
+
+        result.setLookupKey(key);
+        result.setClosestNodesArraySize(nextHops->size());
+        for (uint32_t j = 0; j < nextHops->size(); j++) {
+            result.setClosestNodes(j, (*nextHops)[j]);
+        }
+
+        bool err;
+        result.setSiblings(!call->getExhaustiveIterative() &&
+                           isSiblingFor(thisNode, key,
+                                        call->getNumSiblings(), &err));
+
+        resultsLength += FINDNODERESULT_L(result);
+        delete nextHops;
+    }
+
+    multiFindNodeResponse->setBitLength(
+            MULTIFINDNODERESPONSE_L(multiFindNodeResponse) + resultsLength);
+
+    RECORD_STATS(numFindNodeResponseSent++; bytesFindNodeResponseSent +=
+        multiFindNodeResponse->getByteLength());
+
+    sendRpcResponse(call, multiFindNodeResponse);
+}
 
 void BaseOverlay::failedNodeRpc( FailedNodeCall* call )
 {
     FailedNodeResponse* failedNodeResponse =
         new FailedNodeResponse("FailedNodeResponse");
+    lookupCache.removeNode(call->getFailedNode());
     failedNodeResponse->setTryAgain(handleFailedNode(call->getFailedNode()));
     failedNodeResponse->setBitLength(FAILEDNODERESPONSE_L(failedNodeResponse));
 
@@ -1961,11 +2248,105 @@ void BaseOverlay::lookupRpc(LookupCall* call)
         return;
     }
 
+    std::vector<NodeHandle> cachedSiblings;
+
+    if (lookupCache.isEnabled() &&
+        lookupCache.get(call->getKey(), numSiblings, cachedSiblings)) {
+        LookupResponse* response = new LookupResponse();
+        response->setKey(call->getKey());
+        response->setHopCount(0);
+        response->setIsValid(true);
+        response->setSiblingsArraySize(cachedSiblings.size());
+        for (uint32_t i = 0; i < cachedSiblings.size(); i++) {
+            response->setSiblings(i, cachedSiblings[i]);
+        }
+
+        sendRpcResponse(call, response);
+
+        return;
+    }
+
     // create lookup and sent to key
     AbstractLookup* lookup = createLookup(static_cast<RoutingType>(
             call->getRoutingType()), call, NULL, true);
     lookup->lookup(call->getKey(), numSiblings, hopCountMax,
-                   1, new SendToKeyListener( this, call ));
+                   1, new SendToKeyListener( this, call, numSiblings ));
+}
+
+class BatchLookupRpcListener : public BatchLookupListener
+{
+private:
+    BaseOverlay* overlay;
+    BatchLookupCall* call;
+public:
+    BatchLookupRpcListener(BaseOverlay* overlay, BatchLookupCall* call) :
+        overlay(overlay), call(call) {};
+
+    ~BatchLookupRpcListener() {
+        delete call;
+    }
+
+    virtual void batchLookupFinished(BatchLookup* batch) {
+        BatchLookupResponse* response = new BatchLookupResponse();
+        response->setResultsArraySize(batch->getNumKeys());
+        for (uint32_t i = 0; i < batch->getNumKeys(); i++) {
+            LookupResult& result = response->getResults(i);
+            result.setKey(batch->getKey(i));
+            result.setHopCount(batch->getHops(i));
+            result.setIsValid(batch->isValid(i));
+            result.setSiblingsArraySize(batch->getResult(i).size());
+            for (uint32_t j = 0; j < batch->getResult(i).size(); j++) {
+                result.setSiblings(j, batch->getResult(i)[j]);
+            }
+        }
+        response->setSavedRpcs(batch->getNumRpcsRequested() -
+                               batch->getNumRpcsSent());
+
+        overlay->sendRpcResponse(call, response);
+        call = NULL;
+        delete this;
+    }
+};
+
+void BaseOverlay::batchLookupRpc(BatchLookupCall* call)
+{
+    int numSiblings = call->getNumSiblings();
+
+    if (numSiblings < 0) {
+        numSiblings = getMaxNumSiblings();
+    }
+
+    if (internalReadyState == false) {
+        // overlay not ready => lookup failed
+        EV << "[BaseOverlay::batchLookupRpc() @ "
+           << getThisNode().getIp()
+           << " (" << getThisNode().getKey().toString(16) << ")]\n"
+           << "    BatchLookupCall "
+           << call->getNonce()
+           << " failed, because overlay module is not ready!" << endl;
+
+        BatchLookupResponse* response = new BatchLookupResponse();
+        response->setResultsArraySize(call->getKeysArraySize());
+        for (uint32_t i = 0; i < call->getKeysArraySize(); i++) {
+            response->getResults(i).setKey(call->getKeys(i));
+            response->getResults(i).setIsValid(false);
+        }
+
+        sendRpcResponse(call, response);
+
+        return;
+    }
+
+    std::vector<OverlayKey> keys(call->getKeysArraySize());
+    for (uint32_t i = 0; i < call->getKeysArraySize(); i++) {
+        keys[i] = call->getKeys(i);
+    }
+
+    // create batch lookup and look up all keys
+    BatchLookup* batch = createBatchLookup(static_cast<RoutingType>(
+            call->getRoutingType()), true);
+    batch->lookup(keys, numSiblings, hopCountMax, 1,
+                  new BatchLookupRpcListener(this, call));
 }
 
 void BaseOverlay::nextHopRpc(NextHopCall* call)
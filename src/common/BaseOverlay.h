@@ -35,6 +35,7 @@
 #include <BaseTcpSupport.h>
 #include <IterativeLookupConfiguration.h>
 #include <RecursiveLookup.h>
+#include <LookupCache.h>
 #include <InitStages.h>
 #include <BroadcastInfo.h>
 
@@ -45,7 +46,9 @@ class NodeHandle;
 class OverlayKey;
 class NotificationBoard;
 class AbstractLookup;
+class BatchLookup;
 class BootstrapList;
+class OracleRing;
 
 /**
  * Base class for overlays
@@ -71,6 +74,8 @@ class BaseOverlay : public INotifiable,
     friend class RecursiveLookup;
     friend class BootstrapList;
     friend class SendToKeyListener;
+    friend class BatchLookup;
+    friend class BatchLookupRpcListener;
 
     //------------------------------------------------------------------------
     //--- Construction / Destruction -----------------------------------------
@@ -197,6 +202,7 @@ protected://fields: overlay attributes
     bool routeMsgAcks;          /**< send ACK when receiving route message */
     uint32_t recNumRedundantNodes;  /**< numRedundantNodes for recursive routing */
     bool recordRoute;   /**< record visited hops on route */
+    bool visitedHopsFilter; /**< carry a bloom filter of visited hops in route messages */
     bool drawOverlayTopology;
     bool rejoinOnFailure;
     bool sendRpcResponseToLastHop; /**< needed by KBR protocols for NAT support */
@@ -381,6 +387,26 @@ public:
      */
     void join(const OverlayKey& nodeID = OverlayKey::UNSPECIFIED_KEY);
 
+    /**
+     * Completes a join deferred by GlobalNodeList::deferJoin()
+     *
+     * Installs the converged routing state computed from ring by
+     * installOracleState(). Overlays without support for this fall back
+     * to a normal join.
+     *
+     * @param ring all nodes with deferred joins, sorted by key
+     * @param pos position of this node in ring
+     */
+    void joinWarmStart(const OracleRing& ring, size_t pos);
+
+    /**
+     * Reports the pending RPCs and lookups, overlays override this
+     * to add their routing tables
+     *
+     * @param report the memory report
+     */
+    virtual void reportMemory(MemoryReport& report);
+
     /**
      * finds nodes closest to the given OverlayKey
      *
@@ -548,6 +574,26 @@ private://methods: sending packets over udp
 
     bool checkFindNode(BaseRouteMessage* routeMsg);
 
+    /**
+     * Adds a hop to the visited hops bloom filter of a route message
+     *
+     * @param msg the route message
+     * @param hop the visited hop
+     */
+    void addVisitedHop(BaseRouteMessage* msg, const TransportAddress& hop);
+
+    /**
+     * Checks if a route message has already visited a hop. The recorded
+     * route is used if available, otherwise the bloom filter, which may
+     * report false positives.
+     *
+     * @param msg the route message
+     * @param hop the hop to check
+     * @return true, if hop has (probably) been visited
+     */
+    bool isVisitedHop(const BaseRouteMessage* msg,
+                      const TransportAddress& hop) const;
+
 public:
     /**
      * Sends message to underlay
@@ -583,6 +629,18 @@ protected://fields: config
 
     LookupSet lookups;
 
+    typedef std::set<BatchLookup*> BatchLookupSet;
+
+    BatchLookupSet batchLookups;
+
+    LookupCache lookupCache; /**< cached results of recent lookups */
+
+    LogHistogram lookupDurationHistogram; /**< durations of successful iterative lookups */
+    LogHistogram lookupHopHistogram; /**< hop counts of successful iterative lookups */
+    uint32_t numHedgedRpcs; /**< hedged FindNodeCalls of iterative lookups */
+    uint32_t numHedgeWins; /**< hedged FindNodeCalls answered before the original call */
+    LogHistogram hedgeSavedHistogram; /**< time saved by hedges compared to waiting for the timeout */
+
 private://methods: internal routing
 
     /**
@@ -674,6 +732,24 @@ protected://methods: routing class factory
      */
     virtual void removeLookup( AbstractLookup* lookup );
 
+    /**
+     * Creates a batch lookup, which runs lookups for several keys
+     * concurrently and coalesces FindNodeCalls to the same node.
+     *
+     * @param routingType The routing type for the single lookups
+     * @param appLookup Set to true, if lookup is triggered by application (for statistics)
+     * @return BatchLookup* The new batch lookup instance.
+     */
+    BatchLookup* createBatchLookup(RoutingType routingType = DEFAULT_ROUTING,
+                                   bool appLookup = false);
+
+    /**
+     * Removes the batch lookup instance.
+     *
+     * @param batch the BatchLookup to remove
+     */
+    void removeBatchLookup(BatchLookup* batch);
+
     /**
      * Implements the find node call.
      *
@@ -707,6 +783,20 @@ protected://methods: routing class factory
      */
     virtual void joinOverlay();
 
+    /**
+     * Installs the routing state of a converged overlay
+     *
+     * Sets up the routing tables directly from the global view of all
+     * nodes in ring and changes the state to READY without sending
+     * any messages. Should be overridden by overlays supporting the
+     * oracleWarmStart parameter of the GlobalNodeList.
+     *
+     * @param ring all nodes with deferred joins, sorted by key
+     * @param pos position of this node in ring
+     * @return false, if the overlay doesn't support this
+     */
+    virtual bool installOracleState(const OracleRing& ring, size_t pos);
+
      /**
       * Join another overlay partition with the given node as bootstrap node
       *
@@ -731,11 +821,14 @@ protected://methods: routing class factory
 
     virtual void lookupRpc(LookupCall* call);
 
+    virtual void batchLookupRpc(BatchLookupCall* call);
+
     virtual void nextHopRpc(NextHopCall* call);
 
 protected://methods: statistic helpers for IterativeLookup
 
     void countFindNodeCall(const FindNodeCall* call);
+    void countMultiFindNodeCall(const MultiFindNodeCall* call);
     void countFailedNodeCall(const FailedNodeCall* call);
 
 
@@ -823,6 +916,7 @@ public:
 
 private:
     void findNodeRpc( FindNodeCall* call );
+    void multiFindNodeRpc( MultiFindNodeCall* call );
     void failedNodeRpc( FailedNodeCall* call );
 
     typedef std::map<CompType, std::pair<cModule*, cGate*> > CompModuleList;
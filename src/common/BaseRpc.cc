@@ -35,6 +35,7 @@
 #include <CryptoModule.h>
 #include <Vivaldi.h>
 #include <OverlayAccess.h>
+#include <EventProfiler.h>
 
 #include "BaseRpc.h"
 #include "RpcMacros.h"
@@ -101,6 +102,10 @@ void BaseRpc::initRpcs()
 
     rpcsPending = 0;
     rpcStates.clear();
+    timedOutRpcs.clear();
+
+    numRpcTimeouts = 0;
+    numSpuriousTimeouts = 0;
 
     defaultRpcListener = new RpcListener();
 
@@ -155,6 +160,38 @@ void BaseRpc::finishRpcs()
     }
 }
 
+void BaseRpc::reportMemory(MemoryReport& report)
+{
+    // timeout messages are accounted to the future event set
+    double bytes = 0;
+    for (RpcStates::const_iterator it = rpcStates.begin();
+            it != rpcStates.end(); ++it) {
+        bytes += MemoryReport::hashNodeBytes(sizeof(RpcState)) +
+                 MemoryReport::messageBytes(it->second.callMsg);
+        if (it->second.dest != NULL) {
+            bytes += sizeof(*it->second.dest);
+        }
+    }
+
+    report.add("BaseRpc: RPC states", rpcStates.size(), bytes);
+}
+
+void BaseRpc::finishRpcStatistics()
+{
+    globalStatistics->mergePercentiles("BaseRpc: UDP Round Trip Time (s)",
+                                       rpcRttHistogram);
+    rpcRttHistogram.clear();
+
+    globalStatistics->addStdDev("BaseRpc: Timeouts", numRpcTimeouts);
+    globalStatistics->addStdDev("BaseRpc: Spurious Timeouts",
+                                numSpuriousTimeouts);
+    if (numRpcTimeouts > 0) {
+        globalStatistics->addStdDev("BaseRpc: Spurious Timeout Ratio",
+                                    (double)numSpuriousTimeouts /
+                                    numRpcTimeouts);
+    }
+}
+
 void BaseRpc::cancelAllRpcs()
 {
     // stop all rpcs
@@ -168,6 +205,7 @@ void BaseRpc::cancelAllRpcs()
         i->second.context = NULL;
     }
     rpcStates.clear();
+    timedOutRpcs.clear();
 }
 
 uint32_t BaseRpc::sendRpcCall(TransportType transportType,
@@ -188,16 +226,16 @@ uint32_t BaseRpc::sendRpcCall(TransportType transportType,
         nonce = intuniform(1, 2147483647);
     } while (rpcStates.count(nonce) > 0);
 
+    bool adaptiveRto = false;
+
     if (timeout == -1) {
         switch (transportType) {
         case INTERNAL_TRANSPORT:
             timeout = 0;
             break;
         case UDP_TRANSPORT:
-            if (optimizeTimeouts) {
-                timeout = neighborCache->getNodeTimeout(dest);
-                if (timeout == -1) timeout = rpcUdpTimeout;
-            } else timeout = rpcUdpTimeout;
+            adaptiveRto = optimizeTimeouts;
+            timeout = getUdpTimeout(dest);
             break;
         case ROUTE_TRANSPORT:
             timeout = (destKey.isUnspecified() ?
@@ -226,6 +264,8 @@ uint32_t BaseRpc::sendRpcCall(TransportType transportType,
     state.timeoutMsg->setNonce(nonce);
     state.retries = retries;
     state.rto = timeout;
+    state.adaptiveRto = adaptiveRto;
+    state.retransmitted = false;
     state.transportType = transportType;
     //state.transportType = (destKey.isUnspecified() && (dest.getSourceRouteSize() == 0)
     //        ? UDP_TRANSPORT : transportType); //test
@@ -275,6 +315,25 @@ uint32_t BaseRpc::sendRpcCall(TransportType transportType,
 
 
 //public
+simtime_t BaseRpc::getUdpTimeout(const TransportAddress& dest)
+{
+    if (optimizeTimeouts) {
+        simtime_t timeout = neighborCache->getNodeTimeout(dest);
+        if (timeout != -1) return timeout;
+    }
+
+    return rpcUdpTimeout;
+}
+
+void BaseRpc::backoffNodeTimeout(const RpcState& state)
+{
+    simtime_t rto = neighborCache->getNodeTimeout(*state.dest);
+
+    if (rto == -1 || state.rto >= rto) {
+        neighborCache->backoffNodeTimeout(*state.dest);
+    }
+}
+
 void BaseRpc::cancelRpcMessage(uint32_t nonce)
 {
     if (rpcStates.count(nonce)==0)
@@ -292,6 +351,8 @@ void BaseRpc::cancelRpcMessage(uint32_t nonce)
 //protected
 void BaseRpc::internalHandleRpcMessage(BaseRpcMessage* msg)
 {
+    EventProfilerScope profile(this, "handleRpcMessage", msg);
+
     // check if this is a rpc call message
     BaseCallMessage* rpCall = dynamic_cast<BaseCallMessage*>(msg);
     if (rpCall != NULL) {
@@ -328,6 +389,17 @@ void BaseRpc::internalHandleRpcMessage(BaseRpcMessage* msg)
            << " " << thisNode.getKey().toString(16) << ")]\n"
            << "    RPC: Nonce Unknown"
            << endl;
+
+        // late response of a failed RPC?
+        for (TimedOutRpcs::iterator it = timedOutRpcs.begin();
+             it != timedOutRpcs.end(); ++it) {
+            if (it->second == nonce) {
+                RECORD_STATS(numSpuriousTimeouts++);
+                timedOutRpcs.erase(it);
+                break;
+            }
+        }
+
         delete msg;
         return;
     }
@@ -340,6 +412,7 @@ void BaseRpc::internalHandleRpcMessage(BaseRpcMessage* msg)
     if (msg->isSelfMessage() &&
         (dynamic_cast<RpcTimeoutMessage*>(msg) != NULL)) {
         // yes-> inform listener
+        RECORD_STATS(numRpcTimeouts++);
 
         // retry?
         state.retries--;
@@ -362,7 +435,12 @@ void BaseRpc::internalHandleRpcMessage(BaseRpcMessage* msg)
                                         dynamic_cast<BaseCallMessage*>
                                         (state.callMsg->dup()));
 
-            if (rpcExponentialBackoff) {
+            if (state.adaptiveRto) {
+                // back off the timeout shared by all components
+                backoffNodeTimeout(state);
+                simtime_t rto = neighborCache->getNodeTimeout(*state.dest);
+                state.rto = (rto == -1) ? state.rto * 2 : rto;
+            } else if (rpcExponentialBackoff) {
                 state.rto *= 2;
             }
 
@@ -370,6 +448,7 @@ void BaseRpc::internalHandleRpcMessage(BaseRpcMessage* msg)
                 scheduleAt(simTime() + state.rto, msg);
 
             state.timeSent = simTime();
+            state.retransmitted = true;
             rpcStates[nonce] = state;
             return;
         }
@@ -381,9 +460,21 @@ void BaseRpc::internalHandleRpcMessage(BaseRpcMessage* msg)
         // inform neighborcache
         if (state.transportType == UDP_TRANSPORT ||
             (!state.dest->isUnspecified() && state.destKey.isUnspecified())) {
+            if (state.adaptiveRto) {
+                backoffNodeTimeout(state);
+            }
             neighborCache->setNodeTimeout(*state.dest);
         }
 
+        // remember the nonce to detect late responses
+        if (state.transportType != INTERNAL_TRANSPORT) {
+            while (!timedOutRpcs.empty() &&
+                   timedOutRpcs.front().first < simTime() - rpcKeyTimeout) {
+                timedOutRpcs.pop_front();
+            }
+            timedOutRpcs.push_back(std::make_pair(simTime(), nonce));
+        }
+
         // inform listener
         if (state.listener != NULL)
             state.listener->handleRpcTimeout(state);
@@ -432,9 +523,18 @@ void BaseRpc::internalHandleRpcMessage(BaseRpcMessage* msg)
         BaseResponseMessage* response
             = dynamic_cast<BaseResponseMessage*>(msg);
 
-        //if (state.transportType == UDP_TRANSPORT)
-        //    globalStatistics->recordOutVector("BaseRpc: UDP Round Trip Time",
-        //                                      rtt);
+        if (state.transportType == UDP_TRANSPORT) {
+            RECORD_STATS(rpcRttHistogram.record(SIMTIME_DBL(rtt)));
+
+            // answered faster than ever measured before: the response
+            // belongs to an earlier copy of the call
+            if (state.retransmitted) {
+                simtime_t minRtt = neighborCache->getMinRtt(*state.dest);
+                if (minRtt > 0 && rtt < minRtt) {
+                    RECORD_STATS(numSpuriousTimeouts++);
+                }
+            }
+        }
 
         // neighborCache/ncs stuff
         if (state.transportType == UDP_TRANSPORT ||
@@ -456,9 +556,11 @@ void BaseRpc::internalHandleRpcMessage(BaseRpcMessage* msg)
                                           (ctrlInfo ?
                                            ctrlInfo->getSrcRoute() :
                                            NodeHandle::UNSPECIFIED_NODE),
-                                           coords);
+                                           coords, state.retransmitted);
             } else {
-                neighborCache->updateNode(response->getSrcNode(), rtt);
+                neighborCache->updateNode(response->getSrcNode(), rtt,
+                                          NodeHandle::UNSPECIFIED_NODE,
+                                          NULL, state.retransmitted);
             }
         }
 
@@ -26,6 +26,8 @@
 #ifndef __BASERPC_H_
 #define __BASERPC_H_
 
+#include <deque>
+
 #include <oversim_mapset.h>
 
 #include <omnetpp.h>
@@ -35,6 +37,8 @@
 #include <RpcMacros.h>
 
 #include <ProxNodeHandle.h>
+#include <LogHistogram.h>
+#include <MemoryReport.h>
 
 class UnderlayConfigurator;
 class GlobalStatistics;
@@ -57,12 +61,21 @@ class ProxListener;
  * @author Gregoire Menuel
  */
 class BaseRpc : public RpcListener,
-                public cSimpleModule
+                public cSimpleModule,
+                public MemoryReporter
 {
 public:
 
     BaseRpc();
 
+    /**
+     * Reports the pending RPCs, override to add the data structures
+     * of derived modules
+     *
+     * @param report the memory report
+     */
+    virtual void reportMemory(MemoryReport& report);
+
     /**
      * Returns the NodeHandle of this node.
      *
@@ -72,6 +85,14 @@ public:
 
     simtime_t getUdpTimeout() { return rpcUdpTimeout; };
 
+    /**
+     * Returns the timeout of a direct RPC to dest, which is sent with
+     * the default timeout
+     *
+     * @param dest the destination of the RPC
+     */
+    simtime_t getUdpTimeout(const TransportAddress& dest);
+
 protected:
 
     // overlay identity
@@ -85,6 +106,10 @@ protected:
     // references to global modules
     GlobalStatistics* globalStatistics;  /**< pointer to GlobalStatistics module in this node */
 
+    LogHistogram rpcRttHistogram; /**< round trip times of direct UDP RPCs */
+    uint32_t numRpcTimeouts; /**< expired timeouts including retransmissions */
+    uint32_t numSpuriousTimeouts; /**< timeouts of RPCs answered later on */
+
     /**
      * Handles internal rpc requests.<br>
      *
@@ -143,6 +168,11 @@ protected:
      */
     void finishRpcs();
 
+    /**
+     * Merges the RPC statistics of this node into GlobalStatistics
+     */
+    void finishRpcStatistics();
+
     /**
      * Handles incoming rpc messages and delegates them to the
      * corresponding listeners or handlers.
@@ -151,6 +181,15 @@ protected:
      */
     virtual void internalHandleRpcMessage(BaseRpcMessage* msg);
 
+    /**
+     * Backs off the timeout of the destination of an expired RPC once
+     * per expired timeout. Concurrent RPCs to the same node, which were
+     * sent with a timeout below the current one, don't back off again.
+     *
+     * @param state the expired RPC
+     */
+    void backoffNodeTimeout(const RpcState& state);
+
     /**
      * Routes a Remote-Procedure-Call message to an OverlayKey.<br>
      *
@@ -518,9 +557,16 @@ private:
 
     typedef UNORDERED_MAP<int,RpcState> RpcStates;
 
+    /**
+     * Nonces of recently failed RPCs and the time of their final
+     * timeout, used to detect spurious timeouts
+     */
+    typedef std::deque<std::pair<simtime_t, int> > TimedOutRpcs;
+
     int rpcsPending;
     RpcListener* defaultRpcListener;
     RpcStates rpcStates;
+    TimedOutRpcs timedOutRpcs;
     simtime_t rpcUdpTimeout, rpcKeyTimeout;
     bool optimizeTimeouts;
     bool rpcExponentialBackoff;
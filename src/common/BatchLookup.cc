@@ -0,0 +1,421 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file BatchLookup.cc
+ * @author agent
+ */
+
+#include <cassert>
+
+#include <BaseOverlay.h>
+#include <IterativeLookup.h>
+#include <GlobalStatistics.h>
+
+#include "BatchLookup.h"
+
+using namespace std;
+
+BatchLookupListener::~BatchLookupListener()
+{}
+
+void BatchLookup::KeyListener::lookupFinished(AbstractLookup* lookup)
+{
+    batch->keyLookupFinished(index, lookup);
+    delete this;
+}
+
+//----------------------------------------------------------------------------
+//- Construction & Destruction -----------------------------------------------
+//----------------------------------------------------------------------------
+BatchLookup::BatchLookup(BaseOverlay* overlay, RoutingType routingType,
+                         const IterativeLookupConfiguration& config,
+                         bool appLookup) :
+overlay(overlay),
+routingType(routingType),
+config(config),
+appLookup(appLookup),
+listener(NULL),
+numFinished(0),
+numRpcsRequested(0),
+numRpcsSent(0),
+dispatching(0),
+running(false),
+aborted(false)
+{
+}
+
+BatchLookup::~BatchLookup()
+{
+    // delete queued calls
+    for (CallQueue::iterator i = callQueue.begin(); i != callQueue.end(); i++) {
+        for (uint32_t j = 0; j < i->second.calls.size(); j++) {
+            delete i->second.calls[j].second;
+        }
+    }
+    callQueue.clear();
+
+    // cancel pending rpcs
+    for (PendingRpcs::iterator i = pendingRpcs.begin();
+            i != pendingRpcs.end(); i++) {
+        overlay->cancelRpcMessage(i->first);
+        for (uint32_t j = 0; j < i->second.size(); j++) {
+            delete i->second[j].second;
+        }
+    }
+    pendingRpcs.clear();
+
+    overlay->removeBatchLookup(this);
+}
+
+void BatchLookup::abortLookup()
+{
+    running = false;
+
+    // abort single lookups without notifying the key listeners
+    for (uint32_t i = 0; i < results.size(); i++) {
+        AbstractLookup* lookup = results[i].lookup;
+        results[i].lookup = NULL;
+        if (lookup != NULL) {
+            lookup->abortLookup();
+        }
+    }
+
+    if (listener != NULL) {
+        delete listener;
+        listener = NULL;
+    }
+
+    if (dispatching) {
+        aborted = true;
+    } else {
+        delete this;
+    }
+}
+
+//----------------------------------------------------------------------------
+//- Lookup -------------------------------------------------------------------
+//----------------------------------------------------------------------------
+void BatchLookup::lookup(const std::vector<OverlayKey>& keys, int numSiblings,
+                         int hopCountMax, int retries,
+                         BatchLookupListener* listener)
+{
+    if (running)
+        return;
+
+    this->listener = listener;
+    running = true;
+    startTime = simTime();
+
+    results.resize(keys.size());
+    for (uint32_t i = 0; i < keys.size(); i++) {
+        results[i].key = keys[i];
+        results[i].lookup = NULL;
+        results[i].hops = 0;
+        results[i].success = false;
+        results[i].finished = false;
+    }
+
+    // start all lookups before sending the first calls, so calls of
+    // the first step can already be coalesced
+    dispatching++;
+    for (uint32_t i = 0; i < keys.size() && !aborted; i++) {
+        AbstractLookup* lookup = overlay->createLookup(routingType, NULL,
+                                                       NULL, appLookup);
+
+        // only iterative lookups send FindNodeCalls we can coalesce
+        IterativeLookup* iterativeLookup =
+            dynamic_cast<IterativeLookup*>(lookup);
+        if (iterativeLookup != NULL) {
+            iterativeLookup->setBatch(this);
+        }
+
+        results[i].lookup = lookup;
+        lookup->lookup(keys[i], numSiblings, hopCountMax, retries,
+                       new KeyListener(this, i));
+    }
+    dispatching--;
+
+    finishDispatch();
+}
+
+void BatchLookup::keyLookupFinished(size_t index, AbstractLookup* lookup)
+{
+    KeyResult& result = results[index];
+
+    if (result.finished)
+        return;
+
+    result.lookup = NULL;
+    result.finished = true;
+    result.success = lookup->isValid();
+    result.siblings = lookup->getResult();
+    result.hops = overlay->isCountAccumulatedHops() ?
+        lookup->getAccumulatedHops() : lookup->getMinHops();
+
+    numFinished++;
+
+    checkFinished();
+}
+
+void BatchLookup::checkFinished()
+{
+    if (dispatching || !running || (numFinished < results.size()))
+        return;
+
+    running = false;
+
+    GlobalStatistics* globalStatistics = overlay->globalStatistics;
+
+    uint32_t hops = 0;
+    uint32_t successful = 0;
+    for (uint32_t i = 0; i < results.size(); i++) {
+        hops += results[i].hops;
+        if (results[i].success) successful++;
+    }
+
+    globalStatistics->addStdDev("BaseOverlay: Batch Lookup Keys",
+                                results.size());
+    globalStatistics->addStdDev("BaseOverlay: Batch Lookup Sent RPCs",
+                                numRpcsSent);
+    globalStatistics->addStdDev("BaseOverlay: Batch Lookup Saved RPCs",
+                                numRpcsRequested - numRpcsSent);
+    globalStatistics->addStdDev("BaseOverlay: Batch Lookup Duration",
+                                SIMTIME_DBL(simTime() - startTime));
+    if (results.size() > 0) {
+        globalStatistics->addStdDev("BaseOverlay: Batch Lookup Hops/Key",
+                                    (double)hops / results.size());
+        globalStatistics->addStdDev("BaseOverlay: Batch Lookup Success Ratio",
+                                    (double)successful / results.size());
+    }
+
+    if (listener != NULL) {
+        BatchLookupListener* oldListener = listener;
+        listener = NULL;
+        oldListener->batchLookupFinished(this);
+    }
+
+    delete this;
+}
+
+void BatchLookup::finishDispatch()
+{
+    if (dispatching)
+        return;
+
+    if (aborted) {
+        delete this;
+        return;
+    }
+
+    flush();
+    checkFinished();
+}
+
+//----------------------------------------------------------------------------
+//- FindNodeCall coalescing --------------------------------------------------
+//----------------------------------------------------------------------------
+void BatchLookup::queueFindNodeCall(IterativeLookup* lookup,
+                                    const NodeHandle& handle,
+                                    FindNodeCall* call)
+{
+    numRpcsRequested++;
+
+    QueuedCalls& queued = callQueue[handle];
+    queued.handle = handle;
+    queued.calls.push_back(make_pair(lookup, call));
+
+    // calls outside of a dispatch (e.g. triggered by a ping response)
+    // are sent immediately
+    if (!dispatching) {
+        flush();
+    }
+}
+
+void BatchLookup::cancelFindNodeCalls(IterativeLookup* lookup)
+{
+    for (CallQueue::iterator i = callQueue.begin(); i != callQueue.end();) {
+        CallList& calls = i->second.calls;
+        for (CallList::iterator j = calls.begin(); j != calls.end();) {
+            if (j->first == lookup) {
+                delete j->second;
+                j = calls.erase(j);
+            } else {
+                j++;
+            }
+        }
+        if (calls.empty()) {
+            callQueue.erase(i++);
+        } else {
+            i++;
+        }
+    }
+
+    for (PendingRpcs::iterator i = pendingRpcs.begin();
+            i != pendingRpcs.end();) {
+        CallList& calls = i->second;
+        for (CallList::iterator j = calls.begin(); j != calls.end();) {
+            if (j->first == lookup) {
+                delete j->second;
+                j = calls.erase(j);
+            } else {
+                j++;
+            }
+        }
+        if (calls.empty()) {
+            overlay->cancelRpcMessage(i->first);
+            pendingRpcs.erase(i++);
+        } else {
+            i++;
+        }
+    }
+}
+
+void BatchLookup::flush()
+{
+    CallQueue queue;
+    queue.swap(callQueue);
+
+    for (CallQueue::iterator i = queue.begin(); i != queue.end(); i++) {
+        const NodeHandle& handle = i->second.handle;
+        CallList& calls = i->second.calls;
+        CallList mergeable;
+
+        // calls with overlay specific extensions can't be merged
+        for (uint32_t j = 0; j < calls.size(); j++) {
+            FindNodeCall* call = calls[j].second;
+            if ((calls.size() == 1) || call->hasObject("findNodeExt")) {
+                overlay->countFindNodeCall(call);
+                uint32_t nonce = overlay->sendUdpRpcCall(handle,
+                                     static_cast<FindNodeCall*>(call->dup()),
+                                     NULL, -1, 0, -1, this);
+                pendingRpcs[nonce].push_back(calls[j]);
+                numRpcsSent++;
+            } else {
+                mergeable.push_back(calls[j]);
+            }
+        }
+
+        if (mergeable.size() == 0) {
+            continue;
+        }
+
+        const FindNodeCall* first = mergeable[0].second;
+        MultiFindNodeCall* multiCall =
+            new MultiFindNodeCall("MultiFindNodeCall");
+        multiCall->setStatType(first->getStatType());
+        multiCall->setNumRedundantNodes(first->getNumRedundantNodes());
+        multiCall->setNumSiblings(first->getNumSiblings());
+        multiCall->setExhaustiveIterative(first->getExhaustiveIterative());
+        multiCall->setLookupKeysArraySize(mergeable.size());
+        for (uint32_t j = 0; j < mergeable.size(); j++) {
+            multiCall->setLookupKeys(j, mergeable[j].second->getLookupKey());
+        }
+        multiCall->setBitLength(MULTIFINDNODECALL_L(multiCall));
+
+        overlay->countMultiFindNodeCall(multiCall);
+        uint32_t nonce = overlay->sendUdpRpcCall(handle, multiCall, NULL,
+                                                 -1, 0, -1, this);
+        pendingRpcs[nonce] = mergeable;
+        numRpcsSent++;
+    }
+}
+
+void BatchLookup::handleRpcResponse(BaseResponseMessage* msg,
+                                    cPolymorphic* context,
+                                    int rpcId, simtime_t rtt)
+{
+    PendingRpcs::iterator it = pendingRpcs.find(msg->getNonce());
+    if (it == pendingRpcs.end())
+        return;
+
+    CallList calls = it->second;
+    pendingRpcs.erase(it);
+
+    FindNodeResponse* findNodeResponse = dynamic_cast<FindNodeResponse*>(msg);
+    MultiFindNodeResponse* multiResponse =
+        dynamic_cast<MultiFindNodeResponse*>(msg);
+
+    dispatching++;
+    for (uint32_t i = 0; i < calls.size(); i++) {
+        IterativeLookup* lookup = calls[i].first;
+        FindNodeCall* call = calls[i].second;
+
+        if (aborted) {
+            // nothing to do
+        } else if (findNodeResponse != NULL) {
+            lookup->handleRpcResponse(findNodeResponse, NULL, rpcId, rtt);
+        } else if ((multiResponse != NULL) &&
+                   (i < multiResponse->getResultsArraySize()) &&
+                   (multiResponse->getResults(i).getLookupKey()
+                       == call->getLookupKey())) {
+            // split up the aggregated response
+            const FindNodeResult& result = multiResponse->getResults(i);
+            FindNodeResponse* response =
+                new FindNodeResponse("FindNodeResponse");
+            response->setSrcNode(multiResponse->getSrcNode());
+            response->setNonce(multiResponse->getNonce());
+            response->setType(multiResponse->getType());
+            response->setStatType(multiResponse->getStatType());
+            response->setCallHopCount(multiResponse->getCallHopCount());
+            response->setSiblings(result.getSiblings());
+            response->setClosestNodesArraySize(
+                    result.getClosestNodesArraySize());
+            for (uint32_t j = 0; j < result.getClosestNodesArraySize(); j++) {
+                response->setClosestNodes(j, result.getClosestNodes(j));
+            }
+            response->setBitLength(FINDNODERESPONSE_L(response));
+
+            lookup->handleRpcResponse(response, NULL, rpcId, rtt);
+            delete response;
+        } else {
+            // missing result for this key
+            lookup->handleRpcTimeout(call, msg->getSrcNode(), NULL, rpcId);
+        }
+
+        delete call;
+    }
+    dispatching--;
+
+    finishDispatch();
+}
+
+void BatchLookup::handleRpcTimeout(BaseCallMessage* msg,
+                                   const TransportAddress& dest,
+                                   cPolymorphic* context, int rpcId,
+                                   const OverlayKey& destKey)
+{
+    PendingRpcs::iterator it = pendingRpcs.find(msg->getNonce());
+    if (it == pendingRpcs.end())
+        return;
+
+    CallList calls = it->second;
+    pendingRpcs.erase(it);
+
+    dispatching++;
+    for (uint32_t i = 0; i < calls.size(); i++) {
+        if (!aborted) {
+            calls[i].first->handleRpcTimeout(calls[i].second, dest,
+                                             NULL, rpcId);
+        }
+        delete calls[i].second;
+    }
+    dispatching--;
+
+    finishDispatch();
+}
@@ -0,0 +1,226 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file BatchLookup.h
+ * @author agent
+ */
+
+#ifndef __BATCH_LOOKUP_H
+#define __BATCH_LOOKUP_H
+
+#include <vector>
+#include <map>
+
+#include <IterativeLookupConfiguration.h>
+#include <LookupListener.h>
+#include <RpcListener.h>
+
+#include <NodeVector.h>
+#include <CommonMessages_m.h>
+
+class BaseOverlay;
+class BatchLookup;
+class IterativeLookup;
+class FindNodeCall;
+class FindNodeResponse;
+
+/**
+ * This class declares an abstract batch lookup listener.
+ *
+ * @author agent
+ */
+class BatchLookupListener
+{
+public:
+    /**
+     * virtual destructor
+     */
+    virtual ~BatchLookupListener();
+
+    /**
+     * Called when the lookups for all keys of the batch are finished
+     *
+     * @param batch the finished batch lookup
+     */
+    virtual void batchLookupFinished(BatchLookup* batch) = 0;
+};
+
+/**
+ * Runs iterative lookups for a set of keys concurrently and coalesces
+ * FindNodeCalls of the individual lookups, which are sent to the same
+ * node in the same step, into a single MultiFindNodeCall. The
+ * MultiFindNodeResponse is split up again and delivered to the
+ * per-key IterativeLookup instances.
+ *
+ * @author agent
+ */
+class BatchLookup : public RpcListener
+{
+    friend class IterativeLookup;
+    friend class BaseOverlay;
+
+public:
+    /**
+     * Creates a new batch lookup
+     *
+     * @param overlay pointer to the overlay
+     * @param routingType the iterative routing type of the lookups
+     * @param config the lookup configuration for all keys
+     * @param appLookup true, if the lookup is triggered by an application
+     */
+    BatchLookup(BaseOverlay* overlay, RoutingType routingType,
+                const IterativeLookupConfiguration& config,
+                bool appLookup = false);
+
+    virtual ~BatchLookup();
+
+    /**
+     * Lookup siblings for a set of keys
+     *
+     * @param keys The keys to lookup
+     * @param numSiblings Number of siblings to lookup for each key
+     * @param hopCountMax Maximum hop count
+     * @param retries Number of retries if a lookup fails
+     * @param listener Listener to inform, when all lookups are done
+     */
+    void lookup(const std::vector<OverlayKey>& keys, int numSiblings = 1,
+                int hopCountMax = 0, int retries = 0,
+                BatchLookupListener* listener = NULL);
+
+    /**
+     * Aborts all running lookups of this batch without calling the
+     * listener and deletes the batch and the listener.
+     */
+    void abortLookup();
+
+    size_t getNumKeys() const { return results.size(); };
+    const OverlayKey& getKey(size_t i) const { return results[i].key; };
+    const NodeVector& getResult(size_t i) const { return results[i].siblings; };
+    bool isValid(size_t i) const { return results[i].success; };
+    uint32_t getHops(size_t i) const { return results[i].hops; };
+
+    /**
+     * Returns the number of FindNodeCalls the single lookups would have sent
+     */
+    uint32_t getNumRpcsRequested() const { return numRpcsRequested; };
+
+    /**
+     * Returns the number of RPCs that were actually sent
+     */
+    uint32_t getNumRpcsSent() const { return numRpcsSent; };
+
+protected:
+    /**
+     * Per key lookup listener, which forwards the result to the batch
+     */
+    class KeyListener : public LookupListener
+    {
+    public:
+        KeyListener(BatchLookup* batch, size_t index) :
+            batch(batch), index(index) {};
+        virtual void lookupFinished(AbstractLookup* lookup);
+
+    private:
+        BatchLookup* batch;
+        size_t index;
+    };
+
+    struct KeyResult
+    {
+        OverlayKey key;
+        NodeVector siblings;
+        AbstractLookup* lookup;
+        uint32_t hops;
+        bool success;
+        bool finished;
+    };
+
+    typedef std::vector<std::pair<IterativeLookup*, FindNodeCall*> > CallList;
+
+    struct QueuedCalls
+    {
+        NodeHandle handle;
+        CallList calls;
+    };
+
+    typedef std::map<TransportAddress, QueuedCalls> CallQueue;
+    typedef std::map<uint32_t, CallList> PendingRpcs;
+
+    /**
+     * Called by IterativeLookup::sendRpc() instead of sending the
+     * FindNodeCall itself. The call is queued until flush().
+     *
+     * @param lookup the lookup which wants to send the call
+     * @param handle the destination node
+     * @param call the FindNodeCall (ownership is taken)
+     */
+    void queueFindNodeCall(IterativeLookup* lookup, const NodeHandle& handle,
+                           FindNodeCall* call);
+
+    /**
+     * Removes all queued and pending calls of a lookup. Pending
+     * MultiFindNodeCalls without remaining lookups get cancelled.
+     *
+     * @param lookup the stopped lookup
+     */
+    void cancelFindNodeCalls(IterativeLookup* lookup);
+
+    /**
+     * Sends all queued calls, one RPC per destination node
+     */
+    void flush();
+
+    /**
+     * Flushes the call queue and finishes the batch, if all single
+     * lookups are done and no call into a single lookup is active
+     */
+    void finishDispatch();
+
+    void keyLookupFinished(size_t index, AbstractLookup* lookup);
+    void checkFinished();
+
+    virtual void handleRpcResponse(BaseResponseMessage* msg,
+                                   cPolymorphic* context,
+                                   int rpcId, simtime_t rtt);
+
+    virtual void handleRpcTimeout(BaseCallMessage* msg,
+                                  const TransportAddress& dest,
+                                  cPolymorphic* context, int rpcId,
+                                  const OverlayKey& destKey);
+
+    BaseOverlay* overlay;
+    RoutingType routingType;
+    IterativeLookupConfiguration config;
+    bool appLookup;
+    BatchLookupListener* listener;
+
+    std::vector<KeyResult> results;
+    CallQueue callQueue;
+    PendingRpcs pendingRpcs;
+
+    uint32_t numFinished;
+    uint32_t numRpcsRequested;
+    uint32_t numRpcsSent;
+    int dispatching;    /**< >0 while calls into the single lookups are active */
+    bool running;
+    bool aborted;       /**< abortLookup() was called while dispatching */
+    simtime_t startTime;
+};
+
+#endif
@@ -0,0 +1,541 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file Benchmark.cc
+ * @author agent
+ */
+
+#include <new>
+#ifdef OVERSIM_BENCHMARK
+#include <atomic>
+#endif
+#include <set>
+#include <cstdlib>
+#include <cstdio>
+
+#if defined __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <linux/perf_event.h>
+#endif
+
+#include <omnetpp.h>
+
+#include <OverlayKey.h>
+#include <Comparator.h>
+#include <NodeVector.h>
+#include <NeighborCacheTable.h>
+#include <FindNodeResponse.h>
+#include <cnetcommbuffer.h>
+#include <KademliaBucket.h>
+#include <PastryRoutingTable.h>
+#include <ChordFingerTable.h>
+#include <SimpleNodeEntry.h>
+
+#include "Benchmark.h"
+
+Define_Module(Benchmark);
+
+/**
+ * Provides the udp ingates a SimpleNodeEntry refers to
+ */
+class BenchmarkTransport : public cSimpleModule
+{
+  protected:
+    virtual void handleMessage(cMessage* msg) { delete msg; };
+};
+
+Define_Module(BenchmarkTransport);
+
+#ifdef OVERSIM_BENCHMARK
+// heap allocations of the whole process, read by the benchmarks. The
+// global operator new is only replaced in the OverSimBenchmark binary
+// built by "make benchmark", since it affects all allocations.
+static std::atomic<uint64_t> numAllocations(0);
+
+void* operator new(size_t size)
+{
+    numAllocations.fetch_add(1, std::memory_order_relaxed);
+    void* p = malloc(size ? size : 1);
+    if (p == NULL) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+#endif
+
+/**
+ * Small entry type for the NeighborCacheTable benchmark
+ */
+struct BenchmarkCacheEntry
+{
+    BenchmarkCacheEntry() : rtt(0) {};
+    void swap(BenchmarkCacheEntry& entry) { std::swap(rtt, entry.rtt); };
+    friend std::ostream& operator<<(std::ostream& os,
+                                    const BenchmarkCacheEntry& entry)
+    {
+        return os << entry.rtt;
+    };
+
+    simtime_t rtt;
+};
+
+Benchmark::Benchmark()
+{
+    cacheMissFd = -1;
+    sink = 0;
+}
+
+Benchmark::~Benchmark()
+{
+#if defined __linux__
+    if (cacheMissFd != -1) {
+        close(cacheMissFd);
+    }
+#endif
+}
+
+void Benchmark::initialize()
+{
+    OverlayKey::setKeyLength(par("keyLength"));
+    numOps = par("numOps");
+
+#if defined __linux__
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    cacheMissFd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+
+    cStringTokenizer tokenizer(par("tableSizes"));
+    const char* token;
+
+    while ((token = tokenizer.nextToken()) != NULL) {
+        size_t n = atoi(token);
+        if (n < 2) {
+            throw cRuntimeError("Benchmark::initialize(): "
+                                "table sizes must be at least 2");
+        }
+
+        benchmarkOverlayKey(n);
+        benchmarkNodeVector(n);
+        benchmarkKademliaBucket(n);
+        benchmarkPastryRoutingTable(n);
+        benchmarkChordFingerTable(n);
+        benchmarkNeighborCacheTable(n);
+        benchmarkCommBuffer(n);
+        benchmarkCalcDelay(n);
+    }
+
+    printf("%-40s %9s %12s %12s %14s\n", "benchmark", "n", "ns/op",
+           "allocs/op", "misses/op");
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        printf("%-40s %9u %12.1f %12.2f %14.2f\n", r.name.c_str(),
+               (unsigned int)r.tableSize, r.nsPerOp, r.allocsPerOp,
+               r.cacheMissesPerOp);
+    }
+    fflush(stdout);
+}
+
+void Benchmark::handleMessage(cMessage* msg)
+{
+    throw cRuntimeError("Benchmark::handleMessage(): unexpected message");
+}
+
+void Benchmark::finish()
+{
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        std::stringstream name;
+        name << "Benchmark: " << r.name << " (n=" << r.tableSize << ")";
+
+        recordScalar((name.str() + " ns/op").c_str(), r.nsPerOp);
+        if (r.allocsPerOp >= 0) {
+            recordScalar((name.str() + " allocs/op").c_str(), r.allocsPerOp);
+        }
+        if (r.cacheMissesPerOp >= 0) {
+            recordScalar((name.str() + " cache misses/op").c_str(),
+                         r.cacheMissesPerOp);
+        }
+    }
+}
+
+uint64_t Benchmark::readCacheMisses()
+{
+    uint64_t count = 0;
+#if defined __linux__
+    if (cacheMissFd != -1 &&
+        read(cacheMissFd, &count, sizeof(count)) != sizeof(count)) {
+        count = 0;
+    }
+#endif
+    return count;
+}
+
+void Benchmark::startMeasurement()
+{
+    startCacheMisses = readCacheMisses();
+#ifdef OVERSIM_BENCHMARK
+    startAllocations = numAllocations.load(std::memory_order_relaxed);
+#endif
+    gettimeofday(&startTime, NULL);
+}
+
+void Benchmark::stopMeasurement(const std::string& name, size_t tableSize,
+                                uint64_t numOps)
+{
+    struct timeval now, diff;
+    gettimeofday(&now, NULL);
+#ifdef OVERSIM_BENCHMARK
+    uint64_t allocations = numAllocations.load(std::memory_order_relaxed) -
+                           startAllocations;
+#endif
+    uint64_t cacheMisses = readCacheMisses() - startCacheMisses;
+    diff = timeval_substract(now, startTime);
+
+    Result r;
+    r.name = name;
+    r.tableSize = tableSize;
+    r.nsPerOp = (diff.tv_sec * 1e9 + diff.tv_usec * 1e3) / numOps;
+#ifdef OVERSIM_BENCHMARK
+    r.allocsPerOp = (double)allocations / numOps;
+#else
+    r.allocsPerOp = -1;
+#endif
+    r.cacheMissesPerOp = (cacheMissFd == -1) ? -1 :
+                         (double)cacheMisses / numOps;
+    results.push_back(r);
+}
+
+void Benchmark::createHandles(size_t n, std::vector<NodeHandle>& handles)
+{
+    handles.clear();
+    handles.reserve(n);
+
+    // consecutive addresses from 1.0.0.0 on, random keys
+    for (size_t i = 0; i < n; i++) {
+        handles.push_back(NodeHandle(OverlayKey::random(),
+                                     IPvXAddress(IPAddress(0x01000000 + i)),
+                                     1024));
+    }
+}
+
+void Benchmark::benchmarkOverlayKey(size_t n)
+{
+    std::vector<OverlayKey> keys(n);
+    std::vector<size_t> pairs(numOps);
+
+    for (size_t i = 0; i < n; i++) {
+        keys[i] = OverlayKey::random();
+    }
+    for (uint32_t i = 0; i < numOps; i++) {
+        pairs[i] = intuniform(0, n - 1);
+    }
+
+    uint64_t sum = 0;
+    startMeasurement();
+    for (uint32_t i = 0; i < numOps; i++) {
+        sum += keys[pairs[i]].sharedPrefixLength(keys[i % n]);
+    }
+    stopMeasurement("OverlayKey::sharedPrefixLength", n, numOps);
+
+    startMeasurement();
+    for (uint32_t i = 0; i < numOps; i++) {
+        sum += keys[pairs[i]].isBetweenR(keys[i % n], keys[(i + 1) % n]);
+    }
+    stopMeasurement("OverlayKey::isBetweenR", n, numOps);
+
+    startMeasurement();
+    for (uint32_t i = 0; i < numOps; i++) {
+        sum += (keys[pairs[i]] ^ keys[i % n]).getBit(0);
+    }
+    stopMeasurement("OverlayKey::operator^", n, numOps);
+
+    startMeasurement();
+    for (uint32_t i = 0; i < numOps; i++) {
+        sum += (keys[pairs[i]] + keys[i % n]).getBit(0);
+    }
+    stopMeasurement("OverlayKey::operator+", n, numOps);
+
+    sink += sum;
+}
+
+void Benchmark::benchmarkNodeVector(size_t n)
+{
+    std::vector<NodeHandle> handles;
+    createHandles(n, handles);
+
+    // lookups collect the numSiblings closest nodes to a key,
+    // every operation is an add() of a candidate
+    const uint32_t numSiblings = 8;
+    uint32_t ops = 0;
+
+    startMeasurement();
+    while (ops < numOps) {
+        OverlayKey target = handles[intuniform(0, n - 1)].getKey();
+        KeyDistanceComparator<KeyRingMetric> comp(target);
+        NodeVector vector(numSiblings, &comp);
+
+        for (size_t i = 0; i < std::min((size_t)64, n) && ops < numOps;
+             i++, ops++) {
+            vector.add(handles[intuniform(0, n - 1)]);
+        }
+        sink += vector.size();
+    }
+    stopMeasurement("NodeVector::add", n, numOps);
+}
+
+void Benchmark::benchmarkKademliaBucket(size_t n)
+{
+    std::vector<NodeHandle> handles;
+    createHandles(n, handles);
+
+    // routing table of a node with all n nodes offered to it,
+    // like Kademlia::routingAdd()
+    const uint32_t bucketSize = 8;
+    OverlayKey ownKey = OverlayKey::random();
+    KeyDistanceComparator<KeyXorMetric> comp(ownKey);
+    std::vector<KademliaBucket*> buckets(OverlayKey::getLength(), NULL);
+
+    uint32_t ops = 0;
+    startMeasurement();
+    while (ops < numOps) {
+        for (size_t i = 0; i < n && ops < numOps; i++, ops++) {
+            const NodeHandle& handle = handles[i];
+            int index = OverlayKey::getLength() -
+                ownKey.sharedPrefixLength(handle.getKey()) - 1;
+            if (index < 0) continue;
+
+            KademliaBucket*& bucket = buckets[index];
+            if (bucket == NULL) {
+                bucket = new KademliaBucket(NULL, bucketSize, &comp);
+            }
+
+            if (bucket->findIterator(handle.getKey()) == bucket->end()) {
+                bucket->add(KademliaBucketEntry(handle, 0.1));
+            }
+        }
+    }
+    stopMeasurement("KademliaBucket add/findIterator", n, numOps);
+
+    for (size_t i = 0; i < buckets.size(); i++) {
+        delete buckets[i];
+    }
+}
+
+void Benchmark::benchmarkPastryRoutingTable(size_t n)
+{
+    std::vector<NodeHandle> handles;
+    createHandles(n, handles);
+
+    cModuleType* moduleType =
+        cModuleType::get("oversim.overlay.pastry.PastryRoutingTable");
+    PastryRoutingTable* routingTable = check_and_cast<PastryRoutingTable*>(
+        moduleType->createScheduleInit("benchmarkRoutingTable",
+                                       getParentModule()));
+
+    NodeHandle owner(OverlayKey::random(), IPvXAddress(IPAddress(1)), 1024);
+    routingTable->initializeTable(4, 60, owner);
+
+    for (size_t i = 0; i < n; i++) {
+        routingTable->mergeNode(handles[i], intuniform(1, 300) / 1000.0);
+    }
+
+    std::vector<OverlayKey> keys(numOps);
+    for (uint32_t i = 0; i < numOps; i++) {
+        keys[i] = OverlayKey::random();
+    }
+
+    startMeasurement();
+    for (uint32_t i = 0; i < numOps; i++) {
+        sink += routingTable->findCloserNode(keys[i], true).getPort();
+    }
+    stopMeasurement("PastryRoutingTable::findCloserNode", n, numOps);
+
+    startMeasurement();
+    for (uint32_t i = 0; i < numOps; i++) {
+        sink += routingTable->lookupNextHop(keys[i]).getPort();
+    }
+    stopMeasurement("PastryRoutingTable::lookupNextHop", n, numOps);
+
+    routingTable->deleteModule();
+}
+
+void Benchmark::benchmarkChordFingerTable(size_t n)
+{
+    std::vector<NodeHandle> handles;
+    createHandles(n, handles);
+
+    std::map<OverlayKey, size_t> ring;
+    for (size_t i = 0; i < n; i++) {
+        ring.insert(std::make_pair(handles[i].getKey(), i));
+    }
+
+    cModuleType* moduleType =
+        cModuleType::get("oversim.overlay.chord.ChordFingerTable");
+    ChordFingerTable* fingerTable = check_and_cast<ChordFingerTable*>(
+        moduleType->createScheduleInit("benchmarkFingerTable",
+                                       getParentModule()));
+
+    // finger i is the successor of ownKey + 2^i
+    const OverlayKey& ownKey = handles[0].getKey();
+    uint32_t size = OverlayKey::getLength();
+    fingerTable->initializeTable(size, handles[0], NULL);
+
+    for (uint32_t i = 0; i < size; i++) {
+        OverlayKey start = ownKey + OverlayKey::pow2(i);
+        std::map<OverlayKey, size_t>::iterator it = ring.lower_bound(start);
+        if (it == ring.end()) it = ring.begin();
+        fingerTable->setFinger(i, handles[it->second]);
+    }
+
+    std::vector<OverlayKey> keys(numOps);
+    for (uint32_t i = 0; i < numOps; i++) {
+        keys[i] = OverlayKey::random();
+    }
+
+    // closest preceding finger, like Chord::closestPreceedingNode()
+    startMeasurement();
+    for (uint32_t i = 0; i < numOps; i++) {
+        for (int j = size - 1; j >= 0; j--) {
+            const NodeHandle& finger = fingerTable->getFinger(j);
+            if (!finger.isUnspecified() &&
+                finger.getKey().isBetween(ownKey, keys[i])) {
+                sink += finger.getPort();
+                break;
+            }
+        }
+    }
+    stopMeasurement("ChordFingerTable closest preceding finger", n, numOps);
+
+    fingerTable->deleteModule();
+}
+
+void Benchmark::benchmarkNeighborCacheTable(size_t n)
+{
+    std::vector<NodeHandle> handles;
+    createHandles(n, handles);
+
+    NeighborCacheTable<BenchmarkCacheEntry> table;
+
+    startMeasurement();
+    for (size_t i = 0; i < n; i++) {
+        table[handles[i]].rtt = 0.1;
+    }
+    stopMeasurement("NeighborCacheTable insert", n, n);
+
+    // the lookup done by NeighborCache::getProx() for cached nodes
+    std::vector<size_t> lookups(numOps);
+    for (uint32_t i = 0; i < numOps; i++) {
+        lookups[i] = intuniform(0, n - 1);
+    }
+
+    startMeasurement();
+    for (uint32_t i = 0; i < numOps; i++) {
+        NeighborCacheTable<BenchmarkCacheEntry>::iterator it =
+            table.find(handles[lookups[i]]);
+        if (it != table.end()) {
+            table.touch(it);
+            sink += (it->second.rtt > 0);
+        }
+    }
+    stopMeasurement("NeighborCacheTable find", n, numOps);
+}
+
+void Benchmark::benchmarkCommBuffer(size_t n)
+{
+    std::vector<NodeHandle> handles;
+    createHandles(std::min(n, (size_t)1000), handles);
+
+    cNetCommBuffer buffer;
+
+    startMeasurement();
+    for (uint32_t i = 0; i < numOps; i++) {
+        buffer.reset();
+        doPacking(&buffer, handles[i % handles.size()]);
+        NodeHandle handle;
+        doUnpacking(&buffer, handle);
+        sink += handle.getPort();
+    }
+    stopMeasurement("cNetCommBuffer NodeHandle pack/unpack", n, numOps);
+
+    // a FindNodeResponse with 8 closest nodes
+    FindNodeResponse response("FindNodeResponse");
+    response.setClosestNodesArraySize(8);
+    for (uint32_t i = 0; i < 8; i++) {
+        response.setClosestNodes(i, handles[i % handles.size()]);
+    }
+
+    uint32_t ops = std::max(numOps / 10, (uint32_t)1);
+    startMeasurement();
+    for (uint32_t i = 0; i < ops; i++) {
+        buffer.reset();
+        response.parsimPack(&buffer);
+        FindNodeResponse copy;
+        copy.parsimUnpack(&buffer);
+        sink += copy.getClosestNodesArraySize();
+    }
+    stopMeasurement("cNetCommBuffer FindNodeResponse pack/unpack", n, ops);
+}
+
+void Benchmark::benchmarkCalcDelay(size_t n)
+{
+    // every entry creates two temporary channel objects,
+    // so the number of entries is limited
+    size_t numEntries = std::min(n, (size_t)10000);
+    cChannelType* channelType =
+        cChannelType::get("oversim.common.simple_ethernetline");
+
+    NodeRecord::setDim(2);
+    std::vector<SimpleNodeEntry*> entries(numEntries);
+    for (size_t i = 0; i < numEntries; i++) {
+        NodeRecord* record = new NodeRecord;
+        record->coords[0] = uniform(0, 150);
+        record->coords[1] = uniform(0, 150);
+        // index -1: the entry owns its NodeRecord
+        entries[i] = new SimpleNodeEntry(getParentModule(), channelType,
+                                         channelType, 1000000, record, -1);
+    }
+
+    cPacket packet("benchmark");
+    packet.setByteLength(100);
+
+    startMeasurement();
+    for (uint32_t i = 0; i < numOps; i++) {
+        SimpleNodeEntry::SimpleDelay delay =
+            entries[i % numEntries]->calcDelay(&packet,
+                                               *entries[intuniform(0, numEntries - 1)],
+                                               false);
+        sink += delay.second;
+    }
+    stopMeasurement("SimpleNodeEntry::calcDelay", n, numOps);
+
+    for (size_t i = 0; i < numEntries; i++) {
+        delete entries[i];
+    }
+}
@@ -0,0 +1,98 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file Benchmark.h
+ * @author agent
+ */
+
+#ifndef __BENCHMARK_H__
+#define __BENCHMARK_H__
+
+#include <vector>
+#include <string>
+
+#include <omnetpp.h>
+#include <NodeHandle.h>
+
+/**
+ * Microbenchmarks for the data structures on the hot paths of the
+ * simulator (see BenchmarkNetwork and simulations/benchmark.ini).
+ *
+ * Every benchmark is executed for each table size in the tableSizes
+ * parameter and reports the time, the number of heap allocations (only
+ * if compiled with OVERSIM_BENCHMARK) and (on Linux, if permitted by
+ * perf_event_paranoid) the number of cache misses per operation. All random input is drawn from the simulation
+ * RNGs, so results are reproducible for a given seed.
+ *
+ * @author agent
+ */
+class Benchmark : public cSimpleModule
+{
+  public:
+    Benchmark();
+    ~Benchmark();
+
+  protected:
+    virtual int numInitStages() const { return 1; };
+    virtual void initialize();
+    virtual void handleMessage(cMessage* msg);
+    virtual void finish();
+
+  private:
+    struct Result
+    {
+        std::string name;
+        size_t tableSize;
+        double nsPerOp;
+        double allocsPerOp; /**< -1, if not available */
+        double cacheMissesPerOp; /**< -1, if not available */
+    };
+
+    void benchmarkOverlayKey(size_t n);
+    void benchmarkNodeVector(size_t n);
+    void benchmarkKademliaBucket(size_t n);
+    void benchmarkPastryRoutingTable(size_t n);
+    void benchmarkChordFingerTable(size_t n);
+    void benchmarkNeighborCacheTable(size_t n);
+    void benchmarkCommBuffer(size_t n);
+    void benchmarkCalcDelay(size_t n);
+
+    /** creates n random NodeHandles with distinct keys and addresses */
+    void createHandles(size_t n, std::vector<NodeHandle>& handles);
+
+    void startMeasurement();
+    void stopMeasurement(const std::string& name, size_t tableSize,
+                         uint64_t numOps);
+
+    uint64_t readCacheMisses();
+
+    uint32_t numOps; /**< number of operations per benchmark */
+
+    struct timeval startTime;
+    uint64_t startAllocations;
+    uint64_t startCacheMisses;
+    int cacheMissFd; /**< perf counter, -1 if not available */
+
+    std::vector<Result> results;
+
+    /** results of the benchmarked operations, prevents dead code elimination */
+    volatile uint64_t sink;
+};
+
+#endif
@@ -22,6 +22,10 @@
  */
 
 #include <iterator>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
 
 #include "BinaryValue.h"
 
@@ -30,34 +34,166 @@ using namespace std;
 // predefined BinaryValue
 const BinaryValue BinaryValue::UNSPECIFIED_VALUE;
 
-BinaryValue::BinaryValue(const char* s): vector<char>(strlen(s))
+BinaryValue::BinaryValue(const char* s)
 {
-    copy(s, s+strlen(s), begin());  // Inherits vector<char>::begin()
+    size_t n = strlen(s);
+    allocate(n);
+    memcpy(mutableData(), s, n);
 }
 
-BinaryValue::BinaryValue(size_t n): vector<char>(n)
+BinaryValue::BinaryValue(size_t n)
 {
+    allocate(n);
+    memset(mutableData(), 0, n);
 }
 
 BinaryValue::BinaryValue(const std::string& str)
 {
-    *this = BinaryValue(str.c_str());
+    allocate(str.size());
+    memcpy(mutableData(), str.data(), str.size());
 }
 
-BinaryValue::BinaryValue(const std::vector<char>& v) : vector<char>(v)
+BinaryValue::BinaryValue(const std::vector<char>& v)
 {
-};
+    allocate(v.size());
+    if (!v.empty()) {
+        memcpy(mutableData(), &v[0], v.size());
+    }
+}
+
+BinaryValue::BinaryValue(const char* b, const char* e)
+{
+    allocate(e - b);
+    memcpy(mutableData(), b, e - b);
+}
+
+BinaryValue::BinaryValue(const BinaryValue& value)
+{
+    length = value.length;
+    storage = value.storage;
+    if (!isInline()) {
+        storage.rep->refCount++;
+    }
+}
+
+BinaryValue& BinaryValue::operator=(const BinaryValue& rhs)
+{
+    if (!rhs.isInline()) {
+        rhs.storage.rep->refCount++;
+    }
+    release();
+    length = rhs.length;
+    storage = rhs.storage;
+    return *this;
+}
 
-BinaryValue::BinaryValue(const char* b, const char* e) : vector<char>(b, e)
+void BinaryValue::allocate(size_t n)
 {
-};
+    length = n;
+    if (!isInline()) {
+        storage.rep = (Rep*)malloc(sizeof(Rep) + n);
+        if (storage.rep == NULL) throw std::bad_alloc();
+        storage.rep->refCount = 1;
+        storage.rep->hash = 0;
+    }
+}
+
+void BinaryValue::release()
+{
+    if (!isInline() && --storage.rep->refCount == 0) {
+        free(storage.rep);
+    }
+}
+
+char* BinaryValue::mutableData()
+{
+    if (isInline()) {
+        return storage.buf;
+    }
+
+    if (storage.rep->refCount > 1) {
+        // copy on write
+        Rep* shared = storage.rep;
+        allocate(length);
+        memcpy(storage.rep->data, shared->data, length);
+        shared->refCount--;
+    }
+    storage.rep->hash = 0;
+    return storage.rep->data;
+}
+
+void BinaryValue::resize(size_t n)
+{
+    if (n == length) {
+        return;
+    }
+
+    BinaryValue value;
+    value.allocate(n);
+    char* p = value.mutableData();
+    memcpy(p, data(), min(n, length));
+    if (n > length) {
+        memset(p + length, 0, n - length);
+    }
+    *this = value;
+}
 
 BinaryValue& BinaryValue::operator+=(const BinaryValue& rhs)
 {
-    insert(end(), rhs.begin(), rhs.end());
+    if (rhs.empty()) {
+        return *this;
+    }
+
+    size_t oldLength = length;
+    BinaryValue value;
+    value.allocate(oldLength + rhs.length);
+    char* p = value.mutableData();
+    memcpy(p, data(), oldLength);
+    memcpy(p + oldLength, rhs.data(), rhs.length);
+    *this = value;
     return *this;
 }
 
+size_t BinaryValue::hash() const
+{
+    if (!isInline() && storage.rep->hash != 0) {
+        return storage.rep->hash;
+    }
+
+    // FNV-1a
+    size_t h = (sizeof(size_t) > 4) ? (size_t)14695981039346656037ULL
+                                    : (size_t)2166136261U;
+    size_t prime = (sizeof(size_t) > 4) ? (size_t)1099511628211ULL
+                                        : (size_t)16777619U;
+    const unsigned char* p = (const unsigned char*)data();
+    for (size_t i = 0; i < length; i++) {
+        h = (h ^ p[i]) * prime;
+    }
+    if (h == 0) h = 1;
+
+    if (!isInline()) {
+        storage.rep->hash = h;
+    }
+    return h;
+}
+
+bool BinaryValue::operator==(const BinaryValue& rhs) const
+{
+    if (length != rhs.length) {
+        return false;
+    }
+    if (!isInline()) {
+        if (storage.rep == rhs.storage.rep) {
+            return true;
+        }
+        if (storage.rep->hash != 0 && rhs.storage.rep->hash != 0 &&
+            storage.rep->hash != rhs.storage.rep->hash) {
+            return false;
+        }
+    }
+    return memcmp(data(), rhs.data(), length) == 0;
+}
+
 bool BinaryValue::isUnspecified() const
 {
     return empty();
@@ -69,30 +205,28 @@ std::ostream& operator << (std::ostream& os, const BinaryValue& v) {
     return os;        // To allow (cout << a) << b;
 }
 
-bool BinaryValue::operator<(const BinaryValue& rhs)
+// same order as std::vector<char>
+bool BinaryValue::operator<(const BinaryValue& rhs) const
 {
-    size_type minSize = min(this->size(), rhs.size());
-    for (size_type i=0; i<minSize; i++) {
-        if ((*this)[i] < rhs[i]) {
-            return true;
-        } else if ((*this)[i] > rhs[i]) {
-            return false;
-        }
+    if (!isInline() && storage.rep == rhs.storage.rep) {
+        return false;
     }
-
-    return (this->size() < rhs.size()) ? true : false;
+    return lexicographical_compare(begin(), end(), rhs.begin(), rhs.end());
 }
 
 void BinaryValue::netPack(cCommBuffer *b)
 {
+    const BinaryValue& value = *this;
     doPacking(b,(uint16_t)size());
-    doPacking(b, (const char*)(&(*begin())), size());
+    doPacking(b, value.data(), size());
 }
 
 void BinaryValue::netUnpack(cCommBuffer *b)
 {
     uint16_t size;
     doUnpacking(b, size);
-    resize(size);
-    doUnpacking(b, (char*)(&(*begin())), size);
+    BinaryValue value;
+    value.allocate(size);
+    doUnpacking(b, value.mutableData(), size);
+    *this = value;
 }
@@ -24,28 +24,108 @@
 #ifndef __BINARYVALUE_H_
 #define __BINARYVALUE_H_
 
+#include <vector>
+#include <string>
+#include <ostream>
+
 #include <omnetpp.h>
 
-class BinaryValue : public std::vector<char>, public cPolymorphic {
+/**
+ * Byte string for DHT values, names and addresses
+ *
+ * Values of up to INLINE_SIZE bytes are stored inline. Larger values
+ * are kept in a reference counted buffer, which is shared between all
+ * copies of a value, so copying values in messages, dup() and map
+ * insertions doesn't copy the payload. The buffer is copied (copy on
+ * write) when a non-const accessor is used on a shared value.
+ *
+ * Pointers obtained by non-const accessors are only valid until the
+ * value is copied, hashed or changed in size.
+ *
+ * @author Ingmar Baumgart
+ */
+class BinaryValue
+{
   public:
+    typedef char value_type;
+    typedef size_t size_type;
+    typedef char* iterator;
+    typedef const char* const_iterator;
+
     static const BinaryValue UNSPECIFIED_VALUE;
+    static const size_t INLINE_SIZE = 23; //!< maximum size of inline values
 
     BinaryValue(const char* s="");
     BinaryValue(const std::string& str);
     BinaryValue(const std::vector<char>& v);
     BinaryValue(size_t n);
     BinaryValue(const char *b, const char *e);
-    bool operator<(const BinaryValue& rhs);
+    BinaryValue(const BinaryValue& value);
+
+    ~BinaryValue() { release(); };
+
+    BinaryValue& operator=(const BinaryValue& rhs);
     BinaryValue& operator+=(const BinaryValue& rhs);
 
-    virtual ~BinaryValue() {};
+    size_t size() const { return length; };
+    bool empty() const { return length == 0; };
+
+    const char* data() const { return isInline() ? storage.buf : storage.rep->data; };
+    char* data() { return mutableData(); };
+
+    const_iterator begin() const { return data(); };
+    const_iterator end() const { return data() + length; };
+    iterator begin() { return mutableData(); };
+    iterator end() { return mutableData() + length; };
+
+    const char& operator[](size_t i) const { return data()[i]; };
+    char& operator[](size_t i) { return mutableData()[i]; };
+
+    /**
+     * Changes the size of the value, new bytes are set to 0
+     */
+    void resize(size_t n);
+
+    /**
+     * Returns the FNV-1a hash of the value, which is cached for
+     * shared values
+     */
+    size_t hash() const;
+
+    bool operator==(const BinaryValue& rhs) const;
+    bool operator!=(const BinaryValue& rhs) const { return !(*this == rhs); };
+    bool operator<(const BinaryValue& rhs) const;
 
     friend std::ostream& operator<< (std::ostream& os, const BinaryValue& v);
 
-    virtual void netPack(cCommBuffer *b);
-    virtual void netUnpack(cCommBuffer *b);
+    void netPack(cCommBuffer *b);
+    void netUnpack(cCommBuffer *b);
 
     bool isUnspecified() const;
+
+  private:
+    /**
+     * Shared buffer of values larger than INLINE_SIZE
+     */
+    struct Rep
+    {
+        uint32_t refCount;
+        size_t hash; //!< cached hash, 0 if not yet computed
+        char data[1];
+    };
+
+    bool isInline() const { return length <= INLINE_SIZE; };
+
+    /** allocates the storage for n bytes, the contents are undefined */
+    void allocate(size_t n);
+    void release();
+    char* mutableData();
+
+    size_t length;
+    union {
+        char buf[INLINE_SIZE + 1];
+        Rep* rep;
+    } storage;
 };
 
 inline void doPacking(cCommBuffer *b, BinaryValue& obj) {obj.netPack(b);}
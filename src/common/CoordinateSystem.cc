@@ -27,6 +27,25 @@
 
 uint8_t EuclideanNcsNodeInfo::dim;
 
+void AbstractNcsNodeInfo::getDistances(const std::vector<const AbstractNcsNodeInfo*>& nodes,
+                                       std::vector<Prox>& proxs) const
+{
+    proxs.resize(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        proxs[i] = nodes[i] ? getDistance(*nodes[i]) : Prox::PROX_UNKNOWN;
+    }
+}
+
+void AbstractNcs::getCoordinateBasedProxs(const std::vector<const AbstractNcsNodeInfo*>& nodes,
+                                          std::vector<Prox>& proxs) const
+{
+    proxs.resize(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        proxs[i] = nodes[i] ? getCoordinateBasedProx(*nodes[i]) :
+                              Prox::PROX_UNKNOWN;
+    }
+}
+
 Prox EuclideanNcsNodeInfo::getDistance(const AbstractNcsNodeInfo& abstractInfo) const
 {
     if (!dynamic_cast<const EuclideanNcsNodeInfo*>(&abstractInfo)) {
@@ -35,14 +54,38 @@ Prox EuclideanNcsNodeInfo::getDistance(const AbstractNcsNodeInfo& abstractInfo)
     const EuclideanNcsNodeInfo& info =
         *(static_cast<const EuclideanNcsNodeInfo*>(&abstractInfo));
 
-    double dist = 0.0;
+    return Prox(coordinates.getDistance(info.coordinates), 0.7); //TODO
+}
+
+void EuclideanNcsNodeInfo::getEuclideanDistances(const std::vector<const AbstractNcsNodeInfo*>& nodes,
+                                                 std::vector<double>& distances) const
+{
+    std::vector<const NcsCoordinates*> coords(nodes.size());
+
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        const EuclideanNcsNodeInfo* info =
+            dynamic_cast<const EuclideanNcsNodeInfo*>(nodes[i]);
+        coords[i] = info ? &info->coordinates : NULL;
+    }
 
-    for (uint8_t i = 0; i < info.getDimension(); ++i) {
-        dist += pow(getCoords(i) - info.getCoords(i), 2);
+    distances.resize(nodes.size());
+    if (nodes.size()) {
+        NcsCoordinates::getDistances(coordinates, &coords[0], coords.size(),
+                                     &distances[0]);
     }
-    dist = sqrt(dist);
+}
 
-    return Prox(dist, 0.7); //TODO
+void EuclideanNcsNodeInfo::getDistances(const std::vector<const AbstractNcsNodeInfo*>& nodes,
+                                        std::vector<Prox>& proxs) const
+{
+    std::vector<double> distances;
+    getEuclideanDistances(nodes, distances);
+
+    proxs.resize(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        proxs[i] = (distances[i] < 0) ? Prox::PROX_UNKNOWN :
+                                        Prox(distances[i], 0.7); //TODO
+    }
 }
 
 bool GnpNpsCoordsInfo::update(const AbstractNcsNodeInfo& abstractInfo)
@@ -93,12 +136,27 @@ Prox VivaldiCoordsInfo::getDistance(const AbstractNcsNodeInfo& abstractInfo) con
     const VivaldiCoordsInfo& info =
         *(static_cast<const VivaldiCoordsInfo*>(&abstractInfo));
 
-    double dist = 0.0, accuracy = 0.0;
+    return toProx(info, coordinates.getDistance(info.coordinates));
+}
 
-    for (uint8_t i = 0; i < info.getDimension(); ++i) {
-        dist += pow(getCoords(i) - info.getCoords(i), 2);
+void VivaldiCoordsInfo::getDistances(const std::vector<const AbstractNcsNodeInfo*>& nodes,
+                                     std::vector<Prox>& proxs) const
+{
+    std::vector<double> distances;
+    getEuclideanDistances(nodes, distances);
+
+    proxs.resize(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        const VivaldiCoordsInfo* info =
+            dynamic_cast<const VivaldiCoordsInfo*>(nodes[i]);
+        proxs[i] = (info && distances[i] >= 0) ? toProx(*info, distances[i]) :
+                                                 Prox::PROX_UNKNOWN;
     }
-    dist = sqrt(dist);
+}
+
+Prox VivaldiCoordsInfo::toProx(const VivaldiCoordsInfo& info, double dist) const
+{
+    double accuracy;
 
     accuracy = 1 - ((info.getError() + getError()) / 2);
     if (info.getError() >= 1.0 || getError() >= 1.0) accuracy = 0.0;
@@ -28,6 +28,8 @@
 
 #include <omnetpp.h>
 
+#include <NcsCoordinates.h>
+
 class Prox;
 class NeighborCache;
 class BaseCallMessage;
@@ -39,6 +41,16 @@ public:
     virtual ~AbstractNcsNodeInfo() {};
     virtual bool isValid() = 0;
     virtual Prox getDistance(const AbstractNcsNodeInfo& node) const = 0;
+
+    /**
+     * Computes the distances to several nodes at once
+     *
+     * @param nodes the nodes (NULL entries result in Prox::PROX_UNKNOWN)
+     * @param proxs the distances in the order of nodes
+     */
+    virtual void getDistances(const std::vector<const AbstractNcsNodeInfo*>& nodes,
+                              std::vector<Prox>& proxs) const;
+
     virtual bool update(const AbstractNcsNodeInfo& info) = 0;
 
     virtual operator std::vector<double>() const = 0;
@@ -47,11 +59,17 @@ public:
 class EuclideanNcsNodeInfo : public AbstractNcsNodeInfo
 {
 public:
-    EuclideanNcsNodeInfo() { coordinates.resize(dim); };
+    EuclideanNcsNodeInfo() : coordinates(dim) { };
     virtual ~EuclideanNcsNodeInfo() { };
 
     uint8_t getDimension() const { return coordinates.size(); };
-    static void setDimension(uint8_t dimension) { dim = dimension; };
+    static void setDimension(uint8_t dimension) {
+        if (dimension > NcsCoordinates::MAX_DIM) {
+            throw cRuntimeError("EuclideanNcsNodeInfo: at most %d dimensions "
+                                "supported!", NcsCoordinates::MAX_DIM);
+        }
+        dim = dimension;
+    };
 
     double getCoords(uint8_t i) const {
         if (i >= coordinates.size()) {
@@ -60,7 +78,9 @@ public:
         return coordinates[i];
     };
 
-    const std::vector<double>& getCoords() const { return coordinates; };
+    const NcsCoordinates& getCoords() const { return coordinates; };
+
+    void setCoords(const NcsCoordinates& coords) { coordinates = coords; };
 
     void setCoords(uint8_t i, double value) {
         if (i >= coordinates.size()) {
@@ -70,9 +90,19 @@ public:
     };
 
     Prox getDistance(const AbstractNcsNodeInfo& abstractInfo) const;
+    void getDistances(const std::vector<const AbstractNcsNodeInfo*>& nodes,
+                      std::vector<Prox>& proxs) const;
 
 protected:
-    std::vector<double> coordinates;
+    /**
+     * Collects the coordinates of nodes and computes the raw euclidean
+     * distances with NcsCoordinates::getDistances(), nodes which are
+     * no EuclideanNcsNodeInfo get a negative distance
+     */
+    void getEuclideanDistances(const std::vector<const AbstractNcsNodeInfo*>& nodes,
+                               std::vector<double>& distances) const;
+
+    NcsCoordinates coordinates;
     static uint8_t dim;
 };
 
@@ -103,6 +133,11 @@ class SimpleCoordsInfo : public EuclideanNcsNodeInfo
     bool isValid() { return true; };
 
     Prox getDistance(const AbstractNcsNodeInfo& abstractInfo) const;
+    void getDistances(const std::vector<const AbstractNcsNodeInfo*>& nodes,
+                      std::vector<Prox>& proxs) const {
+        // access delays have to be added per node
+        AbstractNcsNodeInfo::getDistances(nodes, proxs);
+    };
     bool update(const AbstractNcsNodeInfo& abstractInfo);
 
     simtime_t getAccessDelay() const { return accessDelay; };
@@ -138,10 +173,18 @@ public:
     };
 
     Prox getDistance(const AbstractNcsNodeInfo& node) const;
+    void getDistances(const std::vector<const AbstractNcsNodeInfo*>& nodes,
+                      std::vector<Prox>& proxs) const;
     bool update(const AbstractNcsNodeInfo& info);
     operator std::vector<double>() const ;
 
 protected:
+    /**
+     * Converts the euclidean distance to info into a Prox, considering
+     * the height vectors and the errors of both nodes
+     */
+    Prox toProx(const VivaldiCoordsInfo& info, double dist) const;
+
     double coordErr;
     double heightVector;
 };
@@ -157,6 +200,15 @@ class AbstractNcs {
     virtual AbstractNcsNodeInfo* getUnvalidNcsInfo() const = 0;
 
     virtual Prox getCoordinateBasedProx(const AbstractNcsNodeInfo& node) const = 0;
+
+    /**
+     * Estimates the proximity of several nodes at once
+     *
+     * @param nodes the nodes (NULL entries result in Prox::PROX_UNKNOWN)
+     * @param proxs the estimates in the order of nodes
+     */
+    virtual void getCoordinateBasedProxs(const std::vector<const AbstractNcsNodeInfo*>& nodes,
+                                         std::vector<Prox>& proxs) const;
     virtual void processCoordinates(const simtime_t& rtt,
                                     const AbstractNcsNodeInfo& nodeInfo) { };
 
@@ -0,0 +1,264 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file EventProfiler.cc
+ * @author agent
+ */
+
+#include <fstream>
+#include <algorithm>
+#include <errno.h>
+#include <string.h>
+#ifndef _WIN32
+#include <time.h>
+#else
+#include <windows.h>
+#endif
+
+#include "EventProfiler.h"
+
+bool EventProfiler::enabled = false;
+std::vector<EventProfiler::Node> EventProfiler::nodes;
+size_t EventProfiler::current = 0;
+uint64_t EventProfiler::startNs = 0;
+
+static uint64_t wallClockNs()
+{
+#ifndef _WIN32
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#else
+    LARGE_INTEGER counter, frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (uint64_t)(counter.QuadPart * (1000000000.0 / frequency.QuadPart));
+#endif
+}
+
+bool EventProfiler::Frame::operator<(const Frame& rhs) const
+{
+    if (module != rhs.module) return module->before(*rhs.module);
+    if (function != rhs.function) return strcmp(function, rhs.function) < 0;
+    if (message != rhs.message) return message->before(*rhs.message);
+    return false;
+}
+
+void EventProfiler::start()
+{
+    nodes.clear();
+    nodes.push_back(Node());
+    nodes[0].frame.module = NULL;
+    nodes[0].frame.function = NULL;
+    nodes[0].frame.message = NULL;
+    nodes[0].parent = 0;
+    nodes[0].count = nodes[0].totalNs = nodes[0].childNs = 0;
+    nodes[0].allocs = nodes[0].childAllocs = 0;
+
+    current = 0;
+    startNs = wallClockNs();
+    nodes[0].startAllocs = cMessage::getTotalMessageCount();
+    enabled = true;
+}
+
+void EventProfiler::enter(const cModule* module, const char* function,
+                          const cMessage* msg)
+{
+    Frame frame;
+    frame.module = &typeid(*module);
+    frame.function = function;
+    frame.message = &typeid(*msg);
+
+    size_t child;
+    std::map<Frame, size_t>::iterator it = nodes[current].children.find(frame);
+
+    if (it == nodes[current].children.end()) {
+        child = nodes.size();
+        nodes[current].children.insert(std::make_pair(frame, child));
+        nodes.push_back(Node());
+        Node& node = nodes.back();
+        node.frame = frame;
+        node.parent = current;
+        node.count = node.totalNs = node.childNs = 0;
+        node.allocs = node.childAllocs = 0;
+    } else {
+        child = it->second;
+    }
+
+    current = child;
+    Node& node = nodes[current];
+    node.count++;
+    node.startAllocs = cMessage::getTotalMessageCount();
+    node.startNs = wallClockNs();
+}
+
+void EventProfiler::leave()
+{
+    // scopes entered before stop() or start()
+    if (!enabled || current == 0) {
+        return;
+    }
+
+    uint64_t ns = wallClockNs();
+    Node& node = nodes[current];
+    uint64_t elapsed = ns - node.startNs;
+    uint64_t allocs = cMessage::getTotalMessageCount() - node.startAllocs;
+
+    node.totalNs += elapsed;
+    node.allocs += allocs;
+
+    current = node.parent;
+    nodes[current].childNs += elapsed;
+    nodes[current].childAllocs += allocs;
+}
+
+std::string EventProfiler::frameName(const Frame& frame)
+{
+    return std::string(opp_typename(*frame.module)) + "::" + frame.function
+        + "(" + opp_typename(*frame.message) + ")";
+}
+
+std::string EventProfiler::stackName(size_t node)
+{
+    std::string name = frameName(nodes[node].frame);
+
+    for (node = nodes[node].parent; node != 0; node = nodes[node].parent) {
+        name = frameName(nodes[node].frame) + ";" + name;
+    }
+
+    return name;
+}
+
+struct ProfileEntry //!< accumulated self costs of a frame
+{
+    uint64_t count;
+    uint64_t selfNs;
+    uint64_t totalNs;
+    uint64_t selfAllocs;
+    std::string name;
+
+    ProfileEntry() : count(0), selfNs(0), totalNs(0), selfAllocs(0) {};
+
+    // sorts by descending self time
+    bool operator<(const ProfileEntry& rhs) const
+    {
+        return selfNs > rhs.selfNs;
+    };
+};
+
+void EventProfiler::stop(const std::string& prefix)
+{
+    if (!enabled) {
+        return;
+    }
+
+    enabled = false;
+
+    uint64_t wallNs = wallClockNs() - startNs;
+    uint64_t totalAllocs = cMessage::getTotalMessageCount() -
+        nodes[0].startAllocs;
+
+    // self costs of all frames, recursive frames are only counted once
+    // for the total time
+    std::map<std::string, ProfileEntry> frames;
+
+    for (size_t i = 1; i < nodes.size(); i++) {
+        const Node& node = nodes[i];
+        ProfileEntry& entry = frames[frameName(node.frame)];
+        entry.count += node.count;
+        entry.selfNs += node.totalNs - node.childNs;
+        entry.selfAllocs += node.allocs - node.childAllocs;
+
+        bool recursive = false;
+        for (size_t p = node.parent; p != 0; p = nodes[p].parent) {
+            if (!(node.frame < nodes[p].frame) &&
+                !(nodes[p].frame < node.frame)) {
+                recursive = true;
+                break;
+            }
+        }
+        if (!recursive) {
+            entry.totalNs += node.totalNs;
+        }
+    }
+
+    ProfileEntry unprofiled;
+    unprofiled.name = "[unprofiled]";
+    unprofiled.selfNs = wallNs - nodes[0].childNs;
+    unprofiled.totalNs = unprofiled.selfNs;
+    unprofiled.selfAllocs = totalAllocs - nodes[0].childAllocs;
+
+    std::vector<ProfileEntry> entries;
+    entries.push_back(unprofiled);
+    for (std::map<std::string, ProfileEntry>::iterator it = frames.begin();
+            it != frames.end(); ++it) {
+        it->second.name = it->first;
+        entries.push_back(it->second);
+    }
+    std::sort(entries.begin(), entries.end());
+
+    std::string reportName = prefix + ".txt";
+    std::ofstream report(reportName.c_str());
+    if (!report) {
+        throw cRuntimeError("EventProfiler::stop(): Can't write %s: %s",
+                            reportName.c_str(), strerror(errno));
+    }
+
+    report << "# wall clock time: " << wallNs / 1e9 << " s, events: "
+           << simulation.getEventNumber() << ", messages allocated: "
+           << totalAllocs << "\n"
+           << "# self[ms]\tself[%]\ttotal[ms]\tcalls\tself[ns]/call"
+           << "\tmsgs/call\tframe\n";
+
+    for (size_t i = 0; i < entries.size(); i++) {
+        const ProfileEntry& e = entries[i];
+        report << e.selfNs / 1e6 << "\t"
+               << (wallNs > 0 ? 100.0 * e.selfNs / wallNs : 0) << "\t"
+               << e.totalNs / 1e6 << "\t"
+               << e.count << "\t"
+               << (e.count > 0 ? e.selfNs / e.count : 0) << "\t"
+               << (e.count > 0 ? (double)e.selfAllocs / e.count : 0) << "\t"
+               << e.name << "\n";
+    }
+    report.close();
+
+    // folded stacks: "frame;frame;frame selfNs" (see flamegraph.pl)
+    std::string foldedName = prefix + ".folded";
+    std::ofstream folded(foldedName.c_str());
+    if (!folded) {
+        throw cRuntimeError("EventProfiler::stop(): Can't write %s: %s",
+                            foldedName.c_str(), strerror(errno));
+    }
+
+    folded << unprofiled.name << " " << unprofiled.selfNs << "\n";
+    for (size_t i = 1; i < nodes.size(); i++) {
+        uint64_t selfNs = nodes[i].totalNs - nodes[i].childNs;
+        if (selfNs > 0) {
+            folded << stackName(i) << " " << selfNs << "\n";
+        }
+    }
+    folded.close();
+
+    EV << "[EventProfiler::stop()]\n"
+       << "    Profile written to " << reportName << " and " << foldedName
+       << endl;
+
+    nodes.clear();
+    current = 0;
+}
@@ -0,0 +1,149 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file EventProfiler.h
+ * @author agent
+ */
+
+#ifndef __EVENTPROFILER_H__
+#define __EVENTPROFILER_H__
+
+#include <map>
+#include <string>
+#include <vector>
+#include <typeinfo>
+#include <stdint.h>
+
+#include <omnetpp.h>
+
+/**
+ * Profiler, which attributes the wall clock time of the simulation
+ * to the module types and message classes handled at the message
+ * dispatch points of BaseOverlay, BaseApp and BaseRpc
+ *
+ * Profiled scopes form a call tree (e.g. handleMessage() of Chord
+ * calling handleRpcMessage() for a FindNodeCall). For every node of
+ * the tree the number of calls, the wall clock time and the number of
+ * messages allocated are accumulated. Time spent outside of profiled
+ * scopes (simulation kernel, future event set, underlay modules) is
+ * reported as "[unprofiled]".
+ *
+ * The profiler is enabled with the profileEvents parameter of
+ * GlobalStatistics. If it is disabled, a profiled scope costs a single
+ * branch.
+ *
+ * @author agent
+ */
+class EventProfiler
+{
+  public:
+    /**
+     * Resets all counters and starts profiling
+     */
+    static void start();
+
+    /**
+     * Stops profiling and writes a report sorted by self time to
+     * prefix.txt and the call stacks in the folded format of
+     * flamegraph.pl to prefix.folded
+     *
+     * @param prefix prefix of the output files
+     */
+    static void stop(const std::string& prefix);
+
+    /** Returns true if profiling is enabled */
+    static bool isEnabled() { return enabled; };
+
+    /**
+     * Enters a profiled scope
+     *
+     * @param module the module handling msg
+     * @param function name of the dispatch function (string literal)
+     * @param msg the message to handle
+     */
+    static void enter(const cModule* module, const char* function,
+                      const cMessage* msg);
+
+    /**
+     * Leaves the innermost profiled scope
+     */
+    static void leave();
+
+  private:
+    struct Frame
+    {
+        const std::type_info* module;
+        const char* function;
+        const std::type_info* message;
+
+        bool operator<(const Frame& rhs) const;
+    };
+
+    struct Node //!< node of the call tree
+    {
+        Frame frame;
+        size_t parent;
+        std::map<Frame, size_t> children;
+        uint64_t count; //!< number of calls
+        uint64_t totalNs; //!< wall clock time including children
+        uint64_t childNs; //!< wall clock time of children
+        uint64_t allocs; //!< messages allocated including children
+        uint64_t childAllocs; //!< messages allocated by children
+        uint64_t startNs; //!< start time of the current call
+        uint64_t startAllocs; //!< message count at start of the current call
+    };
+
+    static bool enabled;
+    static std::vector<Node> nodes; //!< call tree, nodes[0] is the root
+    static size_t current; //!< node of the innermost scope
+    static uint64_t startNs; //!< wall clock time of start()
+
+    static std::string frameName(const Frame& frame);
+    static std::string stackName(size_t node);
+};
+
+/**
+ * Profiles the enclosing block if the EventProfiler is enabled
+ *
+ * @author agent
+ */
+class EventProfilerScope
+{
+  public:
+    EventProfilerScope(const cModule* module, const char* function,
+                       const cMessage* msg)
+    {
+        active = EventProfiler::isEnabled();
+        if (active) {
+            EventProfiler::enter(module, function, msg);
+        }
+    };
+
+    ~EventProfilerScope()
+    {
+        if (active) {
+            EventProfiler::leave();
+        }
+    };
+
+  private:
+    bool active;
+};
+
+#endif
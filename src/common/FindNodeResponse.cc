@@ -0,0 +1,40 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file FindNodeResponse.cc
+ * @author agent
+ */
+
+#include <omnetpp.h>
+#include "CommonMessages_m.h"
+#include "FindNodeResponse.h"
+
+Register_Class(FindNodeResponse);
+
+void FindNodeResponse::parsimPack(cCommBuffer *b)
+{
+    FindNodeResponse_Base::parsimPack(b);
+    doPacking(b, closestNodes);
+}
+
+void FindNodeResponse::parsimUnpack(cCommBuffer *b)
+{
+    FindNodeResponse_Base::parsimUnpack(b);
+    doUnpacking(b, closestNodes);
+}
@@ -0,0 +1,60 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file FindNodeResponse.h
+ * @author agent
+ */
+
+#ifndef __FINDNODERESPONSE_H_
+#define __FINDNODERESPONSE_H_
+
+#include <NodeHandleList.h>
+#include "CommonMessages_m.h"
+
+/**
+ * FindNodeResponse with closestNodes[] stored in a NodeHandleList
+ *
+ * This header is included by CommonMessages_m.h.
+ *
+ * @author agent
+ */
+class FindNodeResponse : public FindNodeResponse_Base
+{
+public:
+    FindNodeResponse(const char *name=NULL, int kind=0) : FindNodeResponse_Base(name,kind) {}
+    FindNodeResponse(const FindNodeResponse& other) : FindNodeResponse_Base(other.getName()) {operator=(other);}
+    FindNodeResponse& operator=(const FindNodeResponse& other)
+    {
+        if (this == &other) return *this;
+        FindNodeResponse_Base::operator=(other);
+        closestNodes = other.closestNodes;
+        return *this;
+    }
+    virtual FindNodeResponse *dup() const {return new FindNodeResponse(*this);}
+
+    virtual void parsimPack(cCommBuffer *b);
+    virtual void parsimUnpack(cCommBuffer *b);
+
+    NODEHANDLELIST_ACCESSORS(ClosestNodes, closestNodes)
+
+protected:
+    NodeHandleList closestNodes;
+};
+
+#endif
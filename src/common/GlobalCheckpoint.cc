@@ -0,0 +1,657 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file GlobalCheckpoint.cc
+ * @author agent
+ */
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#else
+#include <io.h>
+#endif
+
+#include <GlobalNodeListAccess.h>
+#include <BaseOverlay.h>
+#include <DHT.h>
+#include <DHTDataStorage.h>
+#include <GlobalDhtTestMap.h>
+#include <SimpleInfo.h>
+#include <SimpleNodeEntry.h>
+
+#include "GlobalCheckpoint.h"
+
+Define_Module(GlobalCheckpoint);
+
+static const char CHECKPOINT_MAGIC[8] = "OSCKPT";
+static const uint32_t CHECKPOINT_VERSION = 2;
+
+static uint64_t alignOffset(uint64_t offset)
+{
+    return (offset + 7) & ~(uint64_t)7;
+}
+
+// true, if count records of recordSize bytes at offset fit into size bytes
+static bool sectionFits(uint64_t offset, uint64_t count, uint64_t recordSize,
+                        uint64_t size)
+{
+    if (offset > size || alignOffset(offset) != offset) {
+        return false;
+    }
+
+    return (recordSize == 0) || (count <= (size - offset) / recordSize);
+}
+
+template<typename T>
+static const void* sectionData(const std::vector<T>& section)
+{
+    return section.empty() ? NULL : &section[0];
+}
+
+/**
+ * Orders the entries of the GlobalNodeList by address, so nodes are
+ * restored in the order of their creation
+ */
+struct PeerAddressLess
+{
+    bool operator()(const PeerHashMap::const_iterator& a,
+                    const PeerHashMap::const_iterator& b) const
+    {
+        return a->first < b->first;
+    }
+};
+
+GlobalCheckpoint::GlobalCheckpoint()
+{
+    checkpointTimer = NULL;
+    data = NULL;
+    dataSize = 0;
+    header = NULL;
+}
+
+GlobalCheckpoint::~GlobalCheckpoint()
+{
+    cancelAndDelete(checkpointTimer);
+    closeCheckpoint();
+}
+
+void GlobalCheckpoint::initialize()
+{
+    globalNodeList = GlobalNodeListAccess().get();
+
+    const char* restoreFile = par("restoreFile");
+    if (strlen(restoreFile) > 0) {
+        if (!globalNodeList->par("oracleWarmStart").boolValue()) {
+            throw cRuntimeError("GlobalCheckpoint::initialize(): Restoring "
+                                "a checkpoint requires oracleWarmStart = true!");
+        }
+        openCheckpoint(restoreFile);
+    }
+
+    if (strlen(par("checkpointFile")) > 0 && par("checkpointTime").doubleValue() >= 0) {
+        checkpointTimer = new cMessage("checkpointTimer");
+        scheduleAt(par("checkpointTime").doubleValue(), checkpointTimer);
+    }
+}
+
+void GlobalCheckpoint::handleMessage(cMessage* msg)
+{
+    if (msg == checkpointTimer) {
+        writeCheckpoint(par("checkpointFile"));
+    } else {
+        error("GlobalCheckpoint::handleMessage(): Unknown message type!");
+    }
+}
+
+void GlobalCheckpoint::findModules(cModule* module, BaseOverlay*& overlay,
+                                   std::vector<DHT*>& dhts)
+{
+    for (cModule::SubmoduleIterator it(module); !it.end(); it++) {
+        cModule* submodule = it();
+
+        if (overlay == NULL) {
+            overlay = dynamic_cast<BaseOverlay*>(submodule);
+        }
+
+        DHT* dht = dynamic_cast<DHT*>(submodule);
+        if (dht != NULL) {
+            dhts.push_back(dht);
+        } else {
+            findModules(submodule, overlay, dhts);
+        }
+    }
+}
+
+void GlobalCheckpoint::writeCheckpoint(const char* fileName)
+{
+    Enter_Method_Silent();
+
+    // nodes
+    const PeerHashMap& peers = globalNodeList->getPeerHashMap();
+    std::vector<PeerHashMap::const_iterator> sortedPeers;
+    sortedPeers.reserve(peers.size());
+    for (PeerHashMap::const_iterator it = peers.begin(); it != peers.end(); it++) {
+        if (!it->second.info->isPreKilled()) {
+            sortedPeers.push_back(it);
+        }
+    }
+    std::sort(sortedPeers.begin(), sortedPeers.end(), PeerAddressLess());
+
+    UNORDERED_MAP<IPvXAddress, size_t> nodeIndex;
+    for (size_t i = 0; i < sortedPeers.size(); i++) {
+        nodeIndex[sortedPeers[i]->first] = i;
+    }
+
+    uint32_t packedKeySize = OverlayKey::getPackedSize();
+    uint32_t coordDim = 0;
+    for (size_t i = 0; i < sortedPeers.size() && coordDim == 0; i++) {
+        SimpleInfo* info = dynamic_cast<SimpleInfo*>(sortedPeers[i]->second.info);
+        if (info != NULL) {
+            coordDim = info->getEntry()->getDim();
+        }
+    }
+
+    std::vector<CheckpointNode> nodes(sortedPeers.size());
+    std::vector<unsigned char> nodeKeys(sortedPeers.size() * packedKeySize);
+    std::vector<double> coords(sortedPeers.size() * coordDim);
+    std::vector<CheckpointData> items;
+    std::vector<unsigned char> itemKeys;
+    std::string values;
+
+    for (size_t i = 0; i < sortedPeers.size(); i++) {
+        const IPvXAddress& addr = sortedPeers[i]->first;
+        PeerInfo* info = sortedPeers[i]->second.info;
+        CheckpointNode& node = nodes[i];
+
+        memset(&node, 0, sizeof(node));
+        node.ipv6 = addr.isIPv6();
+        if (node.ipv6) {
+            memcpy(node.address, addr.get6().words(), sizeof(node.address));
+        } else {
+            node.address[0] = addr.get4().getInt();
+        }
+        node.typeID = info->getTypeID();
+        node.recordIndex = -1;
+        node.latencyRow = -1;
+        node.firstData = items.size();
+
+        SimpleInfo* simpleInfo = dynamic_cast<SimpleInfo*>(info);
+        if (simpleInfo != NULL) {
+            SimpleNodeEntry* entry = simpleInfo->getEntry();
+            node.recordIndex = entry->getRecordIndex();
+            node.latencyRow = entry->getLatencyRow();
+            for (uint32_t d = 0; d < coordDim; d++) {
+                coords[i * coordDim + d] = entry->getCoords(d);
+            }
+        }
+
+        BaseOverlay* overlay = NULL;
+        std::vector<DHT*> dhts;
+        cModule* module = simulation.getModule(info->getModuleID());
+        if (module != NULL) {
+            findModules(module, overlay, dhts);
+        }
+
+        if (overlay != NULL && !overlay->getThisNode().getKey().isUnspecified()) {
+            node.hasKey = true;
+            node.port = overlay->getThisNode().getPort();
+            overlay->getThisNode().getKey().pack(&nodeKeys[i * packedKeySize]);
+        }
+
+        for (size_t d = 0; d < dhts.size(); d++) {
+            DHTDataStorage* storage = dhts[d]->getDataStorage();
+            for (DhtDataMap::iterator it = storage->begin();
+                 it != storage->end(); it++) {
+                const DhtDataEntry& entry = it->second;
+                CheckpointData item;
+                memset(&item, 0, sizeof(item));
+
+                item.valueOffset = values.size();
+                item.valueLength = entry.value.size();
+                values.append(entry.value.data(), entry.value.size());
+                item.kind = entry.kind;
+                item.id = entry.id;
+                item.isModifiable = entry.is_modifiable;
+                item.responsible = entry.responsible;
+                item.dhtIndex = d;
+                item.sourceNode = -1;
+                if (!entry.sourceNode.isUnspecified() &&
+                    nodeIndex.count(entry.sourceNode.getIp())) {
+                    item.sourceNode = nodeIndex[entry.sourceNode.getIp()];
+                }
+                if (entry.ttlMessage != NULL && entry.ttlMessage->isScheduled()) {
+                    item.ttl = SIMTIME_DBL(entry.ttlMessage->getArrivalTime()
+                                           - simTime());
+                }
+
+                items.push_back(item);
+                itemKeys.resize(itemKeys.size() + packedKeySize);
+                it->first.pack(&itemKeys[itemKeys.size() - packedKeySize]);
+            }
+        }
+        node.numData = items.size() - node.firstData;
+    }
+
+    // records of the GlobalDhtTestMap
+    std::vector<CheckpointTestEntry> testEntries;
+    std::vector<unsigned char> testEntryKeys;
+    GlobalDhtTestMap* testMap = dynamic_cast<GlobalDhtTestMap*>(
+        simulation.getModuleByPath("globalObserver.globalFunctions[0].function"));
+    if (testMap != NULL) {
+        testEntries.resize(testMap->size());
+        testEntryKeys.resize(testMap->size() * packedKeySize);
+        for (size_t i = 0; i < testMap->size(); i++) {
+            const OverlayKey& key = testMap->getKeyAt(i);
+            const DHTEntry* entry = testMap->findEntry(key);
+            CheckpointTestEntry& testEntry = testEntries[i];
+
+            memset(&testEntry, 0, sizeof(testEntry));
+            testEntry.valueOffset = values.size();
+            testEntry.valueLength = entry->value.size();
+            values.append(entry->value.data(), entry->value.size());
+            testEntry.ttl = SIMTIME_DBL(entry->endtime - simTime());
+            key.pack(&testEntryKeys[i * packedKeySize]);
+        }
+    }
+
+    // layout
+    CheckpointHeader head;
+    memset(&head, 0, sizeof(head));
+    memcpy(head.magic, CHECKPOINT_MAGIC, sizeof(head.magic));
+    head.version = CHECKPOINT_VERSION;
+    head.keyLength = OverlayKey::getLength();
+    head.packedKeySize = packedKeySize;
+    head.coordDim = coordDim;
+    head.time = SIMTIME_DBL(simTime());
+    head.numNodes = nodes.size();
+    head.numData = items.size();
+    head.numTestEntries = testEntries.size();
+
+    const void* sections[8] = { sectionData(nodes), sectionData(nodeKeys),
+                                sectionData(coords), sectionData(items),
+                                sectionData(itemKeys), sectionData(testEntries),
+                                sectionData(testEntryKeys), values.data() };
+    uint64_t sizes[8] = { nodes.size() * sizeof(CheckpointNode),
+                          nodeKeys.size(), coords.size() * sizeof(double),
+                          items.size() * sizeof(CheckpointData),
+                          itemKeys.size(),
+                          testEntries.size() * sizeof(CheckpointTestEntry),
+                          testEntryKeys.size(), values.size() };
+    uint64_t* offsets[8] = { &head.nodeOffset, &head.nodeKeyOffset,
+                             &head.coordOffset, &head.dataOffset,
+                             &head.dataKeyOffset, &head.testEntryOffset,
+                             &head.testEntryKeyOffset, &head.valueOffset };
+
+    uint64_t offset = alignOffset(sizeof(head));
+    for (int i = 0; i < 8; i++) {
+        *offsets[i] = offset;
+        offset = alignOffset(offset + sizes[i]);
+    }
+    head.fileSize = offset;
+
+    // write
+    FILE* file = fopen(fileName, "wb");
+    if (file == NULL) {
+        throw cRuntimeError("GlobalCheckpoint::writeCheckpoint(): Can't open "
+                            "file %s: %s", fileName, strerror(errno));
+    }
+
+    static const char padding[8] = { 0 };
+    bool ok = (fwrite(&head, sizeof(head), 1, file) == 1);
+    uint64_t written = sizeof(head);
+    for (int i = 0; i < 8 && ok; i++) {
+        ok = (fwrite(padding, 1, *offsets[i] - written, file) == *offsets[i] - written);
+        if (sizes[i] > 0) {
+            ok = ok && (fwrite(sections[i], 1, sizes[i], file) == sizes[i]);
+        }
+        written = *offsets[i] + sizes[i];
+    }
+    ok = ok && (fwrite(padding, 1, head.fileSize - written, file) == head.fileSize - written);
+
+    if (fclose(file) != 0 || !ok) {
+        throw cRuntimeError("GlobalCheckpoint::writeCheckpoint(): Error "
+                            "writing file %s", fileName);
+    }
+
+    EV << "[GlobalCheckpoint::writeCheckpoint()]\n"
+       << "    Wrote " << nodes.size() << " nodes, " << items.size()
+       << " data items and " << testEntries.size()
+       << " test map records to " << fileName
+       << endl;
+}
+
+void GlobalCheckpoint::openCheckpoint(const char* fileName)
+{
+    int fd = open(fileName, O_RDONLY);
+    if (fd < 0) {
+        throw cRuntimeError("GlobalCheckpoint::openCheckpoint(): Can't open "
+                            "file %s: %s", fileName, strerror(errno));
+    }
+
+    struct stat filestat;
+    if (fstat(fd, &filestat)) {
+        close(fd);
+        throw cRuntimeError("GlobalCheckpoint::openCheckpoint(): Error calling "
+                            "stat: %s", strerror(errno));
+    }
+    dataSize = filestat.st_size;
+
+    if (dataSize < sizeof(CheckpointHeader)) {
+        close(fd);
+        throw cRuntimeError("GlobalCheckpoint::openCheckpoint(): %s is not a "
+                            "checkpoint file!", fileName);
+    }
+
+#ifndef _WIN32
+    void* mapping = mmap(0, dataSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+        close(fd);
+        throw cRuntimeError("GlobalCheckpoint::openCheckpoint(): Error mapping "
+                            "file to memory: %s", strerror(errno));
+    }
+    data = (const char*)mapping;
+#else
+    char* buffer = new char[dataSize];
+    size_t numRead = 0;
+    while (numRead < dataSize) {
+        int n = read(fd, buffer + numRead, dataSize - numRead);
+        if (n <= 0) {
+            delete[] buffer;
+            close(fd);
+            throw cRuntimeError("GlobalCheckpoint::openCheckpoint(): Error "
+                                "reading %s", fileName);
+        }
+        numRead += n;
+    }
+    data = buffer;
+#endif
+    close(fd);
+
+    header = (const CheckpointHeader*)data;
+
+    if (memcmp(header->magic, CHECKPOINT_MAGIC, sizeof(header->magic)) ||
+        header->version != CHECKPOINT_VERSION ||
+        header->fileSize != dataSize) {
+        closeCheckpoint();
+        throw cRuntimeError("GlobalCheckpoint::openCheckpoint(): %s is not a "
+                            "valid checkpoint file!", fileName);
+    }
+
+    if (header->keyLength != OverlayKey::getLength() ||
+        header->packedKeySize != OverlayKey::getPackedSize()) {
+        closeCheckpoint();
+        throw cRuntimeError("GlobalCheckpoint::openCheckpoint(): The key "
+                            "length of %s doesn't match keyLength!", fileName);
+    }
+
+    if (!isConsistent()) {
+        closeCheckpoint();
+        throw cRuntimeError("GlobalCheckpoint::openCheckpoint(): %s is "
+                            "corrupt!", fileName);
+    }
+
+    EV << "[GlobalCheckpoint::openCheckpoint()]\n"
+       << "    Restoring " << header->numNodes << " nodes, "
+       << header->numData << " data items and " << header->numTestEntries
+       << " test map records from " << fileName
+       << " (t = " << header->time << "s)"
+       << endl;
+}
+
+bool GlobalCheckpoint::isConsistent() const
+{
+    uint64_t keySize = header->packedKeySize;
+
+    if (header->coordDim > dataSize / sizeof(double) ||
+        !sectionFits(header->nodeOffset, header->numNodes,
+                     sizeof(CheckpointNode), dataSize) ||
+        !sectionFits(header->nodeKeyOffset, header->numNodes, keySize,
+                     dataSize) ||
+        !sectionFits(header->coordOffset, header->numNodes,
+                     header->coordDim * sizeof(double), dataSize) ||
+        !sectionFits(header->dataOffset, header->numData,
+                     sizeof(CheckpointData), dataSize) ||
+        !sectionFits(header->dataKeyOffset, header->numData, keySize,
+                     dataSize) ||
+        !sectionFits(header->testEntryOffset, header->numTestEntries,
+                     sizeof(CheckpointTestEntry), dataSize) ||
+        !sectionFits(header->testEntryKeyOffset, header->numTestEntries,
+                     keySize, dataSize) ||
+        !sectionFits(header->valueOffset, 0, 1, dataSize)) {
+        return false;
+    }
+
+    // the values are the last section
+    uint64_t valueSize = dataSize - header->valueOffset;
+
+    for (uint64_t i = 0; i < header->numNodes; i++) {
+        const CheckpointNode& node = getNode(i);
+        if (node.firstData > header->numData ||
+            node.numData > header->numData - node.firstData) {
+            return false;
+        }
+    }
+
+    const CheckpointData* items =
+        (const CheckpointData*)(data + header->dataOffset);
+    for (uint64_t i = 0; i < header->numData; i++) {
+        if (items[i].sourceNode >= (int64_t)header->numNodes ||
+            items[i].valueOffset > valueSize ||
+            items[i].valueLength > valueSize - items[i].valueOffset) {
+            return false;
+        }
+    }
+
+    const CheckpointTestEntry* testEntries =
+        (const CheckpointTestEntry*)(data + header->testEntryOffset);
+    for (uint64_t i = 0; i < header->numTestEntries; i++) {
+        if (testEntries[i].valueOffset > valueSize ||
+            testEntries[i].valueLength > valueSize -
+                                         testEntries[i].valueOffset) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void GlobalCheckpoint::closeCheckpoint()
+{
+    if (data != NULL) {
+#ifndef _WIN32
+        munmap((void*)data, dataSize);
+#else
+        delete[] data;
+#endif
+    }
+
+    data = NULL;
+    dataSize = 0;
+    header = NULL;
+    nextNode.clear();
+    restoredNodes.clear();
+}
+
+const CheckpointNode& GlobalCheckpoint::getNode(size_t i) const
+{
+    return ((const CheckpointNode*)(data + header->nodeOffset))[i];
+}
+
+OverlayKey GlobalCheckpoint::getKey(uint64_t keyOffset, size_t i) const
+{
+    return OverlayKey::unpack((const unsigned char*)data + keyOffset +
+                              i * header->packedKeySize);
+}
+
+IPvXAddress GlobalCheckpoint::getAddress(const CheckpointNode& node) const
+{
+    if (node.ipv6) {
+        return IPv6Address(node.address[0], node.address[1],
+                           node.address[2], node.address[3]);
+    } else {
+        return IPAddress(node.address[0]);
+    }
+}
+
+bool GlobalCheckpoint::restoreNode(int32_t typeID, IPvXAddress& addr,
+                                   std::vector<double>& coords,
+                                   int32_t& recordIndex,
+                                   int32_t& latencyRow)
+{
+    if (!isRestoring() || typeID < 0) {
+        return false;
+    }
+
+    if (nextNode.size() <= (size_t)typeID) {
+        nextNode.resize(typeID + 1, 0);
+    }
+
+    size_t i = nextNode[typeID];
+    while (i < header->numNodes && getNode(i).typeID != typeID) {
+        i++;
+    }
+
+    if (i >= header->numNodes) {
+        nextNode[typeID] = i;
+        return false;
+    }
+    nextNode[typeID] = i + 1;
+
+    const CheckpointNode& node = getNode(i);
+    addr = getAddress(node);
+    recordIndex = node.recordIndex;
+    latencyRow = node.latencyRow;
+
+    const double* nodeCoords = (const double*)(data + header->coordOffset) +
+                               i * header->coordDim;
+    coords.assign(nodeCoords, nodeCoords + header->coordDim);
+
+    restoredNodes[addr] = i;
+
+    return true;
+}
+
+bool GlobalCheckpoint::restoreKey(const IPvXAddress& addr, OverlayKey& key)
+{
+    if (!isRestoring()) {
+        return false;
+    }
+
+    UNORDERED_MAP<IPvXAddress, size_t>::iterator it = restoredNodes.find(addr);
+    if (it == restoredNodes.end() || !getNode(it->second).hasKey) {
+        return false;
+    }
+
+    key = getKey(header->nodeKeyOffset, it->second);
+    return true;
+}
+
+void GlobalCheckpoint::restoreData()
+{
+    Enter_Method_Silent();
+
+    if (!isRestoring()) {
+        return;
+    }
+
+    const CheckpointData* items = (const CheckpointData*)(data + header->dataOffset);
+    const char* values = data + header->valueOffset;
+    size_t numItems = 0;
+
+    // restore in the order of the node records to keep runs reproducible
+    for (size_t i = 0; i < header->numNodes; i++) {
+        const CheckpointNode& node = getNode(i);
+        if (node.numData == 0) {
+            continue;
+        }
+
+        IPvXAddress addr = getAddress(node);
+        UNORDERED_MAP<IPvXAddress, size_t>::iterator it = restoredNodes.find(addr);
+        if (it == restoredNodes.end() || it->second != i) {
+            continue;
+        }
+
+        PeerInfo* info = globalNodeList->getPeerInfo(addr);
+        cModule* module = (info != NULL) ? simulation.getModule(info->getModuleID())
+                                         : NULL;
+        if (module == NULL) {
+            // the node has been removed during the init phase
+            continue;
+        }
+
+        BaseOverlay* overlay = NULL;
+        std::vector<DHT*> dhts;
+        findModules(module, overlay, dhts);
+
+        for (uint64_t j = node.firstData; j < node.firstData + node.numData; j++) {
+            const CheckpointData& item = items[j];
+            if (item.dhtIndex >= dhts.size()) {
+                continue;
+            }
+
+            NodeHandle sourceNode = NodeHandle::UNSPECIFIED_NODE;
+            if (item.sourceNode >= 0) {
+                const CheckpointNode& source = getNode(item.sourceNode);
+                if (source.hasKey) {
+                    sourceNode = NodeHandle(getKey(header->nodeKeyOffset,
+                                                   item.sourceNode),
+                                            getAddress(source), source.port);
+                }
+            }
+
+            const char* value = values + item.valueOffset;
+            dhts[item.dhtIndex]->restoreData(getKey(header->dataKeyOffset, j),
+                                             item.kind, item.id,
+                                             BinaryValue(value, value + item.valueLength),
+                                             item.ttl, item.isModifiable,
+                                             sourceNode, item.responsible);
+            numItems++;
+        }
+    }
+
+    GlobalDhtTestMap* testMap = dynamic_cast<GlobalDhtTestMap*>(
+        simulation.getModuleByPath("globalObserver.globalFunctions[0].function"));
+    if (testMap != NULL) {
+        const CheckpointTestEntry* testEntries =
+            (const CheckpointTestEntry*)(data + header->testEntryOffset);
+        for (size_t i = 0; i < header->numTestEntries; i++) {
+            const char* value = values + testEntries[i].valueOffset;
+            DHTEntry entry;
+            entry.value = BinaryValue(value, value + testEntries[i].valueLength);
+            entry.endtime = simTime() + testEntries[i].ttl;
+            testMap->insertEntry(getKey(header->testEntryKeyOffset, i), entry);
+        }
+    }
+
+    EV << "[GlobalCheckpoint::restoreData()]\n"
+       << "    Restored " << restoredNodes.size() << " nodes and "
+       << numItems << " data items"
+       << endl;
+
+    // nodes created after the init phase join with new keys
+    closeCheckpoint();
+}
@@ -0,0 +1,219 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file GlobalCheckpoint.h
+ * @author agent
+ */
+
+#ifndef __GLOBALCHECKPOINT_H__
+#define __GLOBALCHECKPOINT_H__
+
+#include <vector>
+#include <stdint.h>
+
+#include <omnetpp.h>
+#include <oversim_mapset.h>
+#include <IPvXAddress.h>
+#include <HashFunc.h>
+#include <OverlayKey.h>
+
+class GlobalNodeList;
+class BaseOverlay;
+class DHT;
+
+/**
+ * Header of a checkpoint file
+ *
+ * All sections are arrays of fixed size records at 8 byte aligned
+ * offsets, so a checkpoint can be used directly from a read-only
+ * memory mapping. Keys are stored with OverlayKey::pack(), so
+ * checkpoints are only portable between machines with the same byte
+ * order and word size.
+ */
+struct CheckpointHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t keyLength; /**< OverlayKey::getLength() */
+    uint32_t packedKeySize; /**< OverlayKey::getPackedSize() */
+    uint32_t coordDim; /**< dimension of the underlay coordinates, 0 if none */
+    double time; /**< simulation time of the checkpoint */
+    uint64_t numNodes;
+    uint64_t numData;
+    uint64_t numTestEntries;
+    uint64_t nodeOffset; /**< CheckpointNode[numNodes] */
+    uint64_t nodeKeyOffset; /**< packed node keys[numNodes] */
+    uint64_t coordOffset; /**< double[numNodes * coordDim] */
+    uint64_t dataOffset; /**< CheckpointData[numData], ordered by node */
+    uint64_t dataKeyOffset; /**< packed data keys[numData] */
+    uint64_t testEntryOffset; /**< CheckpointTestEntry[numTestEntries] */
+    uint64_t testEntryKeyOffset; /**< packed test map keys[numTestEntries] */
+    uint64_t valueOffset; /**< values of data items and test entries */
+    uint64_t fileSize;
+};
+
+/**
+ * A node and its underlay attachment
+ */
+struct CheckpointNode
+{
+    uint32_t address[4]; /**< IPv4 address in address[0] */
+    uint8_t ipv6;
+    uint8_t hasKey; /**< the node has an overlay with a specified key */
+    uint16_t port; /**< overlay port */
+    int32_t typeID; /**< churn generator of the node */
+    int32_t recordIndex; /**< index in the nodeCoordinateSource, or -1 */
+    uint32_t numData; /**< number of data items of this node */
+    int32_t latencyRow; /**< row in the latency matrix, or -1 */
+    uint32_t reserved;
+    uint64_t firstData; /**< index of the first data item of this node */
+};
+
+/**
+ * A data item of the DHTDataStorage of a node
+ */
+struct CheckpointData
+{
+    uint64_t valueOffset; /**< relative to CheckpointHeader::valueOffset */
+    uint32_t valueLength;
+    uint32_t kind;
+    uint32_t id;
+    uint8_t isModifiable;
+    uint8_t responsible;
+    uint16_t dhtIndex; /**< DHT module of the node (for nodes with several DHTs) */
+    int64_t sourceNode; /**< index of the source node, -1 if unspecified */
+    double ttl; /**< remaining time to live, 0 if unlimited */
+};
+
+/**
+ * A record of the GlobalDhtTestMap
+ */
+struct CheckpointTestEntry
+{
+    uint64_t valueOffset; /**< relative to CheckpointHeader::valueOffset */
+    uint32_t valueLength;
+    uint32_t reserved;
+    double ttl; /**< remaining time until the record expires */
+};
+
+/**
+ * Writes the state of all overlay nodes into a checkpoint file and
+ * restores it in later runs
+ *
+ * A checkpoint contains the underlay attachment (address, coordinates,
+ * latency matrix row) and overlay key of all nodes in the
+ * GlobalNodeList, the contents of their DHTDataStorage modules and the
+ * GlobalDhtTestMap. Pending messages and timers are not part of a
+ * checkpoint: the routing state of the restored nodes is installed by
+ * the oracle warm start of the GlobalNodeList, so restoring requires
+ * oracleWarmStart = true. All other parameters (workload, protocol
+ * timers, ...) of the restoring run may differ from those of the run
+ * that wrote the checkpoint.
+ *
+ * Restored nodes are created by the churn generators during the init
+ * phase as usual. The SimpleUnderlayConfigurator assigns the recorded
+ * address and coordinates to the next created node of the same type,
+ * BaseOverlay::join() uses the recorded key. The data items are
+ * restored when the init phase has finished.
+ *
+ * @author agent
+ */
+class GlobalCheckpoint : public cSimpleModule
+{
+  public:
+    GlobalCheckpoint();
+    ~GlobalCheckpoint();
+
+    /**
+     * Returns true, if a checkpoint is being restored
+     */
+    bool isRestoring() const { return header != NULL; };
+
+    /**
+     * Assigns the next unused recorded node of the given type to a
+     * new node
+     *
+     * @param typeID the churn generator of the new node
+     * @param addr returns the recorded address
+     * @param coords returns the recorded coordinates
+     * @param recordIndex returns the index of the coordinates
+     *                    in the nodeCoordinateSource, or -1
+     * @param latencyRow returns the row in the latency matrix, or -1
+     * @return false, if there are no unused nodes of this type left
+     */
+    bool restoreNode(int32_t typeID, IPvXAddress& addr,
+                     std::vector<double>& coords, int32_t& recordIndex,
+                     int32_t& latencyRow);
+
+    /**
+     * Returns the recorded overlay key of a restored node
+     *
+     * @param addr the address of the node
+     * @param key returns the key
+     * @return false, if the node wasn't restored from the checkpoint
+     */
+    bool restoreKey(const IPvXAddress& addr, OverlayKey& key);
+
+    /**
+     * Restores the DHT data items of all restored nodes and the
+     * GlobalDhtTestMap, called when the init phase has finished
+     */
+    void restoreData();
+
+  protected:
+    virtual void initialize();
+    virtual void handleMessage(cMessage* msg);
+
+  private:
+    /** writes the current state to fileName */
+    void writeCheckpoint(const char* fileName);
+
+    /** maps fileName and checks the header */
+    void openCheckpoint(const char* fileName);
+    void closeCheckpoint();
+
+    /**
+     * checks that all sections and the records referring to other
+     * records or values lie within the mapped file
+     */
+    bool isConsistent() const;
+
+    /** returns the overlay and DHT modules of a node */
+    void findModules(cModule* module, BaseOverlay*& overlay,
+                     std::vector<DHT*>& dhts);
+
+    const CheckpointNode& getNode(size_t i) const;
+    OverlayKey getKey(uint64_t keyOffset, size_t i) const;
+    IPvXAddress getAddress(const CheckpointNode& node) const;
+
+    GlobalNodeList* globalNodeList;
+    cMessage* checkpointTimer;
+
+    const char* data; /**< mapped checkpoint file */
+    size_t dataSize;
+    const CheckpointHeader* header; /**< NULL, if not restoring */
+
+    /** next node record to check for each type */
+    std::vector<size_t> nextNode;
+
+    /** node records of restored nodes */
+    UNORDERED_MAP<IPvXAddress, size_t> restoredNodes;
+};
+
+#endif
@@ -33,6 +33,8 @@
 #include <GlobalStatisticsAccess.h>
 #include <hashWatch.h>
 #include <BootstrapList.h>
+#include <UnderlayConfiguratorAccess.h>
+#include <OracleRing.h>
 
 #include "GlobalNodeList.h"
 
@@ -63,6 +65,7 @@ void GlobalNodeList::initialize()
     maxNumberOfKeys = par("maxNumberOfKeys");
     keyProbability = par("keyProbability");
     isKeyListInitialized = false;
+    oracleWarmStart = par("oracleWarmStart");
     WATCH_UNORDERED_MAP(peerStorage.getPeerHashMap());
     WATCH_VECTOR(keyList);
     WATCH(landmarkPeerSize);
@@ -99,6 +102,47 @@ void GlobalNodeList::initialize()
     scheduleAt(simTime(), timer);
 }
 
+bool GlobalNodeList::deferJoin(BaseOverlay* overlay)
+{
+    if (!oracleWarmStart ||
+        !UnderlayConfiguratorAccess().get()->isInInitPhase()) {
+        return false;
+    }
+
+    warmStartOverlays.push_back(overlay->getId());
+    return true;
+}
+
+void GlobalNodeList::warmStart()
+{
+    Enter_Method_Silent();
+
+    std::vector<BaseOverlay*> overlays;
+    std::vector<NodeHandle> nodes;
+
+    // nodes may have been removed during the init phase
+    for (size_t i = 0; i < warmStartOverlays.size(); i++) {
+        BaseOverlay* overlay =
+            dynamic_cast<BaseOverlay*>(simulation.getModule(warmStartOverlays[i]));
+        if (overlay != NULL) {
+            overlays.push_back(overlay);
+            nodes.push_back(overlay->getThisNode());
+        }
+    }
+    warmStartOverlays.clear();
+
+    if (overlays.empty()) {
+        return;
+    }
+
+    OracleRing ring(nodes);
+
+    for (size_t i = 0; i < overlays.size(); i++) {
+        overlays[i]->joinWarmStart(ring,
+                                   ring.lowerBound(overlays[i]->getThisNode().getKey()));
+    }
+}
+
 void GlobalNodeList::handleMessage(cMessage* msg)
 {
     if (msg->isName("maliciousNodeChange")) {
@@ -37,6 +37,7 @@
 #include <PeerStorage.h>
 
 class BootstrapList;
+class BaseOverlay;
 class TransportAddress;
 class OverlayKey;
 class GlobalStatistics;
@@ -144,6 +145,22 @@ public:
      */
     virtual void removePeer(const TransportAddress& peer);
 
+    /**
+     * Defers the join of overlay until the init phase has finished,
+     * if oracleWarmStart is enabled
+     *
+     * @param overlay the overlay module that is about to join
+     * @return true, if the join is deferred
+     */
+    bool deferJoin(BaseOverlay* overlay);
+
+    /**
+     * Installs the converged routing state of all deferred overlays,
+     * which is computed from the sorted set of their keys. Called at
+     * the end of the init phase by the UnderlayConfigurator.
+     */
+    void warmStart();
+
     /**
      * Returns a keylist
      *
@@ -229,6 +246,11 @@ public:
 
     size_t getNumNodes() { return peerStorage.size(); };
 
+    /**
+     * Returns all nodes of the peerSet (used by GlobalCheckpoint)
+     */
+    const PeerHashMap& getPeerHashMap() { return peerStorage.getPeerHashMap(); };
+
     bool areNodeTypesConnected(int32_t a, int32_t b);
     void connectNodeTypes(int32_t a, int32_t b);
     void disconnectNodeTypes(int32_t a, int32_t b);
@@ -271,6 +293,9 @@ protected:
     double keyProbability; /**< probability of keys to be owned by nodes */
     bool isKeyListInitialized;
 
+    bool oracleWarmStart; /**< install converged routing state after the init phase */
+    std::vector<int> warmStartOverlays; /**< module ids of the overlays with deferred joins */
+
 private:
     GlobalStatistics* globalStatistics; /**< pointer to GlobalStatistics module in this node */
     bool connectionMatrix[MAX_NODETYPES][MAX_NODETYPES]; /**< matrix specifices with node types (partitions) can communication */
@@ -21,8 +21,13 @@
  * @author IngmarBaumgart
  */
 
+#include <algorithm>
+
 #include <omnetpp.h>
 
+#include <MemoryReport.h>
+#include <EventProfiler.h>
+
 #include "GlobalStatistics.h"
 
 Define_Module(GlobalStatistics);
@@ -38,6 +43,7 @@ void GlobalStatistics::initialize()
 
     measuring = par("measureNetwInitPhase");
     measureStartTime = 0;
+    gettimeofday(&initWallClock, NULL);
 
     currentDeliveryVector.setName("Current Delivery Ratio");
 
@@ -49,6 +55,19 @@ void GlobalStatistics::initialize()
         scheduleAt(simTime() + globalStatTimerInterval, globalStatTimer);
     }
 
+    // start periodic memoryStatTimer
+    memoryStatInterval = par("memoryStatInterval");
+
+    if (memoryStatInterval > 0) {
+        memoryStatTimer = new cMessage("memoryStatTimer");
+        scheduleAt(simTime() + memoryStatInterval, memoryStatTimer);
+    }
+
+    // profile wall clock time of the message handlers
+    if (par("profileEvents")) {
+        EventProfiler::start();
+    }
+
     WATCH(measuring);
     WATCH(measureStartTime);
     WATCH(currentDeliveryVector);
@@ -88,9 +107,87 @@ void GlobalStatistics::handleMessage(cMessage* msg)
         return;
     }
 
+    if (msg == memoryStatTimer) {
+        scheduleAt(simTime() + memoryStatInterval, msg);
+        sampleMemory();
+        return;
+    }
+
     error("GlobalStatistics::handleMessage(): Unknown message type!");
 }
 
+void GlobalStatistics::sampleMemory()
+{
+    MemoryReport report;
+    const cModule* systemModule = simulation.getSystemModule();
+
+    // reports are accounted to the top level module containing the reporter
+    MemoryReporter::Reporters& reporters = MemoryReporter::getReporters();
+    for (MemoryReporter::Reporters::iterator it = reporters.begin();
+            it != reporters.end(); ++it) {
+        const cModule* node = dynamic_cast<cModule*>(*it);
+        while (node != NULL && node->getParentModule() != systemModule) {
+            node = node->getParentModule();
+        }
+        report.setNode(node);
+        (*it)->reportMemory(report);
+    }
+
+    // messages in the future event set (timers and packets in flight)
+    cMessageHeap& fes = simulation.msgQueue;
+    for (int i = 0; i < fes.getLength(); i++) {
+        cMessage* msg = fes.peek(i);
+        const cModule* node = simulation.getModule(msg->getArrivalModuleId());
+        while (node != NULL && node->getParentModule() != systemModule) {
+            node = node->getParentModule();
+        }
+        report.setNode(node);
+        report.add("FES: messages", 1, MemoryReport::messageBytes(msg));
+    }
+
+    // sum up all components and nodes
+    std::map<std::string, MemoryReport::Usage> totals;
+    const MemoryReport::NodeUsageMap& nodeUsage = report.getNodeUsage();
+
+    for (MemoryReport::NodeUsageMap::const_iterator nodeIt =
+            nodeUsage.begin(); nodeIt != nodeUsage.end(); ++nodeIt) {
+        MemoryReport::Usage nodeTotal;
+
+        for (MemoryReport::UsageMap::const_iterator it =
+                nodeIt->second.begin(); it != nodeIt->second.end(); ++it) {
+            MemoryStat*& stat = memoryStatMap[it->first];
+            if (stat == NULL) {
+                stat = new MemoryStat(it->first);
+            }
+            stat->nodeObjects.collect(it->second.objects);
+            stat->nodeBytes.collect(it->second.bytes);
+
+            totals[it->first].objects += it->second.objects;
+            totals[it->first].bytes += it->second.bytes;
+            nodeTotal.objects += it->second.objects;
+            nodeTotal.bytes += it->second.bytes;
+        }
+
+        MemoryStat*& stat = memoryStatMap["Total"];
+        if (stat == NULL) {
+            stat = new MemoryStat("Total");
+        }
+        stat->nodeObjects.collect(nodeTotal.objects);
+        stat->nodeBytes.collect(nodeTotal.bytes);
+
+        totals["Total"].objects += nodeTotal.objects;
+        totals["Total"].bytes += nodeTotal.bytes;
+    }
+
+    for (std::map<std::string, MemoryReport::Usage>::iterator it =
+            totals.begin(); it != totals.end(); ++it) {
+        MemoryStat* stat = memoryStatMap[it->first];
+        stat->objectsVector.record(it->second.objects);
+        stat->bytesVector.record(it->second.bytes);
+        stat->maxBytes = std::max(stat->maxBytes, it->second.bytes);
+    }
+}
+
 void GlobalStatistics::finish()
 {
     // Here, the FinisherModule is created which will get destroyed at last.
@@ -106,6 +203,22 @@ void GlobalStatistics::finalizeStatistics()
 {
     recordScalar("GlobalStatistics: Simulation Time", simTime());
 
+    recordScalar("GlobalStatistics: Events", simulation.getEventNumber());
+
+    // simulator performance for benchmark.ini, not recorded by default
+    // since it differs between identical runs
+    if (par("recordWallClockTime")) {
+        struct timeval now, diff;
+        gettimeofday(&now, NULL);
+        diff = timeval_substract(now, initWallClock);
+        double wallClockTime = diff.tv_sec + diff.tv_usec / 1000000.0;
+        recordScalar("GlobalStatistics: Wall Clock Time", wallClockTime);
+        if (wallClockTime > 0) {
+            recordScalar("GlobalStatistics: Events/s",
+                         simulation.getEventNumber() / wallClockTime);
+        }
+    }
+
     bool outputMinMax = par("outputMinMax");
     bool outputStdDev = par("outputStdDev");
 
@@ -133,12 +246,52 @@ void GlobalStatistics::finalizeStatistics()
         recordStatistic(n.c_str(), iter->second);
     }
 
+    static const double percentiles[] = { 50, 90, 95, 99, 99.9 };
+    static const char* percentileNames[] = { ".p50", ".p90", ".p95",
+                                             ".p99", ".p99.9" };
+
+    for (map<std::string, LogHistogram*>::iterator iter =
+            percentileMap.begin(); iter != percentileMap.end(); iter++) {
+        const std::string& n = iter->first;
+        const LogHistogram& h = *(iter->second);
+
+        if (h.getCount() == 0) continue;
+
+        recordScalar((n + ".count").c_str(), (double)h.getCount());
+        for (size_t i = 0; i < sizeof(percentiles) / sizeof(double); i++) {
+            recordScalar((n + percentileNames[i]).c_str(),
+                         h.getPercentile(percentiles[i]));
+        }
+        recordScalar((n + ".max").c_str(), h.getMax());
+    }
+
     for (map<std::string, OutVector*>::iterator iter = outVectorMap.begin();
     iter != outVectorMap.end(); iter++) {
         const OutVector& ov = *(iter->second);
         double mean = ov.count > 0 ? ov.value / ov.count : 0;
         recordScalar(("Vector: " + iter->first + ".mean").c_str(), mean);
     }
+
+    // memory usage per node and peak memory usage of all nodes
+    for (map<std::string, MemoryStat*>::iterator iter = memoryStatMap.begin();
+            iter != memoryStatMap.end(); iter++) {
+        const std::string n = "Memory: " + iter->first;
+        const MemoryStat& stat = *(iter->second);
+
+        recordScalar((n + " objects per node.mean").c_str(),
+                     stat.nodeObjects.getMean());
+        recordScalar((n + " objects per node.max").c_str(),
+                     stat.nodeObjects.getMax());
+        recordScalar((n + " bytes per node.mean").c_str(),
+                     stat.nodeBytes.getMean());
+        recordScalar((n + " bytes per node.max").c_str(),
+                     stat.nodeBytes.getMax());
+        recordScalar((n + " bytes.max").c_str(), stat.maxBytes);
+    }
+
+    if (EventProfiler::isEnabled()) {
+        EventProfiler::stop(par("profileFilePrefix").stdstringValue());
+    }
 }
 
 void GlobalStatistics::addStdDev(const std::string& name, double value)
@@ -181,6 +334,41 @@ void GlobalStatistics::recordHistogram(const std::string& name, double value)
     h->collect(value);
 }
 
+LogHistogram* GlobalStatistics::getPercentileHistogram(const std::string& name)
+{
+    std::map<std::string, LogHistogram*>::iterator pPos =
+        percentileMap.find(name);
+
+    if (pPos != percentileMap.end()) {
+        return pPos->second;
+    }
+
+    LogHistogram* h = new LogHistogram;
+    percentileMap.insert(make_pair(name, h));
+
+    return h;
+}
+
+void GlobalStatistics::recordPercentiles(const std::string& name,
+                                         double value)
+{
+    if (!measuring) {
+        return;
+    }
+
+    getPercentileHistogram(name)->record(value);
+}
+
+void GlobalStatistics::mergePercentiles(const std::string& name,
+                                        const LogHistogram& histogram)
+{
+    if (histogram.getCount() == 0) {
+        return;
+    }
+
+    getPercentileHistogram(name)->merge(histogram);
+}
+
 void GlobalStatistics::recordOutVector(const std::string& name, double value)
 {
     if (!measuring) {
@@ -230,5 +418,19 @@ GlobalStatistics::~GlobalStatistics()
         delete iter->second;
     }
     histogramMap.clear();
+
+    for (map<std::string, LogHistogram*>::iterator iter =
+            percentileMap.begin(); iter != percentileMap.end(); iter++) {
+        delete iter->second;
+    }
+    percentileMap.clear();
+
+    for (map<std::string, MemoryStat*>::iterator iter =
+            memoryStatMap.begin(); iter != memoryStatMap.end(); iter++) {
+        delete iter->second;
+    }
+    memoryStatMap.clear();
+
+    cancelAndDelete(memoryStatTimer);
 }
 
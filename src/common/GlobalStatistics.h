@@ -28,6 +28,7 @@
 
 #include <omnetpp.h>
 #include <BinaryValue.h>
+#include <LogHistogram.h>
 
 class OverlayKey;
 
@@ -82,6 +83,8 @@ public:
     cOutVector currentDeliveryVector; //!< statistical output vector for current delivery ratio
     SearchStat bcastSearch;
 
+    GlobalStatistics() : memoryStatTimer(NULL) {};
+
     /**
      * Destructor
      */
@@ -102,6 +105,33 @@ public:
      */
     void recordHistogram(const std::string& name, double value);
 
+    /**
+     * Add a value to the LogHistogram specified by the name parameter.
+     * The 50th, 90th, 95th, 99th and 99.9th percentile of all values
+     * are recorded as scalars at the end of the simulation.
+     *
+     * @param name a string to identify the histogram (should be "Module: Scalar Name")
+     * @param value the value to add
+     */
+    void recordPercentiles(const std::string& name, double value);
+
+    /**
+     * Merge a per-node LogHistogram into the LogHistogram specified by
+     * the name parameter (see recordPercentiles())
+     *
+     * @param name a string to identify the histogram (should be "Module: Scalar Name")
+     * @param histogram the histogram to add
+     */
+    void mergePercentiles(const std::string& name,
+                          const LogHistogram& histogram);
+
+    /**
+     * Returns the LogHistogram for name, which is created if needed
+     *
+     * @param name a string to identify the histogram (should be "Module: Scalar Name")
+     */
+    LogHistogram* getPercentileHistogram(const std::string& name);
+
     /**
      * Record a value to a global cOutVector defined by name
      *
@@ -134,10 +164,35 @@ protected:
 
     std::map<std::string, cStdDev*> stdDevMap; //!< map to store and access scalars
     std::map<std::string, cHistogram*> histogramMap; //!< map to store and access histograms
+    std::map<std::string, LogHistogram*> percentileMap; //!< map to store and access histograms for percentiles
     std::map<std::string, OutVector*> outVectorMap; //!< map to store and access the output vectors
     cMessage* globalStatTimer; //!< timer for periodic statistic updates
     double globalStatTimerInterval; //!< interval length of periodic statistic timer
 
+    struct MemoryStat //!< memory usage of a component
+    {
+        cOutVector objectsVector; //!< live objects of all nodes
+        cOutVector bytesVector; //!< estimated bytes of all nodes
+        cStdDev nodeObjects; //!< live objects per node of all samples
+        cStdDev nodeBytes; //!< estimated bytes per node of all samples
+        double maxBytes; //!< maximum of bytesVector
+
+        MemoryStat(const std::string& name) :
+            objectsVector(("Memory: " + name + " objects").c_str()),
+            bytesVector(("Memory: " + name + " bytes").c_str()),
+            maxBytes(0) {};
+    };
+
+    std::map<std::string, MemoryStat*> memoryStatMap; //!< memory usage of all components
+    cMessage* memoryStatTimer; //!< timer for memory usage samples
+    double memoryStatInterval; //!< interval between memory usage samples
+
+    /**
+     * Collects the memory usage of all MemoryReporters and of the
+     * messages in the future event set
+     */
+    void sampleMemory();
+
     /**
      * Init member function of module
      */
@@ -155,6 +210,7 @@ protected:
 
     bool measuring;
     simtime_t measureStartTime;
+    struct timeval initWallClock; //!< wall clock time of initialize()
 };
 
 #endif
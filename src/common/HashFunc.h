@@ -29,6 +29,7 @@
 
 #include <IPvXAddress.h>
 #include <TransportAddress.h>
+#include <BinaryValue.h>
 
 #if defined(HAVE_GCC_TR1) || defined(HAVE_MSVC_TR1)
 namespace std { namespace tr1 {
@@ -87,6 +88,23 @@ template<> struct hash<TransportAddress> : std::unary_function<TransportAddress,
     }
 };
 
+/**
+ * defines a hash function for BinaryValue
+ */
+template<> struct hash<BinaryValue> : std::unary_function<BinaryValue, std::size_t>
+{
+    /**
+     * hash function for BinaryValue
+     *
+     * @param value the BinaryValue to hash
+     * @return the hashed BinaryValue
+     */
+    std::size_t operator()(const BinaryValue& value) const
+    {
+        return value.hash();
+    }
+};
+
 }
 #if defined(HAVE_GCC_TR1) || defined(HAVE_MSVC_TR1)
 }
@@ -29,6 +29,7 @@
 #include <LookupListener.h>
 #include <BaseOverlay.h>
 #include <GlobalStatistics.h>
+#include <BatchLookup.h>
 
 #include "IterativeLookup.h"
 
@@ -79,7 +80,8 @@ firstCallExt(NULL),
 finished(false),
 success(false),
 running(false),
-appLookup(appLookup)
+appLookup(appLookup),
+batch(NULL)
 {
     if (findNodeExt) firstCallExt = static_cast<cPacket*>(findNodeExt->dup());
 
@@ -253,10 +255,22 @@ void IterativeLookup::stop()
         success |= paths[i]->success;
     }
 
+    // cancel hedge timers
+    for (HedgeTimers::iterator i = hedgeTimers.begin();
+         i != hedgeTimers.end(); i++) {
+        overlay->cancelAndDelete(*i);
+    }
+    hedgeTimers.clear();
+    hedges.clear();
+
     // cancel pending rpcs
-    for (RpcInfoMap::iterator i = rpcs.begin(); i != rpcs.end(); i++) {
+    if (batch != NULL) {
+        batch->cancelFindNodeCalls(this);
+    } else {
+        for (RpcInfoMap::iterator i = rpcs.begin(); i != rpcs.end(); i++) {
 //	std::cout << "time: " << simTime()     << " node: " << overlay->thisNode 	  << " this: " << this << " first: " << i->first  << " nonce: " << i->second.nonce << endl;
-        overlay->cancelRpcMessage(i->second.nonce);
+            overlay->cancelRpcMessage(i->second.nonce);
+        }
     }
     rpcs.clear();
 
@@ -343,6 +357,13 @@ inline void IterativeLookup::checkStop()
             listener = oldListener;
             start();
         } else {
+            if (success && overlay->globalStatistics->isMeasuring()) {
+                overlay->lookupDurationHistogram.record(
+                    SIMTIME_DBL(simTime() - startTime));
+                overlay->lookupHopHistogram.record(
+                    overlay->isCountAccumulatedHops() ?
+                    getAccumulatedHops() : getMinHops());
+            }
             delete this;
         }
     }
@@ -514,6 +535,11 @@ void IterativeLookup::handleRpcResponse(BaseResponseMessage* msg,
         if (rpcs.count(src) == 0)
             return;
 
+        // cancel the other rpc of hedged pairs
+        if (hedges.size() > 0) {
+            finishHedges(src, true);
+        }
+
         // get info
         RpcInfoVector infos = rpcs[src];
         rpcs.erase(src);
@@ -610,6 +636,13 @@ void IterativeLookup::handleRpcTimeout(BaseCallMessage* msg,
     RpcInfoVector infos = rpcs[dest];
     rpcs.erase(dest);
 
+    if (hedges.size() > 0) {
+        finishHedges(dest, false);
+    }
+
+    // cached lookup results containing the node are no longer valid
+    overlay->lookupCache.removeNode(dest);
+
     // mark the node as dead
     for (uint32_t i=0; i < infos.size(); i++) {
     	const RpcInfo& info = infos[i];
@@ -671,6 +704,15 @@ void IterativeLookup::sendRpc(const NodeHandle& handle, FindNodeCall* call,
     if (rpcs.count(handle) == 0) {
         RpcInfoVector newVector;
 
+        if (batch != NULL) {
+            // the batch lookup sends (and counts) the call
+            newVector.nonce = 0;
+            rpcs[handle] = newVector;
+            rpcs[handle].push_back(info);
+            batch->queueFindNodeCall(this, handle, call);
+            return;
+        }
+
         overlay->countFindNodeCall(call);
         newVector.nonce = overlay->sendUdpRpcCall(handle, call, NULL,
                                                   -1, 0, -1, this);
@@ -688,6 +730,132 @@ void IterativeLookup::sendRpc(const NodeHandle& handle, FindNodeCall* call,
     rpcs[handle].push_back(info);
 }
 
+void IterativeLookup::cancelRpc(const TransportAddress& dest,
+                                IterativePathLookup* path)
+{
+    RpcInfoMap::iterator it = rpcs.find(dest);
+    if (it == rpcs.end())
+        return;
+
+    RpcInfoVector& infos = it->second;
+    for (RpcInfoVector::iterator i = infos.begin(); i != infos.end();) {
+        if (i->path == path) {
+            i = infos.erase(i);
+            path->pendingRpcs--;
+            path->oldNextHops.erase(dest);
+        } else {
+            i++;
+        }
+    }
+
+    // other paths still wait for the response?
+    if (infos.size() == 0) {
+        overlay->cancelRpcMessage(infos.nonce);
+        rpcs.erase(it);
+    }
+}
+
+//----------------------------------------------------------------------------
+//- Hedged RPCs --------------------------------------------------------------
+//----------------------------------------------------------------------------
+void IterativeLookup::scheduleHedge(const NodeHandle& dest,
+                                    IterativePathLookup* path,
+                                    int rpcId, cPacket* findNodeExt)
+{
+    // the batch lookup sends our calls, so they can't be cancelled
+    if (batch != NULL || finished || !running)
+        return;
+
+    simtime_t delay = overlay->neighborCache->getRttPercentile95(dest);
+    if (delay == -1) {
+        delay = config.hedgeDelay;
+    }
+
+    IterativeLookupHedgeTimer* timer = new IterativeLookupHedgeTimer();
+    timer->lookup = this;
+    timer->path = path;
+    timer->dest = dest;
+    timer->rpcId = rpcId;
+    timer->sendTime = simTime();
+    if (findNodeExt) {
+        timer->findNodeExt = static_cast<cPacket*>(findNodeExt->dup());
+    }
+
+    hedgeTimers.insert(timer);
+    overlay->scheduleAt(simTime() + delay, timer);
+}
+
+void IterativeLookup::handleHedgeTimer(IterativeLookupHedgeTimer* timer)
+{
+    hedgeTimers.erase(timer);
+
+    IterativePathLookup* path = timer->path;
+    bool pending = false;
+
+    // still waiting for the original rpc and no progress since?
+    RpcInfoMap::iterator it = rpcs.find(timer->dest);
+    if (running && !finished && !path->finished && path->step == timer->rpcId
+            && it != rpcs.end()) {
+        for (uint32_t i = 0; i < it->second.size(); i++) {
+            if (it->second[i].path == path) {
+                pending = true;
+                break;
+            }
+        }
+    }
+
+    if (pending) {
+        NodeHandle hedge = path->sendHedgedRpc(timer->findNodeExt);
+
+        if (!hedge.isUnspecified()) {
+            HedgeInfo info;
+            info.path = path;
+            info.primary = timer->dest;
+            info.hedge = hedge;
+            info.deadline = timer->sendTime +
+                overlay->getUdpTimeout(timer->dest);
+            hedges.push_back(info);
+
+            if (overlay->globalStatistics->isMeasuring()) {
+                overlay->numHedgedRpcs++;
+            }
+        }
+    }
+
+    delete timer;
+}
+
+void IterativeLookup::finishHedges(const TransportAddress& src, bool response)
+{
+    for (Hedges::iterator it = hedges.begin(); it != hedges.end();) {
+        if (it->primary != src && it->hedge != src) {
+            it++;
+            continue;
+        }
+
+        HedgeInfo info = *it;
+        it = hedges.erase(it);
+
+        if (!response || info.path->finished) {
+            continue;
+        }
+
+        if (src == info.hedge) {
+            // the hedge won: compared to the lookup without hedging,
+            // which only reacts to the timeout of the original rpc
+            if (overlay->globalStatistics->isMeasuring()) {
+                simtime_t saved = info.deadline - simTime();
+                overlay->numHedgeWins++;
+                overlay->hedgeSavedHistogram.record(
+                    saved > 0 ? SIMTIME_DBL(saved) : 0);
+            }
+            cancelRpc(info.primary, info.path);
+        } else {
+            cancelRpc(info.hedge, info.path);
+        }
+    }
+}
+
 //----------------------------------------------------------------------------
 //- AbstractLookup implementation --------------------------------------------
 //----------------------------------------------------------------------------
@@ -1116,6 +1284,10 @@ void IterativePathLookup::sendRpc(int num, cPacket* findNodeExt)
             lookup->sendRpc(it->handle, call, this, step);
             oldNextHops[it->handle] = it->source;
 
+            if (lookup->config.hedgedRpcs) {
+                lookup->scheduleHedge(it->handle, this, step, findNodeExt);
+            }
+
             //cout << "Sending RPC to " << it->handle
             //     << " ( " << num << " more )"
             //     << " thisNode = " << lookup->overlay->getThisNode().getKey() << endl;
@@ -1169,6 +1341,30 @@ void IterativePathLookup::sendRpc(int num, cPacket* findNodeExt)
     //cout << endl;
 }
 
+NodeHandle IterativePathLookup::sendHedgedRpc(cPacket* findNodeExt)
+{
+    LookupEntry* it;
+    for (int i = 0; i < lookup->config.redundantNodes; i++) {
+        it = getNextEntry();
+        if (it == NULL)
+           break;
+
+        // mark node as already used
+        it->alreadyUsed = true;
+
+        if ((!lookup->config.visitOnlyOnce) || (!lookup->getVisited(it->handle))) {
+            pendingRpcs++;
+            FindNodeCall* call = lookup->createFindNodeCall(findNodeExt);
+            lookup->sendRpc(it->handle, call, this, step);
+            oldNextHops[it->handle] = it->source;
+
+            return it->handle;
+        }
+    }
+
+    return NodeHandle::UNSPECIFIED_NODE;
+}
+
 LookupEntry* IterativePathLookup::getNextEntry()
 {
     for (LookupVector::iterator it = nextHops.begin();it != nextHops.end();it++) {
@@ -24,6 +24,7 @@
 #ifndef __ITERATIVE_LOOKUP_H
 #define __ITERATIVE_LOOKUP_H
 
+#include <set>
 #include <vector>
 #include <oversim_mapset.h>
 
@@ -40,6 +41,7 @@ class LookupListener;
 class IterativeLookup;
 class IterativePathLookup;
 class BaseOverlay;
+class BatchLookup;
 
 static const double LOOKUP_TIMEOUT = 10.0;
 
@@ -69,6 +71,27 @@ struct KeyExtractor<LookupEntry> {
     };
 };
 
+/**
+ * Timer of a hedged RPC, which is sent if the RPC of a path to dest
+ * is not answered in time (see IterativeLookupConfiguration::hedgedRpcs)
+ */
+class IterativeLookupHedgeTimer : public cMessage
+{
+public:
+    IterativeLookup* lookup;
+    IterativePathLookup* path;
+    TransportAddress dest; /**< destination of the original RPC */
+    int rpcId; /**< lookup step of the original RPC */
+    simtime_t sendTime; /**< time the original RPC has been sent */
+    cPacket* findNodeExt; /**< extension of the original RPC */
+
+    IterativeLookupHedgeTimer() : cMessage("IterativeLookupHedgeTimer"),
+                                  lookup(NULL), path(NULL), rpcId(0),
+                                  findNodeExt(NULL) {};
+
+    ~IterativeLookupHedgeTimer() { delete findNodeExt; };
+};
+
 /**
  * This class implements a basic greedy lookup strategy.
  *
@@ -84,6 +107,7 @@ class IterativeLookup : public RpcListener,
 {
     friend class IterativePathLookup;
     friend class BaseOverlay;
+    friend class BatchLookup;
 
 protected:
     /**
@@ -129,6 +153,7 @@ protected:
     bool appLookup;
     SimTime startTime;              /**< time at which the lookup was started */
     Downlist downlist;
+    BatchLookup* batch;             /**< batch lookup which coalesces our FindNodeCalls (optional) */
 
 public://virtual methods: comparator induced by distance in BaseOverlay
     /**
@@ -251,6 +276,65 @@ protected://methods: rpc distribution
     void sendRpc(const NodeHandle& handle, FindNodeCall* call,
                  IterativePathLookup* listener, int rpcId);
 
+    /**
+     * Cancels the RPC of a path to dest, the RPC message is only
+     * cancelled if no other path waits for its response
+     *
+     * @param dest the destination of the RPC
+     * @param path the path
+     */
+    void cancelRpc(const TransportAddress& dest, IterativePathLookup* path);
+
+    //-------------------------------------------------------------------------
+    //- Hedged RPCs -----------------------------------------------------------
+    //-------------------------------------------------------------------------
+protected://fields and classes: hedged rpcs
+
+    class HedgeInfo
+    {
+    public:
+        IterativePathLookup* path;
+        TransportAddress primary; /**< destination of the original RPC */
+        TransportAddress hedge; /**< destination of the hedged RPC */
+        simtime_t deadline; /**< timeout of the original RPC */
+    };
+
+    typedef std::vector<HedgeInfo> Hedges;
+    Hedges hedges; /**< pending pairs of original and hedged RPCs */
+
+    typedef std::set<IterativeLookupHedgeTimer*> HedgeTimers;
+    HedgeTimers hedgeTimers; /**< scheduled hedge timers */
+
+protected://methods: hedged rpcs
+    /**
+     * Schedules a hedged RPC for the RPC of path to dest after the
+     * 95th percentile of the RTT to dest
+     *
+     * @param dest the destination of the RPC
+     * @param path the path which sent the RPC
+     * @param rpcId the lookup step of the RPC
+     * @param findNodeExt extension of the RPC (copied)
+     */
+    void scheduleHedge(const NodeHandle& dest, IterativePathLookup* path,
+                       int rpcId, cPacket* findNodeExt);
+
+    /**
+     * Sends a hedged RPC, if the original RPC is still pending and the
+     * path has not made any progress
+     *
+     * @param timer the timer (deleted)
+     */
+    void handleHedgeTimer(IterativeLookupHedgeTimer* timer);
+
+    /**
+     * Finishes all hedged RPC pairs with an RPC to src. On a response,
+     * the other RPC of the pair is cancelled.
+     *
+     * @param src the node which answered or timed out
+     * @param response true, if src answered
+     */
+    void finishHedges(const TransportAddress& src, bool response);
+
     //-------------------------------------------------------------------------
     //- Construction & Destruction --------------------------------------------
     //-------------------------------------------------------------------------
@@ -261,6 +345,13 @@ public://construction & destruction
 
     virtual ~IterativeLookup();
 
+    /**
+     * Lets a BatchLookup send the FindNodeCalls of this lookup
+     *
+     * @param batch the batch lookup this lookup belongs to
+     */
+    void setBatch(BatchLookup* batch) { this->batch = batch; };
+
 protected:
     void start();
     void stop();
@@ -319,6 +410,14 @@ protected://methods: rpc handling
 private:
     void sendRpc(int num, cPacket* FindNodeExt = NULL);
 
+    /**
+     * Sends one RPC to the next unvisited node, independent of
+     * config.strictParallelRpcs
+     *
+     * @return the node the RPC was sent to or UNSPECIFIED_NODE
+     */
+    NodeHandle sendHedgedRpc(cPacket* findNodeExt);
+
     void sendNewRpcAfterTimeout(cPacket* findNodeExt);
 
 protected:
@@ -46,6 +46,8 @@ public:
     bool failedNodeRpcs; /**< communicate failed nodes */
     bool visitOnlyOnce; /**< if true, the same node is never asked twice during a single lookup */
     bool acceptLateSiblings; /**< if true, a FindNodeResponse with sibling flag set is always accepted, even if it is from a previous lookup step */
+    bool hedgedRpcs; /**< send one extra RPC, if an RPC is not answered within the 95th percentile of the RTT to its destination */
+    double hedgeDelay; /**< delay of hedged RPCs to nodes without measured RTT */
 };
 
 #endif
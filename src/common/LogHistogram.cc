@@ -0,0 +1,141 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file LogHistogram.cc
+ * @author agent
+ */
+
+#include <cmath>
+#include <algorithm>
+
+#include "LogHistogram.h"
+
+LogHistogram::LogHistogram()
+{
+    clear();
+}
+
+void LogHistogram::clear()
+{
+    buckets.clear();
+    firstIndex = 0;
+    zeroCount = 0;
+    count = 0;
+    sum = 0;
+    min = 0;
+    max = 0;
+}
+
+int LogHistogram::getIndex(double value) const
+{
+    int exp;
+    double mantissa = frexp(value, &exp); // value = mantissa * 2^exp
+
+    int sub = (int)((mantissa - 0.5) * 2 * SUB_BUCKETS);
+    if (sub >= SUB_BUCKETS) sub = SUB_BUCKETS - 1;
+
+    return exp * SUB_BUCKETS + sub;
+}
+
+double LogHistogram::getValue(int index) const
+{
+    int exp = (index >= 0) ? (index / SUB_BUCKETS) :
+                             -((-index + SUB_BUCKETS - 1) / SUB_BUCKETS);
+    int sub = index - exp * SUB_BUCKETS;
+
+    // center of the bucket
+    return ldexp(0.5 + (sub + 0.5) / (2 * SUB_BUCKETS), exp);
+}
+
+void LogHistogram::addToBucket(int index, uint64_t num)
+{
+    if (buckets.empty()) {
+        firstIndex = index;
+        buckets.assign(1, num);
+        return;
+    }
+
+    if (index < firstIndex) {
+        buckets.insert(buckets.begin(), firstIndex - index, 0);
+        firstIndex = index;
+    } else if (index >= firstIndex + (int)buckets.size()) {
+        buckets.resize(index - firstIndex + 1, 0);
+    }
+
+    buckets[index - firstIndex] += num;
+}
+
+void LogHistogram::record(double value)
+{
+    if (count == 0 || value < min) min = value;
+    if (count == 0 || value > max) max = value;
+    count++;
+    sum += value;
+
+    if (value <= 0) {
+        zeroCount++;
+    } else {
+        addToBucket(getIndex(value), 1);
+    }
+}
+
+void LogHistogram::merge(const LogHistogram& other)
+{
+    if (other.count == 0) {
+        return;
+    }
+
+    if (count == 0 || other.min < min) min = other.min;
+    if (count == 0 || other.max > max) max = other.max;
+    count += other.count;
+    sum += other.sum;
+    zeroCount += other.zeroCount;
+
+    for (size_t i = 0; i < other.buckets.size(); i++) {
+        if (other.buckets[i] > 0) {
+            addToBucket(other.firstIndex + i, other.buckets[i]);
+        }
+    }
+}
+
+double LogHistogram::getPercentile(double percentile) const
+{
+    if (count == 0) {
+        return 0;
+    }
+
+    uint64_t rank = (uint64_t)ceil(percentile / 100 * count);
+    if (rank < 1) rank = 1;
+    if (rank >= count) return max;
+
+    uint64_t seen = zeroCount;
+    if (seen >= rank) {
+        return std::max(min, 0.0);
+    }
+
+    for (size_t i = 0; i < buckets.size(); i++) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            double value = getValue(firstIndex + i);
+            return std::min(std::max(value, min), max);
+        }
+    }
+
+    return max;
+}
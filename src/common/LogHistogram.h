@@ -0,0 +1,87 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file LogHistogram.h
+ * @author agent
+ */
+
+#ifndef __LOGHISTOGRAM_H__
+#define __LOGHISTOGRAM_H__
+
+#include <vector>
+
+#include <omnetpp.h>
+
+/**
+ * Histogram with logarithmic buckets (similar to HdrHistogram) for
+ * positive values of any magnitude. Each power of two is split into
+ * SUB_BUCKETS linear buckets, so percentiles have a relative error
+ * below 1/SUB_BUCKETS. Recording is O(1), the bucket range grows as
+ * needed and histograms of different nodes can be merged.
+ *
+ * @author agent
+ */
+class LogHistogram
+{
+public:
+    LogHistogram();
+
+    /**
+     * Adds a value, values <= 0 are counted as 0
+     */
+    void record(double value);
+
+    /**
+     * Adds all values of another histogram
+     */
+    void merge(const LogHistogram& other);
+
+    /**
+     * Returns the value at the given percentile
+     *
+     * @param percentile the percentile in [0, 100]
+     * @return the value, or 0 if the histogram is empty
+     */
+    double getPercentile(double percentile) const;
+
+    uint64_t getCount() const { return count; };
+    double getMin() const { return min; };
+    double getMax() const { return max; };
+    double getMean() const { return count ? sum / count : 0; };
+
+    void clear();
+
+private:
+    static const int SUB_BUCKET_BITS = 7;
+    static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+
+    int getIndex(double value) const;
+    double getValue(int index) const;
+    void addToBucket(int index, uint64_t num);
+
+    std::vector<uint64_t> buckets; /**< counts for the indices firstIndex.. */
+    int firstIndex;
+    uint64_t zeroCount; /**< number of values <= 0 */
+    uint64_t count;
+    double sum;
+    double min;
+    double max;
+};
+
+#endif
@@ -0,0 +1,127 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file LookupCache.cc
+ * @author agent
+ */
+
+#include <LookupCache.h>
+
+LookupCache::LookupCache()
+{
+    maxSize = 0;
+    ttl = 0;
+    numHits = 0;
+    numMisses = 0;
+    numStale = 0;
+    numInvalidated = 0;
+}
+
+void LookupCache::initialize(uint32_t maxSize, simtime_t ttl)
+{
+    this->maxSize = maxSize;
+    this->ttl = ttl;
+    clear();
+}
+
+bool LookupCache::get(const OverlayKey& key, int numSiblings,
+                      std::vector<NodeHandle>& result)
+{
+    result.clear();
+
+    CacheMap::iterator it = entries.find(key);
+
+    if (it == entries.end()) {
+        numMisses++;
+        return false;
+    }
+
+    if (it->second.expires <= simTime()) {
+        numStale++;
+        numMisses++;
+        erase(it);
+        return false;
+    }
+
+    if (numSiblings > it->second.numSiblings) {
+        // the cached lookup asked for less siblings
+        numMisses++;
+        return false;
+    }
+
+    size_t num = std::min((size_t)numSiblings, it->second.siblings.size());
+    result.assign(it->second.siblings.begin(),
+                  it->second.siblings.begin() + num);
+    numHits++;
+
+    return true;
+}
+
+void LookupCache::put(const OverlayKey& key, int numSiblings,
+                      const std::vector<NodeHandle>& siblings)
+{
+    if (!isEnabled() || siblings.empty()) {
+        return;
+    }
+
+    CacheMap::iterator it = entries.find(key);
+
+    if (it != entries.end()) {
+        erase(it);
+    }
+
+    while (entries.size() >= maxSize) {
+        erase(entries.find(ageList.front()));
+    }
+
+    CacheEntry& entry = entries[key];
+    entry.siblings = siblings;
+    entry.numSiblings = numSiblings;
+    entry.expires = simTime() + ttl;
+    entry.age = ageList.insert(ageList.end(), key);
+}
+
+void LookupCache::removeNode(const TransportAddress& node)
+{
+    CacheMap::iterator it = entries.begin();
+
+    while (it != entries.end()) {
+        CacheMap::iterator cur = it++;
+        for (size_t i = 0; i < cur->second.siblings.size(); i++) {
+            if (cur->second.siblings[i].getIp() == node.getIp() &&
+                cur->second.siblings[i].getPort() == node.getPort()) {
+                numInvalidated++;
+                erase(cur);
+                break;
+            }
+        }
+    }
+}
+
+void LookupCache::clear()
+{
+    entries.clear();
+    ageList.clear();
+}
+
+void LookupCache::erase(CacheMap::iterator it)
+{
+    ageList.erase(it->second.age);
+    entries.erase(it);
+}
@@ -0,0 +1,128 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file LookupCache.h
+ * @author agent
+ */
+
+#ifndef __LOOKUPCACHE_H__
+#define __LOOKUPCACHE_H__
+
+#include <vector>
+#include <list>
+#include <map>
+
+#include <omnetpp.h>
+
+#include <OverlayKey.h>
+#include <NodeHandle.h>
+
+/**
+ * Caches the sibling sets of recent successful lookups for a limited time,
+ * so repeated lookups for the same key can skip the overlay lookup.
+ * Entries are dropped when one of the cached siblings fails or leaves,
+ * or when their TTL expires. Since joins are only reported for the
+ * local neighborhood, a joining neighbor invalidates the entries which
+ * contain the local node.
+ * The oldest entry is evicted if the cache is full.
+ *
+ * @author agent
+ */
+class LookupCache
+{
+public:
+    LookupCache();
+
+    /**
+     * Sets the cache parameters
+     *
+     * @param maxSize maximum number of cached keys (0 disables the cache)
+     * @param ttl lifetime of a cached entry
+     */
+    void initialize(uint32_t maxSize, simtime_t ttl);
+
+    bool isEnabled() const { return maxSize > 0; };
+
+    /**
+     * Returns the cached siblings for a key
+     *
+     * @param key the lookup key
+     * @param numSiblings number of requested siblings
+     * @param result the first numSiblings cached siblings are stored here
+     * @return true, if a valid entry with at least numSiblings siblings
+     *         was found
+     */
+    bool get(const OverlayKey& key, int numSiblings,
+             std::vector<NodeHandle>& result);
+
+    /**
+     * Stores the result of a successful lookup
+     *
+     * @param key the lookup key
+     * @param numSiblings number of siblings the lookup asked for
+     * @param siblings the lookup result
+     */
+    void put(const OverlayKey& key, int numSiblings,
+             const std::vector<NodeHandle>& siblings);
+
+    /**
+     * Drops all entries which contain the given node
+     *
+     * @param node the failed or departed node
+     */
+    void removeNode(const TransportAddress& node);
+
+    /**
+     * Removes all entries
+     */
+    void clear();
+
+    size_t size() const { return entries.size(); };
+
+    uint32_t getNumHits() const { return numHits; };
+    uint32_t getNumMisses() const { return numMisses; };
+    uint32_t getNumStale() const { return numStale; };
+    uint32_t getNumInvalidated() const { return numInvalidated; };
+
+private:
+    struct CacheEntry
+    {
+        std::vector<NodeHandle> siblings;
+        int numSiblings;
+        simtime_t expires;
+        std::list<OverlayKey>::iterator age;
+    };
+
+    typedef std::map<OverlayKey, CacheEntry> CacheMap;
+
+    void erase(CacheMap::iterator it);
+
+    CacheMap entries;
+    std::list<OverlayKey> ageList; /**< keys in insertion order */
+
+    uint32_t maxSize;
+    simtime_t ttl;
+
+    uint32_t numHits;
+    uint32_t numMisses;
+    uint32_t numStale;       /**< misses due to expired entries */
+    uint32_t numInvalidated; /**< entries dropped by failures/churn */
+};
+
+#endif
@@ -0,0 +1,59 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file MemoryReport.cc
+ * @author agent
+ */
+
+#include "MemoryReport.h"
+
+void MemoryReport::add(const std::string& component, double objects,
+                       double bytes)
+{
+    Usage& usage = nodeUsage[node][component];
+    usage.objects += objects;
+    usage.bytes += bytes;
+}
+
+double MemoryReport::messageBytes(const cMessage* msg)
+{
+    if (msg == NULL) {
+        return 0;
+    }
+
+    if (!msg->isPacket()) {
+        return sizeof(cMessage);
+    }
+
+    const cPacket* packet = static_cast<const cPacket*>(msg);
+    double bytes = packet->getByteLength();
+
+    for (; packet != NULL; packet = packet->getEncapsulatedPacket()) {
+        bytes += sizeof(cPacket);
+    }
+
+    return bytes;
+}
+
+MemoryReporter::Reporters& MemoryReporter::getReporters()
+{
+    // constructed on first use, reporters may be static objects
+    static Reporters reporters;
+    return reporters;
+}
@@ -0,0 +1,136 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file MemoryReport.h
+ * @author agent
+ */
+
+#ifndef __MEMORYREPORT_H__
+#define __MEMORYREPORT_H__
+
+#include <map>
+#include <set>
+#include <string>
+
+#include <omnetpp.h>
+
+/**
+ * Live object counts and estimated memory usage of the components of
+ * all nodes, collected by GlobalStatistics
+ *
+ * The byte counts are estimates: they include the objects and the
+ * usual node overhead of the standard containers, but not the heap
+ * management overhead and not the dynamic members of messages.
+ *
+ * @author agent
+ */
+class MemoryReport
+{
+  public:
+    struct Usage
+    {
+        Usage() : objects(0), bytes(0) {};
+
+        double objects;
+        double bytes;
+    };
+
+    typedef std::map<std::string, Usage> UsageMap;
+    typedef std::map<const cModule*, UsageMap> NodeUsageMap;
+
+    MemoryReport() : node(NULL) {};
+
+    /**
+     * Sets the node the following add() calls are accounted to
+     */
+    void setNode(const cModule* node) { this->node = node; };
+
+    /**
+     * Adds the usage of a component of the current node
+     *
+     * @param component name of the component, e.g. "BaseRpc: RPC states"
+     * @param objects number of live objects
+     * @param bytes estimated memory usage in bytes
+     */
+    void add(const std::string& component, double objects, double bytes);
+
+    /** Returns the usage of all nodes */
+    const NodeUsageMap& getNodeUsage() const { return nodeUsage; };
+
+    /** Estimated size of a std::map/std::set node holding a value */
+    static double treeNodeBytes(size_t valueBytes)
+    {
+        return valueBytes + 4 * sizeof(void*);
+    };
+
+    /** Estimated size of a hash table node and its bucket */
+    static double hashNodeBytes(size_t valueBytes)
+    {
+        return valueBytes + 2 * sizeof(void*);
+    };
+
+    /** Estimated size of a std::list node holding a value */
+    static double listNodeBytes(size_t valueBytes)
+    {
+        return valueBytes + 2 * sizeof(void*);
+    };
+
+    /**
+     * Estimated size of a message and all encapsulated packets (the
+     * byte length is used as estimate of the size of the dynamic
+     * message fields)
+     */
+    static double messageBytes(const cMessage* msg);
+
+  private:
+    const cModule* node;
+    NodeUsageMap nodeUsage;
+};
+
+/**
+ * Interface of components, which report their memory usage
+ *
+ * All instances register themselves on construction, so reporters
+ * just have to implement reportMemory(). The report of a reporter,
+ * which is a module, is accounted to the node (top level module)
+ * containing it.
+ *
+ * @author agent
+ */
+class MemoryReporter
+{
+  public:
+    typedef std::set<MemoryReporter*> Reporters;
+
+    MemoryReporter() { getReporters().insert(this); };
+    virtual ~MemoryReporter() { getReporters().erase(this); };
+
+    /**
+     * Adds the live objects and estimated memory usage of this
+     * component to report
+     *
+     * @param report the report
+     */
+    virtual void reportMemory(MemoryReport& report) = 0;
+
+    /** Returns all existing reporters */
+    static Reporters& getReporters();
+};
+
+#endif
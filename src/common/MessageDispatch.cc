@@ -0,0 +1,57 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file MessageDispatch.cc
+ * @author agent
+ */
+
+#include "MessageDispatch.h"
+
+MessageTypeRegistry::CacheSlot
+MessageTypeRegistry::cache[MessageTypeRegistry::CACHE_SIZE];
+std::map<const std::type_info*, size_t> MessageTypeRegistry::types;
+std::map<std::string, size_t> MessageTypeRegistry::typeNames;
+
+size_t MessageTypeRegistry::registerType(const std::type_info& type)
+{
+    size_t id;
+    std::map<const std::type_info*, size_t>::iterator it = types.find(&type);
+
+    if (it != types.end()) {
+        id = it->second;
+    } else {
+        std::map<std::string, size_t>::iterator nameIt =
+            typeNames.find(type.name());
+
+        if (nameIt != typeNames.end()) {
+            id = nameIt->second;
+        } else {
+            id = typeNames.size();
+            typeNames.insert(std::make_pair(std::string(type.name()), id));
+        }
+
+        types.insert(std::make_pair(&type, id));
+    }
+
+    CacheSlot& slot = cache[((size_t)&type >> 4) % CACHE_SIZE];
+    slot.type = &type;
+    slot.id = id;
+
+    return id;
+}
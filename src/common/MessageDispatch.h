@@ -0,0 +1,175 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file MessageDispatch.h
+ * @author agent
+ */
+
+#ifndef __MESSAGEDISPATCH_H__
+#define __MESSAGEDISPATCH_H__
+
+#include <deque>
+#include <map>
+#include <string>
+#include <typeinfo>
+#include <stdint.h>
+
+#include <omnetpp.h>
+
+/**
+ * Assigns a compact integer ID to every message class, which is
+ * registered with the first call of getId() for this class
+ *
+ * @author agent
+ */
+class MessageTypeRegistry
+{
+  public:
+    /**
+     * Returns the ID of a message class
+     *
+     * @param type the dynamic type of the message, i.e. typeid(*msg)
+     * @return the ID of the class, IDs are numbered from 0
+     */
+    static size_t getId(const std::type_info& type)
+    {
+        const CacheSlot& slot = cache[((size_t)&type >> 4) % CACHE_SIZE];
+
+        if (slot.type == &type) {
+            return slot.id;
+        }
+
+        return registerType(type);
+    };
+
+    /** Returns the number of registered message classes */
+    static size_t getNumTypes() { return typeNames.size(); };
+
+  private:
+    static const size_t CACHE_SIZE = 256;
+
+    struct CacheSlot
+    {
+        const std::type_info* type;
+        size_t id;
+    };
+
+    static CacheSlot cache[CACHE_SIZE]; //!< direct mapped cache of getId()
+    static std::map<const std::type_info*, size_t> types;
+
+    /**
+     * std::type_info objects of the same class may differ between
+     * shared libraries, so IDs are finally assigned by class name
+     */
+    static std::map<std::string, size_t> typeNames;
+
+    static size_t registerType(const std::type_info& type);
+};
+
+/**
+ * Dispatch table of a message handler
+ *
+ * A handler with static storage duration keeps one table and numbers
+ * its type cases in the order they are tested. The result of the
+ * dynamic_cast of each case is remembered per message class, so the
+ * RTTI of a message class is walked at most once per case and handler.
+ * Afterwards dispatching a message costs one lookup of its class ID
+ * and a bit test per case.
+ *
+ * @author agent
+ */
+class MessageDispatchTable
+{
+  public:
+    /** Maximal number of cases of a handler, further cases are cast */
+    static const int MAX_CASES = 64;
+
+    struct Entry //!< cases of a handler, which match a message class
+    {
+        Entry() : known(0), matches(0) {};
+
+        uint64_t known; //!< cases tested for this class
+        uint64_t matches; //!< cases matching this class
+    };
+
+    /**
+     * Returns the dispatch table entry of the class of obj
+     *
+     * The reference stays valid while the table exists, even if
+     * handlers are entered recursively.
+     *
+     * @param obj the message to dispatch, may be NULL
+     */
+    Entry& getEntry(const cObject* obj)
+    {
+        if (obj == NULL) {
+            return nullEntry;
+        }
+
+        size_t id = MessageTypeRegistry::getId(typeid(*obj));
+
+        if (id >= entries.size()) {
+            entries.resize(MessageTypeRegistry::getNumTypes());
+        }
+
+        return entries[id];
+    };
+
+  private:
+    std::deque<Entry> entries; //!< indexed by the class ID
+    Entry nullEntry;
+};
+
+/**
+ * Casts a message to the class of a case of a dispatch table
+ *
+ * @param entry the dispatch table entry of the class of obj
+ * @param caseNo the number of the case in the handler
+ * @param obj the message to dispatch, may be NULL
+ * @return obj or NULL, exactly like dynamic_cast<T*>(obj)
+ */
+template <class T>
+inline T* dispatchCast(MessageDispatchTable::Entry& entry, int caseNo,
+                       cObject* obj)
+{
+    if (obj == NULL) {
+        return NULL;
+    }
+
+    if (caseNo >= MessageDispatchTable::MAX_CASES) {
+        return dynamic_cast<T*>(obj);
+    }
+
+    uint64_t bit = (uint64_t)1 << caseNo;
+
+    if (entry.known & bit) {
+        return (entry.matches & bit) ? static_cast<T*>(obj) : NULL;
+    }
+
+    T* result = dynamic_cast<T*>(obj);
+
+    entry.known |= bit;
+    if (result != NULL) {
+        entry.matches |= bit;
+    }
+
+    return result;
+}
+
+#endif
@@ -0,0 +1,67 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file NcsCoordinates.cc
+ * @author agent
+ */
+
+#include "NcsCoordinates.h"
+
+void NcsCoordinates::getDistances(const NcsCoordinates& from,
+                                  const NcsCoordinates* const* to, size_t n,
+                                  double* distances)
+{
+    const uint8_t D = MAX_DIM;
+    double base[D];
+    for (uint8_t i = 0; i < D; ++i) base[i] = from.coords[i];
+
+    for (size_t k = 0; k < n; ++k) {
+        if (to[k] == NULL) {
+            distances[k] = -1;
+            continue;
+        }
+        const double* other = to[k]->coords;
+
+        double sum[4] = { 0, 0, 0, 0 };
+        for (uint8_t i = 0; i < D; i += 4) {
+            for (uint8_t j = 0; j < 4; ++j) {
+                double diff = base[i + j] - other[i + j];
+                sum[j] += diff * diff;
+            }
+        }
+        distances[k] = (sum[0] + sum[1]) + (sum[2] + sum[3]);
+    }
+
+    // separate pass, so the square roots are vectorized as well
+    for (size_t k = 0; k < n; ++k) {
+        if (distances[k] >= 0) distances[k] = sqrt(distances[k]);
+    }
+}
+
+std::ostream& operator<<(std::ostream& os, const NcsCoordinates& coords)
+{
+    os << "< ";
+    for (uint8_t i = 0; i < coords.size(); ++i) {
+        if (i) os << ", ";
+        os << coords[i];
+    }
+    os << " >";
+
+    return os;
+}
@@ -0,0 +1,108 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file NcsCoordinates.h
+ * @author agent
+ */
+
+#ifndef __NCSCOORDINATES_H_
+#define __NCSCOORDINATES_H_
+
+#include <stdint.h>
+#include <cmath>
+#include <vector>
+#include <ostream>
+
+#include <omnetpp.h>
+
+/**
+ * Network coordinates with up to MAX_DIM dimensions, which are stored
+ * inline. Unused dimensions are kept 0, so distances are computed over
+ * a fixed number of dimensions without branches, which lets the
+ * compiler unroll and vectorize the loops.
+ *
+ * @author agent
+ */
+class NcsCoordinates
+{
+public:
+    static const uint8_t MAX_DIM = 8;
+
+    NcsCoordinates(uint8_t dimension = 0) { resize(dimension); };
+
+    uint8_t size() const { return dim; };
+
+    /**
+     * Sets the number of dimensions and resets all coordinates to 0
+     */
+    void resize(uint8_t dimension)
+    {
+        if (dimension > MAX_DIM) {
+            throw cRuntimeError("NcsCoordinates: at most %d dimensions "
+                                "supported!", MAX_DIM);
+        }
+        dim = dimension;
+        for (uint8_t i = 0; i < MAX_DIM; ++i) coords[i] = 0;
+    };
+
+    double operator[](uint8_t i) const { return coords[i]; };
+    double& operator[](uint8_t i) { return coords[i]; };
+
+    operator std::vector<double>() const
+    {
+        return std::vector<double>(coords, coords + dim);
+    };
+
+    /**
+     * Returns the euclidean distance to other
+     */
+    double getDistance(const NcsCoordinates& other) const
+    {
+        // four independent partial sums, so the loop can be vectorized
+        // without reordering floating point additions
+        double sum[4] = { 0, 0, 0, 0 };
+        for (uint8_t i = 0; i < MAX_DIM; i += 4) {
+            for (uint8_t j = 0; j < 4; ++j) {
+                double diff = coords[i + j] - other.coords[i + j];
+                sum[j] += diff * diff;
+            }
+        }
+        return sqrt((sum[0] + sum[1]) + (sum[2] + sum[3]));
+    };
+
+    /**
+     * Computes the euclidean distances from one point to n points
+     *
+     * @param from the point to compute the distances from
+     * @param to the n points (NULL entries result in a negative distance)
+     * @param n number of points
+     * @param distances array for the n distances
+     */
+    static void getDistances(const NcsCoordinates& from,
+                             const NcsCoordinates* const* to, size_t n,
+                             double* distances);
+
+private:
+    double coords[MAX_DIM]; /**< unused dimensions are 0 */
+    uint8_t dim;
+};
+
+std::ostream& operator<<(std::ostream& os, const NcsCoordinates& coords);
+
+#endif
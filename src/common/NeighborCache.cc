@@ -23,6 +23,7 @@
  */
 
 #include <cassert>
+#include <algorithm>
 
 #include <TransportAddress.h>
 #include <NodeHandle.h>
@@ -37,6 +38,27 @@
 
 const std::vector<double> NeighborCache::coordsDummy;
 
+struct RecentEntryCompare
+{
+    template<class T>
+    bool operator()(const T& a, const T& b) const
+    {
+        return a.first > b.first;
+    }
+};
+
+struct ProxIndexCompare
+{
+    ProxIndexCompare(const std::vector<Prox>& proxs) : proxs(proxs) { };
+
+    bool operator()(size_t a, size_t b) const
+    {
+        return proxs[a].proximity < proxs[b].proximity;
+    }
+
+    const std::vector<Prox>& proxs;
+};
+
 std::ostream& operator<<(std::ostream& os,
                          const NeighborCache::NeighborCacheEntry& entry)
 {
@@ -68,7 +90,7 @@ void NeighborCache::initializeApp(int stage)
 {
     if (stage == MAX_STAGE_COMPONENTS) {
         neighborCache.clear();
-        WATCH_UNORDERED_MAP(neighborCache);
+        WATCH(neighborCache);
 
         enableNeighborCache = par("enableNeighborCache");
         rttExpirationTime = par("rttExpirationTime");
@@ -124,6 +146,8 @@ void NeighborCache::initializeApp(int stage)
 
         rttHistory = par("rttHistory");
         timeoutAccuracyLimit = par("timeoutAccuracyLimit");
+        minRto = par("minRto");
+        maxRto = par("maxRto");
 
         numMsg = 0;
         absoluteError = 0.0;
@@ -168,27 +192,45 @@ NeighborCache::~NeighborCache()
     delete ncs;
 }
 
+void NeighborCache::reportMemory(MemoryReport& report)
+{
+    BaseApp::reportMemory(report);
+
+    // all slots of the table are allocated, used or not
+    double bytes = neighborCache.capacity() *
+        sizeof(NeighborCacheTable<NeighborCacheEntry>::Slot);
+
+    for (NeighborCacheIterator it = neighborCache.begin();
+            it != neighborCache.end(); ++it) {
+        bytes += it->second.lastRtts.capacity() * sizeof(simtime_t) +
+                 it->second.waitingContexts.capacity() *
+                 sizeof(WaitingContext);
+        if (it->second.coordsInfo != NULL) {
+            bytes += sizeof(*it->second.coordsInfo);
+        }
+    }
+
+    report.add("NeighborCache: entries", neighborCache.size(), bytes);
+}
+
 bool NeighborCache::insertNodeContext(const TransportAddress& handle,
                                      cPolymorphic* context,
                                      ProxListener* rpcListener,
                                      int rpcId)
 {
     if (!enableNeighborCache) return false;
-    if (neighborCache.count(handle) == 0) {
+    NeighborCacheIterator it = neighborCache.find(handle);
+    if (it == neighborCache.end()) {
         NeighborCacheEntry& entry = neighborCache[handle];
 
         entry.insertTime = simTime();
         entry.rttState = RTTSTATE_WAITING;
 
-        neighborCacheExpireMap.insert(std::make_pair(entry.insertTime,
-                                                     handle));
-
         cleanupCache();
 
-        assert(neighborCache.size() == neighborCacheExpireMap.size());
         return false;
     } else {
-        NeighborCacheEntry& entry = neighborCache[handle];
+        NeighborCacheEntry& entry = it->second;
 
         // waiting?
         if (entry.rttState == RTTSTATE_WAITING) {
@@ -202,7 +244,7 @@ bool NeighborCache::insertNodeContext(const TransportAddress& handle,
                                     " but additional contexts found!");
             }
 
-            updateEntry(handle, entry.insertTime);
+            neighborCache.touch(it);
 
             entry.rttState = RTTSTATE_WAITING;
             entry.insertTime = simTime();
@@ -215,10 +257,11 @@ bool NeighborCache::insertNodeContext(const TransportAddress& handle,
 
 NeighborCache::WaitingContexts NeighborCache::getNodeContexts(const TransportAddress& handle)
 {
-    if (neighborCache.count(handle) == 0)
+    NeighborCacheIterator it = neighborCache.find(handle);
+    if (it == neighborCache.end())
         throw cRuntimeError("NeighborCache error!");
-    WaitingContexts temp = neighborCache[handle].waitingContexts;
-    neighborCache[handle].waitingContexts.clear();
+    WaitingContexts temp;
+    temp.swap(it->second.waitingContexts);
 
     return temp;
 }
@@ -228,19 +271,18 @@ void NeighborCache::setNodeTimeout(const TransportAddress& handle)
 {
     //if (!enableNeighborCache) return;
 
-    if (neighborCache.count(handle) == 0) {
+    NeighborCacheIterator it = neighborCache.find(handle);
+    if (it == neighborCache.end()) {
         NeighborCacheEntry& entry = neighborCache[handle];
 
         entry.insertTime = simTime();
         entry.rttState = RTTSTATE_TIMEOUT;
 
-        neighborCacheExpireMap.insert(std::make_pair(entry.insertTime,
-                                                     handle));
         cleanupCache();
     } else {
-        NeighborCacheEntry& entry = neighborCache[handle];
+        NeighborCacheEntry& entry = it->second;
 
-        updateEntry(handle, entry.insertTime);
+        neighborCache.touch(it);
 
         entry.insertTime = simTime();
         entry.rttState = RTTSTATE_TIMEOUT;
@@ -257,13 +299,13 @@ void NeighborCache::setNodeTimeout(const TransportAddress& handle)
             }
         }
     }
-    assert(neighborCache.size() == neighborCacheExpireMap.size());
 }
 
 
 void NeighborCache::updateNode(const NodeHandle& add, simtime_t rtt,
                                const NodeHandle& srcRoute,
-                               AbstractNcsNodeInfo* ncsInfo)
+                               AbstractNcsNodeInfo* ncsInfo,
+                               bool ambiguousRtt)
 {
     Enter_Method_Silent();
 
@@ -279,34 +321,46 @@ void NeighborCache::updateNode(const NodeHandle& add, simtime_t rtt,
 
     bool deleteInfo = false;
 
+    // Karn's algorithm: an rtt of a retransmitted call may belong to any
+    // copy of the call, so it only refreshes the entry
     //if (enableNeighborCache) {
-    if (neighborCache.count(add) == 0) {
+    NeighborCacheIterator it = neighborCache.find(add);
+    if (it == neighborCache.end()) {
         NeighborCacheEntry& entry = neighborCache[add];
 
         entry.insertTime = simTime();
-        entry.rtt = rtt;
-        entry.rttState = RTTSTATE_VALID;
         entry.nodeRef = add;
         entry.coordsInfo = ncsInfo;
-        entry.lastRtts.push_back(rtt);
-
-        neighborCacheExpireMap.insert(std::make_pair(entry.insertTime, add));
+        if (!ambiguousRtt) {
+            entry.rtt = rtt;
+            entry.rttState = RTTSTATE_VALID;
+            entry.lastRtts.push_back(rtt);
+            updateRttEstimate(entry, rtt);
+        }
 
         cleanupCache();
     } else {
-        updateEntry(add, neighborCache[add].insertTime);
+        neighborCache.touch(it);
 
-        NeighborCacheEntry& entry = neighborCache[add];
+        NeighborCacheEntry& entry = it->second;
 
         entry.insertTime = simTime();
-        if (entry.rttState != RTTSTATE_VALID || entry.rtt > rtt)
-            entry.rtt = rtt;
-        entry.rttState = RTTSTATE_VALID;
         entry.nodeRef = add;
 
-        entry.lastRtts.push_back(rtt);
-        if (entry.lastRtts.size()  > rttHistory) {
-            entry.lastRtts.pop_front();
+        if (!ambiguousRtt) {
+            if (entry.rttState != RTTSTATE_VALID || entry.rtt > rtt)
+                entry.rtt = rtt;
+            entry.rttState = RTTSTATE_VALID;
+
+            entry.lastRtts.push_back(rtt);
+            if (entry.lastRtts.size()  > rttHistory) {
+                entry.lastRtts.erase(entry.lastRtts.begin());
+            }
+            updateRttEstimate(entry, rtt);
+        } else {
+            // keep the last unambiguous rtt
+            entry.rttState = (entry.rtt > 0) ? RTTSTATE_VALID
+                                             : RTTSTATE_UNKNOWN;
         }
 
         if (ncsInfo) {
@@ -330,11 +384,12 @@ void NeighborCache::updateNode(const NodeHandle& add, simtime_t rtt,
             }
         }
     }
-    assert(neighborCache.size() == neighborCacheExpireMap.size());
 
-    calcRttError(add, rtt);
+    if (!ambiguousRtt) {
+        calcRttError(add, rtt);
 
-    if (ncs) ncs->processCoordinates(rtt, *ncsInfo);
+        if (ncs) ncs->processCoordinates(rtt, *ncsInfo);
+    }
 
     // delete ncsInfo if old info is used
     if (deleteInfo) delete ncsInfo;
@@ -351,19 +406,18 @@ void NeighborCache::updateNcsInfo(const TransportAddress& node,
        << "    inserting new NcsInfo of node " << node.getIp()
        << endl;
 
-    if (neighborCache.count(node) == 0) {
+    NeighborCacheIterator it = neighborCache.find(node);
+    if (it == neighborCache.end()) {
         NeighborCacheEntry& entry = neighborCache[node];
 
         entry.insertTime = simTime();
         entry.coordsInfo = ncsInfo;
 
-        neighborCacheExpireMap.insert(std::make_pair(entry.insertTime, node));
-
         cleanupCache();
     } else {
-        updateEntry(node, neighborCache[node].insertTime);
+        neighborCache.touch(it);
 
-        NeighborCacheEntry& entry = neighborCache[node];
+        NeighborCacheEntry& entry = it->second;
 
         if (ncsInfo) {
             if (entry.coordsInfo) {
@@ -380,14 +434,19 @@ void NeighborCache::updateNcsInfo(const TransportAddress& node,
 NeighborCache::Rtt NeighborCache::getNodeRtt(const TransportAddress &add)
 {
     // cache disabled or entry not there
-    if (!enableNeighborCache ||
-        add.isUnspecified() ||
-        (neighborCache.count(add) == 0)) {
+    if (!enableNeighborCache || add.isUnspecified()) {
         misses++;
         return std::make_pair(0.0, RTTSTATE_UNKNOWN);
     }
 
-    NeighborCacheEntry &entry = neighborCache[add];
+    NeighborCacheIterator it = neighborCache.find(add);
+    if (it == neighborCache.end()) {
+        misses++;
+        return std::make_pair(0.0, RTTSTATE_UNKNOWN);
+    }
+
+    NeighborCacheEntry &entry = it->second;
+    neighborCache.touch(it);
 
     if (entry.rttState == RTTSTATE_WAITING ||
         entry.rttState == RTTSTATE_UNKNOWN)
@@ -405,49 +464,37 @@ NeighborCache::Rtt NeighborCache::getNodeRtt(const TransportAddress &add)
 
 const NodeHandle& NeighborCache::getNodeHandle(const TransportAddress &add)
 {
-    if (neighborCache.count(add) == 0) {
+    NeighborCacheIterator it = neighborCache.find(add);
+    if (it == neighborCache.end()) {
         throw cRuntimeError("NeighborCache.cc: getNodeHandle was asked for "
                             "a non-existent node reference.");
     }
-    return neighborCache[add].nodeRef;
+    return it->second.nodeRef;
 }
 
 
 bool NeighborCache::cleanupCache()
 {
     bool result = false;
-    uint32_t size = neighborCache.size();
-
-    if (size > maxSize) {
-        neighborCacheExpireMapIterator it;
-        for (uint32_t i = 0; i < (size - (maxSize / 2)); ++i) {
-            it = neighborCacheExpireMap.begin();
-            if ((neighborCache[it->second].rttState == RTTSTATE_WAITING) ||
-                (neighborCache[it->second].insertTime == simTime())) {
-                break;
+
+    if (neighborCache.size() > maxSize) {
+        // clock sweep: evict entries which were not used since the hand
+        // passed them last time, at most two revolutions per cleanup
+        size_t steps = 2 * neighborCache.capacity();
+        while ((neighborCache.size() > (maxSize / 2)) && (steps-- > 0)) {
+            NeighborCacheIterator it = neighborCache.advanceClock();
+            if ((it == neighborCache.end()) ||
+                (it->second.rttState == RTTSTATE_WAITING) ||
+                (it->second.insertTime == simTime())) {
+                continue;
             }
-            neighborCache.erase(it->second);
-            neighborCacheExpireMap.erase(it);
+            neighborCache.erase(it);
             result = true;
         }
     }
-    assert(neighborCache.size() == neighborCacheExpireMap.size());
     return result;
 }
 
-
-void NeighborCache::updateEntry(const TransportAddress& address,
-                                simtime_t insertTime)
-{
-    neighborCacheExpireMapIterator it =
-        neighborCacheExpireMap.lower_bound(insertTime);
-    while (it->second != address) ++it;
-    neighborCacheExpireMap.erase(it);
-    neighborCacheExpireMap.insert(std::make_pair(simTime(),
-                                                 address));
-    assert(neighborCache.size() == neighborCacheExpireMap.size());
-}
-
 //TODO
 TransportAddress NeighborCache::getNearestNode(uint8_t maxLayer)
 {
@@ -507,13 +554,31 @@ double NeighborCache::getAvgAbsPredictionError()
     uint32_t numNeighbors = 0;
     uint32_t sampleSize = 32; //test
 
-    for (std::map<simtime_t, TransportAddress>::reverse_iterator it =
-         neighborCacheExpireMap.rbegin();
-         it != neighborCacheExpireMap.rend() &&
-         numNeighbors < sampleSize; ++it) {
-        NeighborCacheEntry& cacheEntry = neighborCache[it->second];
+    // sample the most recently inserted entries with a valid rtt
+    std::vector<std::pair<simtime_t, NeighborCacheEntry*> > recent;
+    recent.reserve(neighborCache.size());
+    for (NeighborCacheIterator it = neighborCache.begin();
+         it != neighborCache.end(); ++it) {
+        if (it->second.rttState == RTTSTATE_VALID && it->second.coordsInfo) {
+            recent.push_back(std::make_pair(it->second.insertTime,
+                                            &it->second));
+        }
+    }
+    size_t numRecent = std::min((size_t)sampleSize, recent.size());
+    std::partial_sort(recent.begin(), recent.begin() + numRecent, recent.end(),
+                      RecentEntryCompare());
+
+    std::vector<const AbstractNcsNodeInfo*> sample(numRecent);
+    for (size_t i = 0; i < numRecent; ++i) {
+        sample[i] = recent[i].second->coordsInfo;
+    }
+    std::vector<Prox> dists;
+    ncs->getOwnNcsInfo().getDistances(sample, dists);
+
+    for (size_t i = 0; i < numRecent; ++i) {
+        NeighborCacheEntry& cacheEntry = *recent[i].second;
 
-        double dist = ncs->getOwnNcsInfo().getDistance(*cacheEntry.coordsInfo);
+        double dist = dists[i].proximity;
 
         if (dist != 0 && cacheEntry.rttState == RTTSTATE_VALID) {
             double predictionError = fabs(dist - SIMTIME_DBL(cacheEntry.rtt));
@@ -580,7 +645,8 @@ Prox NeighborCache::getProx(const TransportAddress &node,
                               ProxListener *listener,
                               cPolymorphic *contextPointer)
 {
-    Enter_Method("getProx()");
+    // no Enter_Method() here: cache lookups don't need a context switch,
+    // queryProx() switches the context if a query is sent
 
     if (!enableNeighborCache) {
         queryProx(node, rpcId, listener, contextPointer);
@@ -677,10 +743,69 @@ Prox NeighborCache::getProx(const TransportAddress &node,
     return result;
 }
 
-Prox NeighborCache::estimateProx(const TransportAddress &node)
+void NeighborCache::getProxBatch(const std::vector<TransportAddress>& nodes,
+                                 std::vector<Prox>& proxs,
+                                 NeighborCacheQueryType type,
+                                 std::vector<size_t>* ranking)
 {
-    Enter_Method("estimateProx()");
+    proxs.resize(nodes.size());
+
+    if (type == NEIGHBORCACHE_DEFAULT) type = defaultQueryType;
+    else if (type == NEIGHBORCACHE_DEFAULT_IMMEDIATELY) type = defaultQueryTypeI;
+    else if (type == NEIGHBORCACHE_DEFAULT_QUERY) type = defaultQueryTypeQ;
+
+    if (type != NEIGHBORCACHE_ESTIMATED || !enableNeighborCache || !ncs) {
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            proxs[i] = getProx(nodes[i], type);
+        }
+    } else {
+        // like getProx(), but all estimates are computed in one batch
+        std::vector<size_t> estimated;
+        std::vector<const AbstractNcsNodeInfo*> coordsInfos;
+
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            if (nodes[i] == overlay->getThisNode()) {
+                proxs[i] = Prox::PROX_SELF;
+                continue;
+            }
+
+            Rtt rtt = getNodeRtt(nodes[i]);
+            if (rtt.second == RTTSTATE_TIMEOUT) {
+                proxs[i] = Prox::PROX_TIMEOUT;
+            } else if (rtt.second == RTTSTATE_VALID) {
+                proxs[i] = rtt.first;
+            } else {
+                proxs[i] = Prox::PROX_UNKNOWN;
+                NeighborCacheIterator it = neighborCache.find(nodes[i]);
+                if (it != neighborCache.end() && it->second.coordsInfo) {
+                    estimated.push_back(i);
+                    coordsInfos.push_back(it->second.coordsInfo);
+                }
+            }
+        }
+
+        if (estimated.size()) {
+            std::vector<Prox> estimates;
+            ncs->getCoordinateBasedProxs(coordsInfos, estimates);
+            for (size_t i = 0; i < estimated.size(); ++i) {
+                proxs[estimated[i]] = estimates[i];
+            }
+        }
+    }
 
+    if (ranking) {
+        ranking->resize(nodes.size());
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            (*ranking)[i] = i;
+        }
+        // PROX_UNKNOWN and PROX_TIMEOUT have the maximum proximity
+        std::stable_sort(ranking->begin(), ranking->end(),
+                         ProxIndexCompare(proxs));
+    }
+}
+
+Prox NeighborCache::estimateProx(const TransportAddress &node)
+{
     Rtt rtt = getNodeRtt(node);
 
     if (rtt.second != RTTSTATE_UNKNOWN) return rtt.first;
@@ -701,17 +826,10 @@ void NeighborCache::queryProx(const TransportAddress &node,
 
     WaitingContext temp(listener, contextPointer, rpcId);
 
-    if (neighborCache.count(node) == 0) {
-        NeighborCacheEntry& entry = neighborCache[node];
-
-        entry.waitingContexts.push_back(temp);
-        neighborCacheExpireMap.insert(std::make_pair(entry.insertTime, node));
-        cleanupCache();
-    } else {
-        NeighborCacheEntry& entry = neighborCache[node];
-        entry.waitingContexts.push_back(temp);
-    }
-    assert(neighborCache.size() == neighborCacheExpireMap.size());
+    // inserts a new entry if needed
+    NeighborCacheEntry& entry = neighborCache[node];
+    entry.waitingContexts.push_back(temp);
+    cleanupCache();
 
     // TODO: this ping traffic is accounted application data traffic!
     pingNode(node, -1, 0, NULL, "PING");
@@ -729,11 +847,12 @@ Prox NeighborCache::getCoordinateBasedProx(const TransportAddress& node)
 
 const AbstractNcsNodeInfo* NeighborCache::getNodeCoordsInfo(const TransportAddress &node)
 {
-    if (neighborCache.count(node) == 0) {
+    NeighborCacheIterator it = neighborCache.find(node);
+    if (it == neighborCache.end()) {
         throw cRuntimeError("NeighborCache.cc: getNodeCoords was asked for "
                             "a non-existent node reference.");
     }
-    return neighborCache[node].coordsInfo;
+    return it->second.coordsInfo;
 }
 
 
@@ -769,17 +888,19 @@ void NeighborCache::calcRttError(const NodeHandle& handle, simtime_t rtt)
 std::pair<simtime_t, simtime_t> NeighborCache::getMeanVarRtt(const TransportAddress &node,
                                                              bool returnVar)
 {
-    if (neighborCache.count(node) == 0) {
+    NeighborCacheIterator it = neighborCache.find(node);
+    if (it == neighborCache.end()) {
         throw cRuntimeError("NeighborCache.cc: getMeanVarRtt was asked for"
                             "a non-existent node reference.");
     }
 
-    uint16_t size = neighborCache[node].lastRtts.size();
+    const std::vector<simtime_t>& lastRtts = it->second.lastRtts;
+    uint16_t size = lastRtts.size();
     if (size == 0) return std::make_pair(-1.0,-1.0);
 
     simtime_t rttSum = 0;
     for (int i = 0; i < size; i++){
-        rttSum += neighborCache[node].lastRtts[i];
+        rttSum += lastRtts[i];
     }
     simtime_t meanRtt = rttSum / size;
     if (!returnVar) {
@@ -791,7 +912,7 @@ std::pair<simtime_t, simtime_t> NeighborCache::getMeanVarRtt(const TransportAddr
 
     double sum = 0.0;
     for (int i = 0; i < size; i++){
-        simtime_t tempRtt = neighborCache[node].lastRtts.at(i) - meanRtt;
+        simtime_t tempRtt = lastRtts[i] - meanRtt;
         sum += (SIMTIME_DBL(tempRtt) * SIMTIME_DBL(tempRtt));
     }
 
@@ -799,39 +920,82 @@ std::pair<simtime_t, simtime_t> NeighborCache::getMeanVarRtt(const TransportAddr
 }
 
 
+void NeighborCache::updateRttEstimate(NeighborCacheEntry& entry,
+                                      simtime_t rtt)
+{
+    if (entry.srtt == 0) {
+        // first measurement
+        entry.srtt = rtt;
+        entry.rttVar = rtt / 2;
+    } else {
+        simtime_t delta = entry.srtt - rtt;
+        if (delta < 0) delta = -delta;
+        entry.rttVar = 0.75 * entry.rttVar + 0.25 * delta;
+        entry.srtt = 0.875 * entry.srtt + 0.125 * rtt;
+    }
+
+    entry.rtoBackoff = 0;
+}
+
+
 simtime_t NeighborCache::getNodeTimeout(const NodeHandle &node)
 {
     simtime_t timeout = getRttBasedTimeout(node);
-    if (timeout == -1 && ncs) return getNcsBasedTimeout(node);
-    return timeout;
+    if (timeout == -1 && ncs) timeout = getNcsBasedTimeout(node);
+    if (timeout == -1) return -1;
+
+    // exponential backoff after timeouts
+    NeighborCacheIterator it = neighborCache.find(node);
+    if (it != neighborCache.end()) {
+        timeout *= (1 << it->second.rtoBackoff);
+    }
+
+    return (timeout > maxRto) ? maxRto : timeout;
+}
+
+
+void NeighborCache::backoffNodeTimeout(const TransportAddress& node)
+{
+    NeighborCacheIterator it = neighborCache.find(node);
+    if (it != neighborCache.end() &&
+        it->second.rtoBackoff < MAX_RTO_BACKOFF) {
+        it->second.rtoBackoff++;
+    }
+}
+
+
+simtime_t NeighborCache::getMinRtt(const TransportAddress& node)
+{
+    NeighborCacheIterator it = neighborCache.find(node);
+    if (it == neighborCache.end() || it->second.srtt == 0) return -1;
+
+    return it->second.rtt;
+}
+
+
+simtime_t NeighborCache::getRttPercentile95(const TransportAddress& node)
+{
+    NeighborCacheIterator it = neighborCache.find(node);
+    if (it == neighborCache.end() || it->second.srtt == 0) return -1;
+
+    // the mean deviation is about 0.8 standard deviations
+    return it->second.srtt + 2 * it->second.rttVar;
 }
 
 
 //Calculate timeout with RTT
 simtime_t NeighborCache::getRttBasedTimeout(const NodeHandle &node)
 {
-    simtime_t timeout = -1;
+    NeighborCacheIterator it = neighborCache.find(node);
 
-    // check if an entry is available in NeighborCache
-    if (isEntry(node)) {
-        std::pair<simtime_t, simtime_t> temp = getMeanVarRtt(node, true);
-        simtime_t meanRtt = temp.first;
-        simtime_t varRtt = temp.second;
-
-        // TODO return value even if node has timed out
-        if (meanRtt == -1) return -1;
-        if (varRtt > 0) {
-            // like TCP
-            timeout = meanRtt + 4 * varRtt;
-        } else {
-            // only one RTT is available
-            timeout = meanRtt * 1.2;
-        }
-        // adjustment
-        timeout *= RTT_TIMEOUT_ADJUSTMENT;
-        //if (timeout > SIMTIME_DBL(defaultTimeout)) return -1;
-    }
-    return timeout;
+    // the estimate is kept if the node has timed out, the backoff
+    // takes care of unreachable nodes
+    if (it == neighborCache.end() || it->second.srtt == 0) return -1;
+
+    // like TCP (RFC 6298)
+    simtime_t timeout = it->second.srtt + 4 * it->second.rttVar;
+
+    return (timeout < minRto) ? minRto : timeout;
 }
 
 //Calculate timeout with NCS
@@ -30,7 +30,7 @@
 
 #include <map>
 #include <cfloat>
-#include <deque>
+#include <vector>
 
 #include <BaseApp.h>
 #include <NodeHandle.h>
@@ -41,6 +41,7 @@
 #include <SimpleNcs.h>
 #include <ProxNodeHandle.h>
 #include <HashFunc.h>
+#include <NeighborCacheTable.h>
 
 class GlobalStatistics;
 class TransportAddress;
@@ -82,9 +83,6 @@ private:
 
     bool cleanupCache();
 
-    void updateEntry(const TransportAddress& address,
-                     simtime_t insertTime);
-
     AbstractNcs* ncs;
     bool ncsSendBackOwnCoords;
 
@@ -108,6 +106,8 @@ private:
     uint32_t numRttErrorToLow;
     uint32_t rttHistory;
     double timeoutAccuracyLimit;
+    simtime_t minRto; //!< lower bound of the RTT based timeouts
+    simtime_t maxRto; //!< upper bound of the timeouts including backoff
 
     struct WaitingContext
     {
@@ -141,8 +141,8 @@ private:
 
     Rtt getNodeRtt(const TransportAddress& add);
 
-    static const double RTT_TIMEOUT_ADJUSTMENT = 1.3;
     static const double NCS_TIMEOUT_CONSTANT = 0.25;
+    static const uint8_t MAX_RTO_BACKOFF = 6;
 
 protected:
     GlobalStatistics* globalStatistics;
@@ -150,6 +150,9 @@ protected:
     struct NeighborCacheEntry {
         NeighborCacheEntry() { insertTime = simTime();
                                rttState = RTTSTATE_UNKNOWN;
+                               srtt = 0;
+                               rttVar = 0;
+                               rtoBackoff = 0;
                                coordsInfo = NULL; };
 
         ~NeighborCacheEntry() {
@@ -159,10 +162,31 @@ protected:
             }
         };
 
+        /**
+         * Exchanges the contents of two entries, used by
+         * NeighborCacheTable to move entries without copying
+         */
+        void swap(NeighborCacheEntry& entry) {
+            std::swap(insertTime, entry.insertTime);
+            std::swap(rtt, entry.rtt);
+            std::swap(rttState, entry.rttState);
+            lastRtts.swap(entry.lastRtts);
+            std::swap(srtt, entry.srtt);
+            std::swap(rttVar, entry.rttVar);
+            std::swap(rtoBackoff, entry.rtoBackoff);
+            std::swap(nodeRef, entry.nodeRef);
+            std::swap(srcRoute, entry.srcRoute);
+            std::swap(coordsInfo, entry.coordsInfo);
+            waitingContexts.swap(entry.waitingContexts);
+        };
+
         simtime_t  insertTime;
         simtime_t  rtt;
         NeighborCacheRttState rttState;
-        std::deque<simtime_t> lastRtts;
+        std::vector<simtime_t> lastRtts; //!< no allocation for empty slots
+        simtime_t srtt; //!< smoothed RTT, 0 if no RTT has been measured
+        simtime_t rttVar; //!< smoothed mean deviation of the RTT
+        uint8_t rtoBackoff; //!< timeouts since the last RTT measurement
         NodeHandle nodeRef;
         NodeHandle srcRoute;
         AbstractNcsNodeInfo* coordsInfo;
@@ -170,12 +194,8 @@ protected:
         WaitingContexts waitingContexts;
     };
 
-    UNORDERED_MAP<TransportAddress, NeighborCacheEntry> neighborCache;
-    typedef UNORDERED_MAP<TransportAddress, NeighborCacheEntry>::iterator NeighborCacheIterator;
-    typedef UNORDERED_MAP<TransportAddress, NeighborCacheEntry>::const_iterator NeighborCacheConstIterator;
-
-    std::multimap<simtime_t, TransportAddress> neighborCacheExpireMap;
-    typedef std::multimap<simtime_t, TransportAddress>::iterator neighborCacheExpireMapIterator;
+    NeighborCacheTable<NeighborCacheEntry> neighborCache;
+    typedef NeighborCacheTable<NeighborCacheEntry>::iterator NeighborCacheIterator;
 
     void initializeApp(int stage);
 
@@ -203,12 +223,20 @@ protected:
      */
     bool handleRpcCall(BaseCallMessage* msg);
 
+    /**
+     * Updates the smoothed RTT and RTT deviation of an entry with a new
+     * measurement (Jacobson/Karels, RFC 6298)
+     */
+    void updateRttEstimate(NeighborCacheEntry& entry, simtime_t rtt);
+
     simtime_t getRttBasedTimeout(const NodeHandle &node);
     simtime_t getNcsBasedTimeout(const NodeHandle &node);
 
 public:
     ~NeighborCache();
 
+    void reportMemory(MemoryReport& report);
+
     inline bool isEnabled() { return enableNeighborCache; };
 
     bool sendBackOwnCoords() { return (ncsSendBackOwnCoords && ncs != NULL); };
@@ -230,19 +258,61 @@ public:
     /**
      * Caclulation of reasonable timout value
      *
+     * The timeout is calculated from the smoothed RTT and RTT
+     * deviation of the node or, if no RTT has been measured yet, from
+     * the network coordinates. It is doubled for every timeout since
+     * the last RTT measurement (see backoffNodeTimeout()).
+     *
      * @param node the node an RPC is sent to
-     * @returns recommended timeout value
+     * @returns recommended timeout value, -1 if the node is unknown
      */
     simtime_t getNodeTimeout(const NodeHandle &node);
 
+    /**
+     * Doubles the timeout of node until the next RTT measurement,
+     * called for every RPC timeout
+     *
+     * @param node the node an RPC has timed out to
+     */
+    void backoffNodeTimeout(const TransportAddress& node);
+
+    /**
+     * Returns the lowest RTT measured to node since its last timeout
+     *
+     * @param node the node
+     * @returns the RTT, -1 if no RTT is known
+     */
+    simtime_t getMinRtt(const TransportAddress& node);
+
+    /**
+     * Returns an estimate of the 95th percentile of the RTT to node,
+     * derived from the smoothed RTT and RTT deviation
+     *
+     * @param node the node
+     * @returns the RTT, -1 if no RTT is known
+     */
+    simtime_t getRttPercentile95(const TransportAddress& node);
+
     // getter for general node information
     TransportAddress getNearestNode(uint8_t maxLayer);
     double getAvgAbsPredictionError();
 
     // setter for specific node information
+    /**
+     * Inserts a measured RTT of a node
+     *
+     * @param add the node
+     * @param rtt the measured RTT
+     * @param srcRoute the source route to the node, if any
+     * @param ncsInfo network coordinates of the node, if any
+     * @param ambiguousRtt true if the RTT was measured with a
+     *   retransmitted call, it only refreshes the entry then and
+     *   isn't used for RTTs, timeouts or coordinates (Karn's algorithm)
+     */
     void updateNode(const NodeHandle &add, simtime_t rtt,
                     const NodeHandle& srcRoute = NodeHandle::UNSPECIFIED_NODE,
-                    AbstractNcsNodeInfo* ncsInfo = NULL);
+                    AbstractNcsNodeInfo* ncsInfo = NULL,
+                    bool ambiguousRtt = false);
     void updateNcsInfo(const TransportAddress& node,
                        AbstractNcsNodeInfo* ncsInfo);
     void setNodeTimeout(const TransportAddress& handle);
@@ -274,6 +344,24 @@ public:
                  ProxListener *listener = NULL,
                  cPolymorphic *contextPointer = NULL);
 
+    /**
+     * Gets the proximity of a whole candidate set in one call, e.g. to
+     * rank the nodes of a routing decision. Queries needed for
+     * NEIGHBORCACHE_EXACT or NEIGHBORCACHE_QUERY are sent without a
+     * listener, so their results only update the cache. Coordinate
+     * based estimates are computed with a single NCS batch call.
+     *
+     * @param nodes The nodes whose proximity will be requested.
+     * @param proxs The proximity values in the order of nodes.
+     * @param type Request type, see getProx().
+     * @param ranking If not NULL, the indices of nodes ordered by
+     *   ascending proximity (unknown and timed out nodes last).
+     */
+    void getProxBatch(const std::vector<TransportAddress>& nodes,
+                      std::vector<Prox>& proxs,
+                      NeighborCacheQueryType type = NEIGHBORCACHE_AVAILABLE,
+                      std::vector<size_t>* ranking = NULL);
+
     /**
      * Estimates a Prox value of node, in relation to this node,
      * based on information collected by the overlay.
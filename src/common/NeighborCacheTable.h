@@ -0,0 +1,254 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file NeighborCacheTable.h
+ * @author agent
+ */
+
+#ifndef __NEIGHBORCACHETABLE_H_
+#define __NEIGHBORCACHETABLE_H_
+
+#include <vector>
+#include <ostream>
+
+#include <TransportAddress.h>
+
+/**
+ * Flat open-addressing hash table (linear probing, backward shift
+ * deletion) mapping TransportAddresses to entries, which are stored
+ * inline in the slot array. Instead of a time ordered index, each slot
+ * has a reference bit for a clock sweep (second chance) eviction.
+ *
+ * Entries are moved between slots on deletion and growth, so T must
+ * provide a swap() method that exchanges the contents of two entries.
+ * Iterators are invalidated by insertion and deletion.
+ *
+ * @author agent
+ */
+template<class T>
+class NeighborCacheTable
+{
+public:
+    struct Slot
+    {
+        Slot() : used(false), referenced(false) { };
+
+        TransportAddress first;
+        T second;
+        bool used;
+        bool referenced; /**< reference bit for the clock sweep */
+    };
+
+    class iterator
+    {
+    public:
+        iterator() : slots(NULL), pos(0) { };
+        iterator(std::vector<Slot>* slots, size_t pos)
+            : slots(slots), pos(pos) { skip(); };
+
+        Slot& operator*() const { return (*slots)[pos]; };
+        Slot* operator->() const { return &(*slots)[pos]; };
+
+        iterator& operator++() { ++pos; skip(); return *this; };
+        iterator operator++(int) { iterator tmp = *this; ++*this; return tmp; };
+
+        bool operator==(const iterator& it) const { return pos == it.pos; };
+        bool operator!=(const iterator& it) const { return pos != it.pos; };
+
+    private:
+        void skip() { while (pos < slots->size() && !(*slots)[pos].used) ++pos; };
+
+        std::vector<Slot>* slots;
+        size_t pos;
+
+        friend class NeighborCacheTable;
+    };
+
+    NeighborCacheTable() { clear(); };
+
+    size_t size() const { return numEntries; };
+    bool empty() const { return numEntries == 0; };
+    size_t capacity() const { return slots.size(); };
+
+    iterator begin() { return iterator(&slots, 0); };
+    iterator end() { return iterator(&slots, slots.size()); };
+
+    size_t count(const TransportAddress& key) const
+    {
+        size_t pos;
+        return findPos(key, pos) ? 1 : 0;
+    };
+
+    iterator find(const TransportAddress& key)
+    {
+        size_t pos;
+        return findPos(key, pos) ? iterator(&slots, pos) : end();
+    };
+
+    /**
+     * Returns the entry of key, a new default entry is inserted if
+     * key is not in the table
+     */
+    T& operator[](const TransportAddress& key)
+    {
+        size_t pos;
+        if (findPos(key, pos)) {
+            return slots[pos].second;
+        }
+
+        if ((numEntries + 1) * 10 > slots.size() * MAX_LOAD) {
+            grow();
+            findPos(key, pos);
+        }
+
+        Slot& slot = slots[pos];
+        T fresh;
+        slot.second.swap(fresh);
+        slot.first = key;
+        slot.used = true;
+        slot.referenced = false;
+        numEntries++;
+
+        return slot.second;
+    };
+
+    void erase(iterator it)
+    {
+        size_t mask = slots.size() - 1;
+        size_t hole = it.pos;
+        size_t next = (hole + 1) & mask;
+
+        // shift back entries whose probe sequence crosses the hole
+        while (slots[next].used) {
+            size_t home = getHome(slots[next].first);
+            if (((next - home) & mask) >= ((next - hole) & mask)) {
+                moveSlot(slots[hole], slots[next]);
+                hole = next;
+            }
+            next = (next + 1) & mask;
+        }
+
+        Slot& slot = slots[hole];
+        T empty;
+        slot.second.swap(empty);
+        slot.first = TransportAddress::UNSPECIFIED_NODE;
+        slot.used = false;
+        slot.referenced = false;
+        numEntries--;
+    };
+
+    void erase(const TransportAddress& key)
+    {
+        iterator it = find(key);
+        if (it != end()) erase(it);
+    };
+
+    void clear()
+    {
+        slots.clear();
+        slots.resize(MIN_CAPACITY);
+        shift = 32 - MIN_CAPACITY_BITS;
+        numEntries = 0;
+        hand = 0;
+    };
+
+    /**
+     * Marks an entry as recently used
+     */
+    void touch(iterator it) { it->referenced = true; };
+
+    /**
+     * Advances the clock hand by one slot. Returns the slot if it is
+     * an eviction candidate, i.e. used and not referenced since the hand
+     * passed it last time. Otherwise the reference bit is cleared and
+     * end() is returned.
+     */
+    iterator advanceClock()
+    {
+        hand = (hand + 1) & (slots.size() - 1);
+        Slot& slot = slots[hand];
+
+        if (!slot.used) return end();
+        if (slot.referenced) {
+            slot.referenced = false;
+            return end();
+        }
+        return iterator(&slots, hand);
+    };
+
+    friend std::ostream& operator<<(std::ostream& os,
+                                    const NeighborCacheTable<T>& table)
+    {
+        for (size_t i = 0; i < table.slots.size(); i++) {
+            if (!table.slots[i].used) continue;
+            os << table.slots[i].first << ": " << table.slots[i].second << "\n";
+        }
+        return os;
+    };
+
+private:
+    static const size_t MIN_CAPACITY_BITS = 4;
+    static const size_t MIN_CAPACITY = 1 << MIN_CAPACITY_BITS;
+    static const size_t MAX_LOAD = 7; /**< maximum load factor in tenths */
+
+    size_t getHome(const TransportAddress& key) const
+    {
+        // fibonacci hashing spreads the ip/port hash over all slots
+        return (uint32_t)((uint32_t)key.hash() * 2654435769U) >> shift;
+    };
+
+    bool findPos(const TransportAddress& key, size_t& pos) const
+    {
+        size_t mask = slots.size() - 1;
+        for (pos = getHome(key); slots[pos].used; pos = (pos + 1) & mask) {
+            if (slots[pos].first == key) return true;
+        }
+        return false;
+    };
+
+    static void moveSlot(Slot& dest, Slot& src)
+    {
+        dest.first = src.first;
+        dest.second.swap(src.second);
+        dest.used = true;
+        dest.referenced = src.referenced;
+    };
+
+    void grow()
+    {
+        std::vector<Slot> oldSlots(slots.size() * 2);
+        oldSlots.swap(slots);
+        shift--;
+
+        for (size_t i = 0; i < oldSlots.size(); i++) {
+            if (!oldSlots[i].used) continue;
+            size_t pos;
+            findPos(oldSlots[i].first, pos);
+            moveSlot(slots[pos], oldSlots[i]);
+        }
+        hand = 0;
+    };
+
+    std::vector<Slot> slots;
+    size_t numEntries;
+    size_t shift; /**< 32 - log2(capacity) */
+    size_t hand; /**< position of the clock hand */
+};
+
+#endif
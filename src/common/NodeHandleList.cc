@@ -0,0 +1,225 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file NodeHandleList.cc
+ * @author agent
+ */
+
+#include <omnetpp.h>
+
+#include "NodeHandleList.h"
+
+// record layout: flags, IPv4 address, port, key
+static const size_t RECORD_IP_OFFSET = 1;
+static const size_t RECORD_PORT_OFFSET = 5;
+static const size_t RECORD_KEY_OFFSET = 7;
+
+// a record with no flags set is an unspecified NodeHandle
+static const unsigned char RECORD_PACKED = 1;
+static const unsigned char RECORD_KEY = 2;
+static const unsigned char RECORD_EXTENDED = 4;
+
+NodeHandleList::NodeHandleList() : numEntries(0), decoded(false)
+{
+}
+
+NodeHandleList::NodeHandleList(const NodeHandleList& other)
+    : numEntries(0), decoded(false)
+{
+    operator=(other);
+}
+
+NodeHandleList& NodeHandleList::operator=(const NodeHandleList& other)
+{
+    if (this == &other) {
+        return *this;
+    }
+
+    if (other.decoded) {
+        // the decoded handles may have been modified, pack them again
+        assign(other.handles.empty() ? NULL : &other.handles[0],
+               other.numEntries);
+    } else {
+        numEntries = other.numEntries;
+        records = other.records;
+        extended = other.extended;
+        decoded = false;
+        handles.clear();
+    }
+
+    return *this;
+}
+
+size_t NodeHandleList::getRecordSize() const
+{
+    return RECORD_KEY_OFFSET + OverlayKey::getPackedSize();
+}
+
+void NodeHandleList::assign(const NodeHandle* newHandles, size_t num)
+{
+    decoded = false;
+    handles.clear();
+    extended.clear();
+    records.clear();
+
+    numEntries = num;
+    records.resize(num * getRecordSize(), 0);
+
+    for (size_t k = 0; k < num; k++) {
+        encode(k, newHandles[k]);
+    }
+}
+
+void NodeHandleList::resize(size_t size)
+{
+    if (decoded) {
+        handles.resize(size);
+    } else {
+        records.resize(size * getRecordSize(), 0);
+        extended.erase(extended.lower_bound(size), extended.end());
+    }
+
+    numEntries = size;
+}
+
+void NodeHandleList::set(size_t k, const NodeHandle& handle)
+{
+    if (k >= numEntries) {
+        throw cRuntimeError("NodeHandleList::set(): index %u out of range",
+                            (unsigned int)k);
+    }
+
+    if (decoded) {
+        handles[k] = handle;
+    } else {
+        encode(k, handle);
+    }
+}
+
+NodeHandle& NodeHandleList::get(size_t k)
+{
+    if (k >= numEntries) {
+        throw cRuntimeError("NodeHandleList::get(): index %u out of range",
+                            (unsigned int)k);
+    }
+
+    decodeAll();
+    return handles[k];
+}
+
+const NodeHandle& NodeHandleList::get(size_t k) const
+{
+    return const_cast<NodeHandleList*>(this)->get(k);
+}
+
+void NodeHandleList::encode(size_t k, const NodeHandle& handle)
+{
+    unsigned char* record = &records[k * getRecordSize()];
+    const IPvXAddress& ip = handle.getIp();
+
+    extended.erase(k);
+
+    if (ip.isUnspecified() && handle.getKey().isUnspecified() &&
+        handle.getPort() == -1 &&
+        handle.getNatType() == TransportAddress::UNKNOWN_NAT &&
+        handle.getSourceRouteSize() == 0) {
+        record[0] = 0;
+    } else if (!ip.isIPv6() && !ip.isUnspecified() &&
+               handle.getPort() >= 0 && handle.getPort() <= 0xffff &&
+               handle.getNatType() == TransportAddress::UNKNOWN_NAT &&
+               handle.getSourceRouteSize() == 0) {
+        uint32_t addr = ip.get4().getInt();
+        record[0] = RECORD_PACKED;
+        record[RECORD_IP_OFFSET] = addr >> 24;
+        record[RECORD_IP_OFFSET + 1] = addr >> 16;
+        record[RECORD_IP_OFFSET + 2] = addr >> 8;
+        record[RECORD_IP_OFFSET + 3] = addr;
+        record[RECORD_PORT_OFFSET] = handle.getPort() >> 8;
+        record[RECORD_PORT_OFFSET + 1] = handle.getPort();
+
+        if (!handle.getKey().isUnspecified()) {
+            record[0] |= RECORD_KEY;
+            handle.getKey().pack(record + RECORD_KEY_OFFSET);
+        }
+    } else {
+        record[0] = RECORD_EXTENDED;
+        extended.insert(std::make_pair(k, handle));
+    }
+}
+
+NodeHandle NodeHandleList::decode(size_t k) const
+{
+    const unsigned char* record = &records[k * getRecordSize()];
+
+    if (record[0] & RECORD_EXTENDED) {
+        return extended.find(k)->second;
+    } else if (!(record[0] & RECORD_PACKED)) {
+        return NodeHandle();
+    }
+
+    uint32_t addr = ((uint32_t)record[RECORD_IP_OFFSET] << 24) |
+                    ((uint32_t)record[RECORD_IP_OFFSET + 1] << 16) |
+                    ((uint32_t)record[RECORD_IP_OFFSET + 2] << 8) |
+                    (uint32_t)record[RECORD_IP_OFFSET + 3];
+    int port = ((int)record[RECORD_PORT_OFFSET] << 8) |
+               (int)record[RECORD_PORT_OFFSET + 1];
+
+    return NodeHandle((record[0] & RECORD_KEY) ?
+                          OverlayKey::unpack(record + RECORD_KEY_OFFSET) :
+                          OverlayKey::UNSPECIFIED_KEY,
+                      IPvXAddress(IPAddress(addr)), port);
+}
+
+void NodeHandleList::decodeAll() const
+{
+    if (decoded) {
+        return;
+    }
+
+    handles.resize(numEntries);
+    for (size_t k = 0; k < numEntries; k++) {
+        handles[k] = decode(k);
+    }
+
+    decoded = true;
+}
+
+void NodeHandleList::netPack(cCommBuffer *b)
+{
+    decodeAll();
+
+    uint32_t size = numEntries;
+    doPacking(b, size);
+    for (size_t k = 0; k < numEntries; k++) {
+        doPacking(b, handles[k]);
+    }
+}
+
+void NodeHandleList::netUnpack(cCommBuffer *b)
+{
+    uint32_t size;
+    doUnpacking(b, size);
+
+    std::vector<NodeHandle> newHandles(size);
+    for (size_t k = 0; k < size; k++) {
+        doUnpacking(b, newHandles[k]);
+    }
+
+    assign(newHandles.empty() ? NULL : &newHandles[0], size);
+}
@@ -0,0 +1,94 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file NodeHandleList.h
+ * @author agent
+ */
+
+#ifndef __NODEHANDLELIST_H_
+#define __NODEHANDLELIST_H_
+
+#include <vector>
+#include <map>
+
+#include <NodeHandle.h>
+
+/**
+ * Compact storage for the NodeHandle arrays of messages
+ *
+ * A NodeHandle reserves space for the maximum key length, so large
+ * handle arrays in state messages dominate the memory and dup() costs
+ * of a simulation. NodeHandleList stores each handle as a fixed size
+ * record with the key in its actual length and an IPv4 address and
+ * port. Handles that do not fit (IPv6, NAT type or source route set,
+ * unspecified address) are kept unchanged in a side table.
+ *
+ * On the first read access the list is decoded into NodeHandles, so
+ * the returned references stay valid and may be modified. Messages in
+ * transit and their copies only hold the packed records.
+ *
+ * @author agent
+ */
+class NodeHandleList
+{
+public:
+    NodeHandleList();
+    NodeHandleList(const NodeHandleList& other);
+    NodeHandleList& operator=(const NodeHandleList& other);
+
+    size_t size() const { return numEntries; };
+    void resize(size_t size);
+
+    void set(size_t k, const NodeHandle& handle);
+    NodeHandle& get(size_t k);
+    const NodeHandle& get(size_t k) const;
+
+    void netPack(cCommBuffer *b);
+    void netUnpack(cCommBuffer *b);
+
+private:
+    size_t getRecordSize() const;
+    void encode(size_t k, const NodeHandle& handle);
+    NodeHandle decode(size_t k) const;
+    void decodeAll() const;
+    void assign(const NodeHandle* handles, size_t num);
+
+    size_t numEntries;
+    std::vector<unsigned char> records; /**< packed handles */
+    std::map<size_t, NodeHandle> extended; /**< handles without a packed form */
+
+    mutable bool decoded; /**< if true, handles replaces the packed records */
+    mutable std::vector<NodeHandle> handles;
+};
+
+/**
+ * Implements the accessors of an abstract NodeHandle array field of a
+ * customized message class with a NodeHandleList member
+ */
+#define NODEHANDLELIST_ACCESSORS(Name, list) \
+    virtual void set##Name##ArraySize(unsigned int size) {list.resize(size);} \
+    virtual unsigned int get##Name##ArraySize() const {return list.size();} \
+    virtual NodeHandle& get##Name(unsigned int k) {return list.get(k);} \
+    virtual const NodeHandle& get##Name(unsigned int k) const {return list.get(k);} \
+    virtual void set##Name(unsigned int k, const NodeHandle& handle) {list.set(k, handle);}
+
+inline void doPacking(cCommBuffer *b, NodeHandleList& obj) {obj.netPack(b);}
+inline void doUnpacking(cCommBuffer *b, NodeHandleList& obj) {obj.netUnpack(b);}
+
+#endif
@@ -167,7 +167,7 @@ void Nps::coordsReqRpc(CoordsReqCall* msg)
     //if (getOwnLayer() != 0) {
     // ordinary node
 
-    const std::vector<double>& ownCoordinates = getOwnCoordinates();
+    const NcsCoordinates& ownCoordinates = ownCoords->getCoords();
 
     uint8_t i;
     for (i = 0; i < ownCoordinates.size(); ++i) {
@@ -337,7 +337,6 @@ void Nps::coordsReqRpcResponse(CoordsReqResponse* response,
           ->addStdDev("NPS: Coordinate difference", error);
 
         neighborCache->neighborCache.clear(); //TODO
-        neighborCache->neighborCacheExpireMap.clear(); //TODO
 
         neighborCache->getParentModule()
             ->bubble("GNP/NPS coordinates calculated -> JOIN overlay!");
@@ -558,6 +557,12 @@ bool Nps::enoughLandmarks()
 }
 
 
+void Nps::getCoordinateBasedProxs(const std::vector<const AbstractNcsNodeInfo*>& nodes,
+                                  std::vector<Prox>& proxs) const
+{
+    ownCoords->getDistances(nodes, proxs);
+}
+
 Prox Nps::getCoordinateBasedProx(const AbstractNcsNodeInfo& abstractInfo) const
 {
     return ownCoords->getDistance(abstractInfo);
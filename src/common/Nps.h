@@ -106,11 +106,13 @@ class Nps : public RpcListener, public AbstractNcs
     virtual bool handleRpcCall(BaseCallMessage* msg);
 
     Prox getCoordinateBasedProx(const AbstractNcsNodeInfo& info) const;
+    void getCoordinateBasedProxs(const std::vector<const AbstractNcsNodeInfo*>& nodes,
+                                 std::vector<Prox>& proxs) const;
     AbstractNcsNodeInfo* getUnvalidNcsInfo() const {return new GnpNpsCoordsInfo; };
     AbstractNcsNodeInfo* createNcsInfo(const std::vector<double>& coords) const;
     virtual const AbstractNcsNodeInfo& getOwnNcsInfo() const { return *ownCoords; };
 
-    const std::vector<double>& getOwnCoordinates() const { return ownCoords->getCoords(); };
+    std::vector<double> getOwnCoordinates() const { return ownCoords->getCoords(); };
     double getOwnCoordinates(uint8_t i) const { return ownCoords->getCoords(i); };
     uint8_t getOwnLayer() const { return ownCoords->getLayer(); };
 
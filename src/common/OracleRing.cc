@@ -0,0 +1,74 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file OracleRing.cc
+ * @author agent
+ */
+
+#include <algorithm>
+
+#include "OracleRing.h"
+
+struct NodeHandleKeyLess
+{
+    bool operator()(const NodeHandle& a, const NodeHandle& b) const
+    {
+        return a.getKey() < b.getKey();
+    }
+};
+
+OracleRing::OracleRing(const std::vector<NodeHandle>& nodes) : nodes(nodes)
+{
+    std::sort(this->nodes.begin(), this->nodes.end(), NodeHandleKeyLess());
+
+    keys.reserve(this->nodes.size());
+    for (size_t i = 0; i < this->nodes.size(); i++) {
+        keys.push_back(this->nodes[i].getKey());
+    }
+}
+
+size_t OracleRing::lowerBound(const OverlayKey& key) const
+{
+    return std::lower_bound(keys.begin(), keys.end(), key) - keys.begin();
+}
+
+size_t OracleRing::successor(const OverlayKey& key) const
+{
+    size_t pos = lowerBound(key);
+    return (pos == keys.size()) ? 0 : pos;
+}
+
+void OracleRing::prefixRange(const OverlayKey& key, uint32_t prefixLength,
+                             size_t& first, size_t& last) const
+{
+    uint32_t suffixLength = OverlayKey::getLength() - prefixLength;
+
+    if (prefixLength == 0) {
+        first = 0;
+        last = keys.size();
+        return;
+    }
+
+    OverlayKey lower = (key >> suffixLength) << suffixLength;
+    OverlayKey upper = lower + OverlayKey::pow2(suffixLength);
+
+    first = lowerBound(lower);
+    // upper wraps around for the highest prefix
+    last = (upper <= lower) ? keys.size() : lowerBound(upper);
+}
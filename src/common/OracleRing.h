@@ -0,0 +1,83 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file OracleRing.h
+ * @author agent
+ */
+
+#ifndef __ORACLERING_H_
+#define __ORACLERING_H_
+
+#include <vector>
+
+#include <NodeHandle.h>
+
+/**
+ * The NodeHandles of all overlay nodes sorted by key, used by
+ * GlobalNodeList to install converged routing state (oracle warm start)
+ *
+ * All queries are binary searches, so an overlay can compute its
+ * complete routing state in O(log n) per entry.
+ *
+ * @author agent
+ */
+class OracleRing
+{
+public:
+    /**
+     * Sorts nodes by key, nodes must have distinct keys
+     */
+    OracleRing(const std::vector<NodeHandle>& nodes);
+
+    size_t size() const { return nodes.size(); };
+
+    /**
+     * Returns the node at position pos modulo size()
+     */
+    const NodeHandle& at(long pos) const
+    {
+        long n = nodes.size();
+        return nodes[((pos % n) + n) % n];
+    };
+
+    /**
+     * Returns the position of the first node with a key >= key,
+     * or size() if there is none
+     */
+    size_t lowerBound(const OverlayKey& key) const;
+
+    /**
+     * Returns the position of the node responsible for key in Chord,
+     * i.e. the first node with a key >= key modulo the ring
+     */
+    size_t successor(const OverlayKey& key) const;
+
+    /**
+     * Returns the positions [first, last) of all nodes, whose first
+     * prefixLength bits equal those of key
+     */
+    void prefixRange(const OverlayKey& key, uint32_t prefixLength,
+                     size_t& first, size_t& last) const;
+
+private:
+    std::vector<NodeHandle> nodes;
+    std::vector<OverlayKey> keys; /**< keys of nodes for the binary searches */
+};
+
+#endif
@@ -155,6 +155,29 @@ uint32_t OverlayKey::getLength()
     return OverlayKey::keyLength;
 }
 
+uint32_t OverlayKey::getPackedSize()
+{
+    return aSize * sizeof(mp_limb_t);
+}
+
+void OverlayKey::pack(unsigned char* buf) const
+{
+    if (isUnspec) {
+        throw cRuntimeError("OverlayKey::pack(): key is unspecified!");
+    }
+
+    memcpy(buf, key, aSize * sizeof(mp_limb_t));
+}
+
+OverlayKey OverlayKey::unpack(const unsigned char* buf)
+{
+    OverlayKey result;
+    result.clear();
+    memcpy(result.key, buf, aSize * sizeof(mp_limb_t));
+
+    return result;
+}
+
 bool OverlayKey::isUnspecified() const
 {
     return isUnspec;
@@ -469,6 +469,31 @@ public:
      */
     static uint32_t getLength();
 
+    /**
+     * Returns the number of bytes written by pack()
+     *
+     * @return The size of a packed key in bytes
+     */
+    static uint32_t getPackedSize();
+
+    /**
+     * Writes the machine words of a specified key to buf
+     *
+     * This is a compact in-memory representation for containers,
+     * not a portable wire format.
+     *
+     * @param buf buffer with at least getPackedSize() bytes
+     */
+    void pack(unsigned char* buf) const;
+
+    /**
+     * Restores a key written by pack()
+     *
+     * @param buf buffer with getPackedSize() bytes
+     * @return The restored key
+     */
+    static OverlayKey unpack(const unsigned char* buf);
+
     /**
      * Returns a random key.
      *
@@ -25,15 +25,25 @@
 #ifndef __RPC_MACROS_H
 #define __RPC_MACROS_H
 
+#include <MessageDispatch.h>
+
 /**
  * Marks the beginning of a Remote-Procedure-Call Switch block.
  * RPC_CALL, RPC_ON_CALL, RPC_ON_RESPONSE are allowed inside
  * this block.
+ *
+ * Each block keeps a static MessageDispatchTable, so the cases
+ * only cast a message class with dynamic_cast the first time it
+ * is dispatched by this block.
  */
 #define RPC_SWITCH_START( message ) \
     bool rpcHandled = false;\
     do { \
-        BaseRpcMessage* ___msg = dynamic_cast<BaseRpcMessage*>(message);
+        static MessageDispatchTable ___rpcTable; \
+        BaseRpcMessage* ___msg = dynamic_cast<BaseRpcMessage*>(message); \
+        MessageDispatchTable::Entry& ___rpcTypes = \
+            ___rpcTable.getEntry(___msg); \
+        int ___rpcCase = 0;
 
 /**
  * Marks the end of a Remote-Procedure-Call Switch block.
@@ -54,7 +64,8 @@
  * @param method The method to call
  */
 #define RPC_DELEGATE( name, method ) \
-    name##Call* _##name##Call = dynamic_cast<name##Call*>(___msg); \
+    name##Call* _##name##Call = \
+        dispatchCast<name##Call>(___rpcTypes, ___rpcCase++, ___msg); \
     if (_##name##Call != NULL) { rpcHandled = true; method(_##name##Call); \
      break; }
 
@@ -64,7 +75,9 @@
  * @name The message name of the RPC
  */
 #define RPC_ON_CALL( name ) \
-    name##Call* _##name##Call = dynamic_cast<name##Call*>(___msg); \
+    name##Call* _##name##Call = rpcHandled ? \
+        (___rpcCase++, (name##Call*)NULL) : \
+        dispatchCast<name##Call>(___rpcTypes, ___rpcCase++, ___msg); \
     if (_##name##Call != NULL && !rpcHandled)
 
 /**
@@ -73,7 +86,9 @@
  * @name The message name of the RPC
  */
 #define RPC_ON_RESPONSE( name ) \
-    name##Response* _##name##Response = dynamic_cast<name##Response*>(___msg); \
+    name##Response* _##name##Response = rpcHandled ? \
+        (___rpcCase++, (name##Response*)NULL) : \
+        dispatchCast<name##Response>(___rpcTypes, ___rpcCase++, ___msg); \
     if (_##name##Response != NULL && !rpcHandled)
 
 
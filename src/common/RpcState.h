@@ -54,6 +54,8 @@ private:
     RpcTimeoutMessage *timeoutMsg;
     simtime_t timeSent;
     simtime_t rto;
+    bool adaptiveRto; //!< rto is calculated by the NeighborCache
+    bool retransmitted; //!< the call has been sent more than once
     cPolymorphic *context;
 };
 
@@ -68,7 +68,7 @@ class SimpleNcs : public AbstractNcs
     virtual AbstractNcsNodeInfo* createNcsInfo(const std::vector<double>& coords) const;
 
     const AbstractNcsNodeInfo& getOwnNcsInfo() const { return *ownCoords; };
-    const std::vector<double>& getOwnCoordinates() const { return ownCoords->getCoords(); };
+    std::vector<double> getOwnCoordinates() const { return ownCoords->getCoords(); };
 };
 
 #endif
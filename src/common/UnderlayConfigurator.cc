@@ -25,6 +25,7 @@
 #include <GlobalNodeListAccess.h>
 #include <ChurnGeneratorAccess.h>
 #include <GlobalStatisticsAccess.h>
+#include <GlobalCheckpointAccess.h>
 
 #include "UnderlayConfigurator.h"
 
@@ -162,6 +163,14 @@ void UnderlayConfigurator::initFinished()
         init = false;
         gettimeofday(&initFinishedTime, NULL);
 
+        // install routing state of overlays deferred by oracleWarmStart
+        globalNodeList->warmStart();
+
+        GlobalCheckpoint* globalCheckpoint = GlobalCheckpointAccess().get();
+        if (globalCheckpoint != NULL) {
+            globalCheckpoint->restoreData();
+        }
+
         scheduleAt(simTime() + transitionTime,
                 endTransitionTimer);
 
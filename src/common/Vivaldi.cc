@@ -83,12 +83,16 @@ void Vivaldi::processCoordinates(const simtime_t& rtt,
 
     // update local coordinates
     if (dist > 0) {
-        for (uint8_t i = 0; i < dimension; i++) {
-            ownCoords->setCoords(i, ownCoords->getCoords(i) +
-                                    (delta * (SIMTIME_DBL(rtt) - dist)) *
-                                    ((ownCoords->getCoords(i) - info.getCoords(i)) /
-                                     dist));
+        const NcsCoordinates& remoteCoords = info.getCoords();
+        NcsCoordinates coords = ownCoords->getCoords();
+        double scale = (delta * (SIMTIME_DBL(rtt) - dist)) / dist;
+
+        // unused dimensions are 0 on both sides and stay 0
+        for (uint8_t i = 0; i < NcsCoordinates::MAX_DIM; i++) {
+            coords[i] += scale * (coords[i] - remoteCoords[i]);
         }
+        ownCoords->setCoords(coords);
+
         if(enableHeightVector) {
             ownCoords->setHeightVector(ownCoords->getHeightVector() +
                                       (delta * (SIMTIME_DBL(rtt) - dist)));
@@ -125,6 +129,13 @@ Prox Vivaldi::getCoordinateBasedProx(const AbstractNcsNodeInfo& abstractInfo) co
 }
 
 
+void Vivaldi::getCoordinateBasedProxs(const std::vector<const AbstractNcsNodeInfo*>& nodes,
+                                      std::vector<Prox>& proxs) const
+{
+    ownCoords->getDistances(nodes, proxs);
+}
+
+
 AbstractNcsNodeInfo* Vivaldi::createNcsInfo(const std::vector<double>& coords) const
 {
     assert(coords.size() > 1);
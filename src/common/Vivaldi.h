@@ -70,12 +70,14 @@ class Vivaldi : public AbstractNcs
                             const AbstractNcsNodeInfo& nodeInfo);
 
     Prox getCoordinateBasedProx(const AbstractNcsNodeInfo& info) const;
+    void getCoordinateBasedProxs(const std::vector<const AbstractNcsNodeInfo*>& nodes,
+                                 std::vector<Prox>& proxs) const;
 
     virtual AbstractNcsNodeInfo* getUnvalidNcsInfo() const { return new VivaldiCoordsInfo(enableHeightVector); };
     virtual AbstractNcsNodeInfo* createNcsInfo(const std::vector<double>& coords) const;
 
     const VivaldiCoordsInfo& getOwnNcsInfo() const { return *ownCoords; };
-    const std::vector<double>& getOwnCoordinates() const { return ownCoords->getCoords(); };
+    std::vector<double> getOwnCoordinates() const { return ownCoords->getCoords(); };
     inline double getOwnError() const { return ownCoords->getError(); };
     inline double getOwnHeightVector() const { return ownCoords->getHeightVector(); };
 };
@@ -0,0 +1,306 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file WorkloadGenerator.cc
+ * @author agent
+ */
+
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <fstream>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <BinaryValue.h>
+
+#include "WorkloadGenerator.h"
+
+static const char WORKLOAD_TRACE_MAGIC[] = "OSWKLD01";
+static const size_t WORKLOAD_TRACE_HEADER_L = 8;
+static const size_t WORKLOAD_TRACE_RECORD_L = 8;
+
+// log(1+x)/x, stable for small x
+static inline double zipfHelper1(double x)
+{
+    if (fabs(x) > 1e-8) {
+        return log1p(x) / x;
+    }
+    return 1 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+}
+
+// (exp(x)-1)/x, stable for small x
+static inline double zipfHelper2(double x)
+{
+    if (fabs(x) > 1e-8) {
+        return expm1(x) / x;
+    }
+    return 1 + x * 0.5 * (1 + x * 1.0 / 3.0 * (1 + 0.25 * x));
+}
+
+ZipfGenerator::ZipfGenerator(double s) : s(s)
+{
+    if (s < 0) {
+        throw cRuntimeError("ZipfGenerator: negative exponent!");
+    }
+
+    hIntegralX1 = hIntegral(1.5) - 1;
+    threshold = 2 - hIntegralInverse(hIntegral(2.5) - h(2));
+}
+
+double ZipfGenerator::hIntegral(double x) const
+{
+    double logX = log(x);
+    return zipfHelper2((1 - s) * logX) * logX;
+}
+
+double ZipfGenerator::h(double x) const
+{
+    return exp(-s * log(x));
+}
+
+double ZipfGenerator::hIntegralInverse(double x) const
+{
+    double t = x * (1 - s);
+    if (t < -1) {
+        t = -1;
+    }
+    return exp(zipfHelper1(t) * x);
+}
+
+uint32_t ZipfGenerator::draw(uint32_t n) const
+{
+    if (n <= 1) {
+        return 0;
+    }
+
+    if (s == 0) {
+        return intuniform(0, n - 1);
+    }
+
+    double hIntegralN = hIntegral(n + 0.5);
+
+    while (true) {
+        double u = hIntegralN + uniform(0, 1) * (hIntegralX1 - hIntegralN);
+        double x = hIntegralInverse(u);
+        uint32_t k = (uint32_t)(x + 0.5);
+
+        if (k < 1) {
+            k = 1;
+        } else if (k > n) {
+            k = n;
+        }
+
+        if ((k - x <= threshold) || (u >= hIntegral(k + 0.5) - h(k))) {
+            return k - 1;
+        }
+    }
+}
+
+std::map<std::string, WorkloadTrace*> WorkloadTrace::traces;
+
+WorkloadTrace* WorkloadTrace::open(const std::string& fileName)
+{
+    std::map<std::string, WorkloadTrace*>::iterator it =
+        traces.find(fileName);
+
+    if (it != traces.end()) {
+        it->second->refCount++;
+        return it->second;
+    }
+
+    WorkloadTrace* trace = new WorkloadTrace(fileName);
+    traces.insert(std::make_pair(fileName, trace));
+
+    return trace;
+}
+
+void WorkloadTrace::close(WorkloadTrace* trace)
+{
+    if (trace == NULL || --trace->refCount > 0) {
+        return;
+    }
+
+    traces.erase(trace->fileName);
+    delete trace;
+}
+
+WorkloadTrace::WorkloadTrace(const std::string& fileName) :
+    fileName(fileName), data(NULL), length(0), numRecords(0), refCount(1)
+{
+#ifndef _WIN32
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    struct stat st;
+
+    if (fd < 0 || fstat(fd, &st) < 0) {
+        if (fd >= 0) ::close(fd);
+        throw cRuntimeError("WorkloadTrace: Can't open trace file %s!",
+                            fileName.c_str());
+    }
+
+    length = st.st_size;
+
+    if (length > 0) {
+        void* map = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+
+        if (map == MAP_FAILED) {
+            throw cRuntimeError("WorkloadTrace: Can't map trace file %s!",
+                                fileName.c_str());
+        }
+        data = static_cast<const char*>(map);
+    } else {
+        ::close(fd);
+    }
+#else
+    std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+
+    if (!file) {
+        throw cRuntimeError("WorkloadTrace: Can't open trace file %s!",
+                            fileName.c_str());
+    }
+
+    file.seekg(0, std::ios::end);
+    length = file.tellg();
+    file.seekg(0, std::ios::beg);
+
+    char* buf = new char[length];
+    file.read(buf, length);
+    data = buf;
+#endif
+
+    if (length < WORKLOAD_TRACE_HEADER_L ||
+        memcmp(data, WORKLOAD_TRACE_MAGIC, WORKLOAD_TRACE_HEADER_L) != 0) {
+        throw cRuntimeError("WorkloadTrace: %s is not a workload trace!",
+                            fileName.c_str());
+    }
+
+    numRecords = (length - WORKLOAD_TRACE_HEADER_L) / WORKLOAD_TRACE_RECORD_L;
+
+    if (numRecords == 0) {
+        throw cRuntimeError("WorkloadTrace: %s contains no requests!",
+                            fileName.c_str());
+    }
+}
+
+WorkloadTrace::~WorkloadTrace()
+{
+#ifndef _WIN32
+    if (data != NULL) {
+        munmap(const_cast<char*>(data), length);
+    }
+#else
+    delete[] data;
+#endif
+}
+
+static inline uint32_t readUint32(const unsigned char* buf)
+{
+    return ((uint32_t)buf[0] << 24) | ((uint32_t)buf[1] << 16) |
+           ((uint32_t)buf[2] << 8) | (uint32_t)buf[3];
+}
+
+WorkloadTrace::Record WorkloadTrace::getRecord(size_t i) const
+{
+    const unsigned char* buf = reinterpret_cast<const unsigned char*>(data) +
+        WORKLOAD_TRACE_HEADER_L + i * WORKLOAD_TRACE_RECORD_L;
+
+    Record record;
+    record.keyId = readUint32(buf);
+    record.op = readUint32(buf + 4);
+
+    return record;
+}
+
+WorkloadGenerator::WorkloadGenerator()
+{
+    driftInterval = 0;
+    readRatio = 1;
+    trace = NULL;
+    tracePos = 0;
+}
+
+WorkloadGenerator::~WorkloadGenerator()
+{
+    WorkloadTrace::close(trace);
+}
+
+void WorkloadGenerator::initialize(double skew, simtime_t driftInterval,
+                                   double readRatio,
+                                   const std::string& traceFile)
+{
+    zipf = ZipfGenerator(skew);
+    this->driftInterval = driftInterval;
+    this->readRatio = readRatio;
+
+    WorkloadTrace::close(trace);
+    trace = NULL;
+
+    if (traceFile.size()) {
+        trace = WorkloadTrace::open(traceFile);
+        tracePos = intuniform(0, trace->size() - 1);
+    }
+}
+
+uint32_t WorkloadGenerator::drawIndex(uint32_t n)
+{
+    if (n == 0) {
+        return 0;
+    }
+
+    // move the popular ranks to other items in every epoch
+    return (uint32_t)((zipf.draw(n) + (uint64_t)getEpoch() * 2654435761UL)
+                      % n);
+}
+
+uint32_t WorkloadGenerator::getEpoch() const
+{
+    if (driftInterval <= 0) {
+        return 0;
+    }
+
+    return (uint32_t)floor(SIMTIME_DBL(simTime() / driftInterval));
+}
+
+WorkloadGenerator::Operation WorkloadGenerator::nextRequest(uint32_t numKeys,
+                                                            uint32_t& keyId)
+{
+    if (trace != NULL) {
+        WorkloadTrace::Record record = trace->getRecord(tracePos);
+        tracePos = (tracePos + 1) % trace->size();
+        keyId = record.keyId;
+        return (record.op == WORKLOAD_PUT) ? WORKLOAD_PUT : WORKLOAD_GET;
+    }
+
+    keyId = drawIndex(numKeys);
+    return (uniform(0, 1) < readRatio) ? WORKLOAD_GET : WORKLOAD_PUT;
+}
+
+OverlayKey WorkloadGenerator::getKeyForId(uint32_t keyId)
+{
+    std::ostringstream name;
+    name << "key" << keyId;
+
+    return OverlayKey::sha1(BinaryValue(name.str()));
+}
@@ -0,0 +1,198 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file WorkloadGenerator.h
+ * @author agent
+ */
+
+#ifndef __WORKLOADGENERATOR_H__
+#define __WORKLOADGENERATOR_H__
+
+#include <string>
+#include <map>
+
+#include <omnetpp.h>
+
+#include <OverlayKey.h>
+
+/**
+ * Draws ranks from a Zipf distribution with exponent s in O(1) expected
+ * time by rejection-inversion (Hoermann and Derflinger, 1996). No table
+ * is needed, so the number of ranks may change between draws.
+ *
+ * @author agent
+ */
+class ZipfGenerator
+{
+public:
+    ZipfGenerator(double s = 0);
+
+    /**
+     * Returns a rank in [0, n), rank 0 is the most popular one.
+     * s = 0 results in a uniform distribution.
+     *
+     * @param n number of ranks
+     */
+    uint32_t draw(uint32_t n) const;
+
+    double getSkew() const { return s; };
+
+private:
+    double hIntegral(double x) const;
+    double h(double x) const;
+    double hIntegralInverse(double x) const;
+
+    double s;
+    double hIntegralX1;
+    double threshold;
+};
+
+/**
+ * Read-only request trace, which is mapped into memory once and
+ * shared by all nodes replaying it.
+ *
+ * The trace starts with the 8 byte magic "OSWKLD01" followed by
+ * 8 byte records, each consisting of a 32 bit key id and a 32 bit
+ * operation (0 = GET, 1 = PUT) in network byte order.
+ * simulations/tools/workloadtrace.py creates such traces.
+ *
+ * @author agent
+ */
+class WorkloadTrace
+{
+public:
+    struct Record
+    {
+        uint32_t keyId;
+        uint32_t op;
+    };
+
+    /**
+     * Returns the trace for the given file, which is mapped on first use
+     *
+     * @param fileName the trace file
+     */
+    static WorkloadTrace* open(const std::string& fileName);
+
+    /**
+     * Releases a trace returned by open()
+     */
+    static void close(WorkloadTrace* trace);
+
+    size_t size() const { return numRecords; };
+
+    /**
+     * Returns record i in host byte order
+     */
+    Record getRecord(size_t i) const;
+
+private:
+    WorkloadTrace(const std::string& fileName);
+    ~WorkloadTrace();
+
+    static std::map<std::string, WorkloadTrace*> traces;
+
+    std::string fileName;
+    const char* data;
+    size_t length;
+    size_t numRecords;
+    int refCount;
+};
+
+/**
+ * Workload engine for the test applications. Requests are either
+ * generated with Zipf distributed key popularity, which drifts over
+ * time, or replayed from a WorkloadTrace. Each node replays the trace
+ * sequentially from a random start position.
+ *
+ * @author agent
+ */
+class WorkloadGenerator
+{
+public:
+    enum Operation
+    {
+        WORKLOAD_GET = 0,
+        WORKLOAD_PUT = 1
+    };
+
+    WorkloadGenerator();
+    ~WorkloadGenerator();
+
+    /**
+     * Sets the workload parameters
+     *
+     * @param skew Zipf exponent of the key popularity (0 = uniform)
+     * @param driftInterval the popularity ranks are shifted to other keys
+     *                      every driftInterval (0 = no drift)
+     * @param readRatio fraction of GET requests
+     * @param traceFile trace to replay instead of generating requests
+     *                  ("" = no trace)
+     */
+    void initialize(double skew, simtime_t driftInterval, double readRatio,
+                    const std::string& traceFile);
+
+    bool hasTrace() const { return trace != NULL; };
+
+    /**
+     * Draws a rank in [0, n) with the configured popularity distribution.
+     * Popularity drift is applied to the result, so n must not change
+     * between draws (see drawRank() for changing sets of items).
+     *
+     * @param n number of items to choose from
+     */
+    uint32_t drawIndex(uint32_t n);
+
+    /**
+     * Draws a popularity rank in [0, n) without drift. Rank 0 is the
+     * most popular one.
+     *
+     * @param n number of ranks
+     */
+    uint32_t drawRank(uint32_t n) const { return zipf.draw(n); };
+
+    /**
+     * Returns the current popularity drift epoch, 0 if there is no drift
+     */
+    uint32_t getEpoch() const;
+
+    /**
+     * Returns the next request, either generated for a key out of a key
+     * space of size numKeys or replayed from the trace
+     *
+     * @param numKeys size of the key space
+     * @param keyId the key id of the request
+     * @return the operation of the request
+     */
+    Operation nextRequest(uint32_t numKeys, uint32_t& keyId);
+
+    /**
+     * Maps a key id of the workload to an OverlayKey
+     */
+    static OverlayKey getKeyForId(uint32_t keyId);
+
+private:
+    ZipfGenerator zipf;
+    simtime_t driftInterval;
+    double readRatio;
+    WorkloadTrace* trace;
+    size_t tracePos;
+};
+
+#endif
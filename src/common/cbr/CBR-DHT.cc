@@ -438,6 +438,8 @@ void CBRDHT::handleGetCAPIRequest(DHTgetCAPICall* capiGetMsg, int teamnum) {
     // Order possible keys by euclidian distance to this node
     std::vector<OverlayKey> orderedKeys;
     OverlayKey compareKey = overlay->getThisNode().getKey();
+    const std::vector<double> ownCoordinates =
+        ((const Nps&)neighborCache->getNcsAccess()).getOwnCoordinates(); //TODO
 
     while (possibleKeys.size() > 0) {
         OverlayKey bestKey = possibleKeys[0];
@@ -448,11 +450,11 @@ void CBRDHT::handleGetCAPIRequest(DHTgetCAPICall* capiGetMsg, int teamnum) {
             //std::cout << neighborCache->getOwnEuclidianDistanceToKey(possibleKeys[i]) << std::endl;
             if (coordBasedRouting
                     ->getEuclidianDistanceByKeyAndCoords(possibleKeys[i],
-                                                         ((const Nps&)neighborCache->getNcsAccess()).getOwnCoordinates(), //TODO
+                                                         ownCoordinates,
                                                          overlay->getBitsPerDigit()) <
                 coordBasedRouting
                     ->getEuclidianDistanceByKeyAndCoords(bestKey,
-                                                         ((const Nps&)neighborCache->getNcsAccess()).getOwnCoordinates(), //TODO
+                                                         ownCoordinates,
                                                          overlay->getBitsPerDigit())) {
                 bestKey = possibleKeys[i];
                 bestpos = i;
@@ -26,6 +26,7 @@
 #include <BootstrapList.h>
 #include <GlobalParameters.h>
 #include <NeighborCache.h>
+#include <OracleRing.h>
 
 #include <ChordFingerTable.h>
 #include <ChordSuccessorList.h>
@@ -132,6 +133,47 @@ void Chord::joinOverlay()
 }
 
 
+bool Chord::installOracleState(const OracleRing& ring, size_t pos)
+{
+    changeState(INIT);
+
+    long n = ring.size();
+    predecessorNode = ring.at((long)pos - 1);
+
+    if (n == 1) {
+        // first node of the ring
+        successorList->addSuccessor(thisNode);
+    } else {
+        for (long k = 1; k <= std::min((long)successorListSize, n - 1); k++) {
+            successorList->addSuccessor(ring.at(pos + k));
+        }
+    }
+
+    installOracleFingers(ring, pos);
+
+    changeState(READY);
+    updateTooltip();
+
+    return true;
+}
+
+void Chord::installOracleFingers(const OracleRing& ring, size_t pos)
+{
+    OverlayKey offset;
+    for (uint32_t i = 0; i < thisNode.getKey().getLength(); i++) {
+        // only non-trivial fingers, see handleFixFingersTimerExpired()
+        offset = OverlayKey::pow2(i);
+        if (offset > successorList->getSuccessor().getKey() - thisNode.getKey()) {
+            const NodeHandle& finger =
+                ring.at(ring.successor(thisNode.getKey() + offset));
+            if (finger != thisNode) {
+                fingerTable->setFinger(i, finger);
+            }
+        }
+    }
+}
+
+
 void Chord::joinForeignPartition(const NodeHandle &node)
 {
     Enter_Method_Silent();
@@ -200,6 +200,18 @@ protected:
     // see BaseOverlay.h
     virtual void joinForeignPartition(const NodeHandle &node);
 
+    // see BaseOverlay.h
+    virtual bool installOracleState(const OracleRing& ring, size_t pos);
+
+    /**
+     * Sets the fingers to their converged state, called by
+     * installOracleState() after the successor list is set up
+     *
+     * @param ring all nodes sorted by key
+     * @param pos position of this node in ring
+     */
+    virtual void installOracleFingers(const OracleRing& ring, size_t pos);
+
     // see BaseOverlay.h
     virtual bool isSiblingFor(const NodeHandle& node,
                               const OverlayKey& key,
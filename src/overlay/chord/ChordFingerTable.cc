@@ -63,6 +63,21 @@ uint32_t ChordFingerTable::getSize()
     return maxSize;
 }
 
+void ChordFingerTable::reportMemory(MemoryReport& report)
+{
+    double objects = fingerTable.size();
+    double bytes = fingerTable.size() * sizeof(FingerEntry);
+
+    for (std::deque<FingerEntry>::const_iterator it = fingerTable.begin();
+            it != fingerTable.end(); ++it) {
+        objects += it->second.size();
+        bytes += it->second.size() *
+            MemoryReport::treeNodeBytes(sizeof(Successors::value_type));
+    }
+
+    report.add("ChordFingerTable: fingers", objects, bytes);
+}
+
 void ChordFingerTable::setFinger(uint32_t pos, const NodeHandle& node,
                                  Successors const* sucNodes)
 {
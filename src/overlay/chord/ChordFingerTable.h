@@ -31,6 +31,7 @@
 
 #include <NodeVector.h>
 #include <InitStages.h>
+#include <MemoryReport.h>
 
 class BaseOverlay;
 
@@ -49,7 +50,7 @@ class Chord;
  * @author Markus Mauch, Ingmar Baumgart
  * @see Chord
  */
-class ChordFingerTable : public cSimpleModule
+class ChordFingerTable : public cSimpleModule, public MemoryReporter
 {
   public:
 
@@ -115,6 +116,13 @@ class ChordFingerTable : public cSimpleModule
      */
     virtual uint32_t getSize();
 
+    /**
+     * Reports the fingers and their successors
+     *
+     * @param report the memory report
+     */
+    virtual void reportMemory(MemoryReport& report);
+
 private:
 
     uint32_t maxSize; /**< maximum size of the finger table */
@@ -230,6 +230,13 @@ void ChordSuccessorList::updateTooltip()
     }
 }
 
+void ChordSuccessorList::reportMemory(MemoryReport& report)
+{
+    report.add("ChordSuccessorList: successors", successorMap.size(),
+               successorMap.size() * MemoryReport::treeNodeBytes(
+                   sizeof(OverlayKey) + sizeof(SuccessorListEntry)));
+}
+
 void ChordSuccessorList::display()
 {
     cout << "Content of ChordSuccessorList:" << endl;
@@ -30,6 +30,7 @@
 
 #include <InitStages.h>
 #include <NodeHandle.h>
+#include <MemoryReport.h>
 
 class OverlayKey;
 class NotifyResponse;
@@ -55,7 +56,7 @@ std::ostream& operator<<(std::ostream& os, const SuccessorListEntry& e);
  * @author Markus Mauch, Ingmar Baumgart
  * @see Chord
  */
-class ChordSuccessorList : public cSimpleModule
+class ChordSuccessorList : public cSimpleModule, public MemoryReporter
 {
   public:
     virtual int numInitStages() const
@@ -116,6 +117,13 @@ class ChordSuccessorList : public cSimpleModule
 
     void display ();
 
+    /**
+     * Reports the entries of the successor list
+     *
+     * @param report the memory report
+     */
+    virtual void reportMemory(MemoryReport& report);
+
 
   protected:
     NodeHandle thisNode; /**< own node handle */
@@ -170,6 +170,10 @@ void EpiChord::finishOverlay()
 	globalStatistics->addStdDev("EpiChord: Cache live nodes (real)", fingerCache->countRealLive());
 	globalStatistics->addStdDev("EpiChord: Cache dead nodes", fingerCache->countDead());
 	globalStatistics->addStdDev("EpiChord: Cache dead nodes (real)", fingerCache->countRealDead());
+	globalStatistics->addStdDev("EpiChord: Cache expired entries/s", fingerCache->getNumExpired() / time);
+
+	if (fingerCache->getNumSweeps() > 0)
+		globalStatistics->addStdDev("EpiChord: Cache sweep cost", fingerCache->getSweepCost() / (double) fingerCache->getNumSweeps());
 
 	// Estimated node lifetime
 	if (stabilizeEstimation)
@@ -538,16 +542,16 @@ NodeVector* EpiChord::findNode(const OverlayKey& key, int numRedundantNodes, int
 	simtime_t now = simTime();
 	NodeHandle source = NodeHandle::UNSPECIFIED_NODE;
 	std::vector<simtime_t>* lastUpdates = new std::vector<simtime_t>();
-	std::set<NodeHandle>* exclude = new std::set<NodeHandle>();
+	std::set<NodeHandle> exclude;
 	bool err;
 
-	exclude->insert(thisNode);
+	exclude.insert(thisNode);
 
 	if (msg != NULL) {
 		// Add the origin node to the finger cache
 		source = ((FindNodeCall*) msg)->getSrcNode();
 		if (!source.isUnspecified())
-			exclude->insert(source);
+			exclude.insert(source);
 
 		this->receiveNewNode(source, true, OBSERVED, now);
 	}
@@ -602,7 +606,7 @@ NodeVector* EpiChord::findNode(const OverlayKey& key, int numRedundantNodes, int
 		if (entry != NULL) {
 			nextHop->push_back(entry->nodeHandle);
 			lastUpdates->push_back(entry->lastUpdate);
-			exclude->insert(entry->nodeHandle);
+			exclude.insert(entry->nodeHandle);
 		}
 
 		// Add the numRedundantNodes best next hops
@@ -623,7 +627,6 @@ NodeVector* EpiChord::findNode(const OverlayKey& key, int numRedundantNodes, int
 		findNodeExt->setBitLength(EPICHORD_FINDNODEEXTMESSAGE_L(findNodeExt));
 	}
 
-	delete exclude;
 	delete lastUpdates;
 	return nextHop;
 }
@@ -887,17 +890,15 @@ void EpiChord::rpcJoin(EpiChordJoinCall* joinCall)
 		joinResponse->setPreNode(k, predecessorList->getNode(k));
 
 	// Add finger cache
-	int cacheNum = fingerCache->getSize();
+	const CacheMap& cache = fingerCache->getLiveCache();
+	int cacheNum = cache.size();
 	joinResponse->setCacheNodeArraySize(cacheNum);
 	joinResponse->setCacheLastUpdateArraySize(cacheNum);
 
-	for (int k = 0;k < cacheNum;k++) {
-		EpiChordFingerCacheEntry* entry = fingerCache->getNode(k);
-		if (entry == NULL)
-			continue;
-
-		joinResponse->setCacheNode(k, entry->nodeHandle);
-		joinResponse->setCacheLastUpdate(k, entry->lastUpdate);
+	int k = 0;
+	for (CacheMap::const_iterator it = cache.begin();it != cache.end();it++, k++) {
+		joinResponse->setCacheNode(k, it->second.nodeHandle);
+		joinResponse->setCacheLastUpdate(k, it->second.lastUpdate);
 	}
 
 	// Send the response
@@ -63,17 +63,79 @@ void EpiChordFingerCache::initializeCache(NodeHandle owner, EpiChord* overlay, d
 	thisNode = owner;
 	liveCache.clear();
 	deadCache.clear();
+	liveAddresses.clear();
+	expiryQueue = ExpiryQueue();
 
 	successfulUpdates = 0;
+	numSweeps = 0;
+	sweepCost = 0;
+	numExpired = 0;
 }
 
 bool EpiChordFingerCache::contains(const TransportAddress& node)
 {
-	for (CacheMap::iterator it = liveCache.begin();it != liveCache.end();it++)
-		if (node == it->second.nodeHandle)
-			return true;
+	return liveAddresses.find(node) != liveAddresses.end();
+}
+
+bool EpiChordFingerCache::getExpiry(const EpiChordFingerCacheEntry& entry, bool dead, simtime_t& expiry) const
+{
+	if (dead) {
+		expiry = entry.lastUpdate + (entry.ttl * 3);
+		return true;
+	}
+
+	// Live entries without a ttl never expire
+	if (entry.ttl <= 0)
+		return false;
+
+	expiry = entry.lastUpdate + entry.ttl;
+	return true;
+}
+
+void EpiChordFingerCache::scheduleExpiry(const OverlayKey& offset, const EpiChordFingerCacheEntry& entry, bool dead)
+{
+	EpiChordFingerCacheExpiry record;
+	if (!getExpiry(entry, dead, record.expiry))
+		return;
+
+	record.key = offset;
+	record.dead = dead;
+	expiryQueue.push(record);
+
+	// Drop the stale records of refreshed entries
+	if (expiryQueue.size() <= 2 * (liveCache.size() + deadCache.size()) + 64)
+		return;
+
+	expiryQueue = ExpiryQueue();
 
-	return false;
+	for (CacheMap::iterator it = liveCache.begin();it != liveCache.end();it++) {
+		if (!getExpiry(it->second, false, record.expiry))
+			continue;
+
+		record.key = it->first;
+		record.dead = false;
+		expiryQueue.push(record);
+	}
+
+	for (DeadMap::iterator it = deadCache.begin();it != deadCache.end();it++) {
+		getExpiry(it->second, true, record.expiry);
+		record.key = it->first;
+		record.dead = true;
+		expiryQueue.push(record);
+	}
+}
+
+void EpiChordFingerCache::eraseLive(CacheMap::iterator it)
+{
+	std::pair<AddressMap::iterator, AddressMap::iterator> range = liveAddresses.equal_range(it->second.nodeHandle);
+	for (AddressMap::iterator ait = range.first;ait != range.second;ait++) {
+		if (ait->second == it->first) {
+			liveAddresses.erase(ait);
+			break;
+		}
+	}
+
+	liveCache.erase(it);
 }
 
 void EpiChordFingerCache::updateFinger(const NodeHandle& node, bool direct, simtime_t lastUpdate, double ttl, NodeSource source)
@@ -82,7 +144,7 @@ void EpiChordFingerCache::updateFinger(const NodeHandle& node, bool direct, simt
 	if (node.isUnspecified() || node.getKey().isUnspecified() || node == thisNode)
 		return;
 
-	OverlayKey sum = node.getKey() - (thisNode.getKey() + OverlayKey::ONE);
+	OverlayKey sum = getOffset(node.getKey());
 
 	DeadMap::iterator dit = deadCache.find(sum);
 	// We were alerted of a node which recently timed out for us
@@ -99,17 +161,26 @@ void EpiChordFingerCache::updateFinger(const NodeHandle& node, bool direct, simt
 
 	CacheMap::iterator it = liveCache.find(sum);
 	if (it != liveCache.end()) {
+		bool changed = false;
+
 		// Update the existing nodes added time
 		if (lastUpdate < it->second.added)
 			it->second.added = lastUpdate;
 
 		// Update the existing nodes last_update time
-		if (lastUpdate > it->second.lastUpdate)
+		if (lastUpdate > it->second.lastUpdate) {
 			it->second.lastUpdate = lastUpdate;
+			changed = true;
+		}
 
 		// Update the existing nodes ttl
-		if (it->second.ttl > 0 && (ttl > it->second.ttl || ttl == 0))
+		if (it->second.ttl > 0 && (ttl > it->second.ttl || ttl == 0)) {
 			it->second.ttl = ttl;
+			changed = true;
+		}
+
+		if (changed)
+			scheduleExpiry(sum, it->second, false);
 
 		return;
 	}
@@ -124,6 +195,8 @@ void EpiChordFingerCache::updateFinger(const NodeHandle& node, bool direct, simt
 
 //	std::cout << simTime() << ": [" << thisNode.getKey() << "] Adding cache entry: " << entry << std::endl;
 	liveCache[sum] = entry;
+	liveAddresses.insert(std::make_pair(static_cast<const TransportAddress&>(node), sum));
+	scheduleExpiry(sum, entry, false);
 }
 
 void EpiChordFingerCache::setFingerTTL(const NodeHandle& node, double ttl)
@@ -132,65 +205,74 @@ void EpiChordFingerCache::setFingerTTL(const NodeHandle& node, double ttl)
 	if (node.isUnspecified() || node.getKey().isUnspecified())
 		return;
 
-	OverlayKey sum = node.getKey() - (thisNode.getKey() + OverlayKey::ONE);
+	OverlayKey sum = getOffset(node.getKey());
 
 	CacheMap::iterator it = liveCache.find(sum);
-	if (it == liveCache.end())
+	if (it == liveCache.end() || it->second.ttl == ttl)
 		return;
 
 	it->second.ttl = ttl;
+	scheduleExpiry(sum, it->second, false);
 }
 
 bool EpiChordFingerCache::handleFailedNode(const TransportAddress& failed)
 {
 	assert(failed != thisNode);
 
-	simtime_t now = simTime();
+	AddressMap::iterator ait = liveAddresses.find(failed);
+	if (ait == liveAddresses.end())
+		return false;
 
-	for (CacheMap::iterator it = liveCache.begin();it != liveCache.end();it++) {
-		if (failed == it->second.nodeHandle) {
-			it->second.lastUpdate = now;
+	CacheMap::iterator it = liveCache.find(ait->second);
+	assert(it != liveCache.end());
 
-			deadCache[it->first] = it->second;
-			liveCache.erase(it);
-			return true;
-		}
-	}
-	return false;
+	it->second.lastUpdate = simTime();
+
+	EpiChordFingerCacheEntry& entry = deadCache[it->first];
+	entry = it->second;
+	scheduleExpiry(it->first, entry, true);
+
+	eraseLive(it);
+	return true;
 }
 
 void EpiChordFingerCache::removeOldFingers()
 {
 	simtime_t now = simTime();
 
-	for (CacheMap::iterator it = liveCache.begin();it != liveCache.end();) {
-		if (it->second.ttl > 0 && (it->second.lastUpdate + it->second.ttl < now)) {
-//			std::cout << now << ": [" << thisNode.getKey() << "] Removing live cache entry: " << it->second << std::endl;
+	numSweeps++;
 
-			liveCache.erase(it++);
-			continue;
-		}
+	while (!expiryQueue.empty() && expiryQueue.top().expiry < now) {
+		EpiChordFingerCacheExpiry record = expiryQueue.top();
+		expiryQueue.pop();
+		sweepCost++;
 
-		it++;
-	}
+		simtime_t expiry;
+
+		if (record.dead) {
+			DeadMap::iterator it = deadCache.find(record.key);
+			if (it == deadCache.end() || !getExpiry(it->second, true, expiry) || expiry != record.expiry)
+				continue;
 
-	for (DeadMap::iterator it = deadCache.begin();it != deadCache.end();) {
-		if (it->second.lastUpdate + (it->second.ttl * 3) < now) {
 //			std::cout << now << ": [" << thisNode.getKey() << "] Removing dead cache entry: " << it->second << std::endl;
+			deadCache.erase(it);
+		}
+		else {
+			CacheMap::iterator it = liveCache.find(record.key);
+			if (it == liveCache.end() || !getExpiry(it->second, false, expiry) || expiry != record.expiry)
+				continue;
 
-			deadCache.erase(it++);
-			continue;
+//			std::cout << now << ": [" << thisNode.getKey() << "] Removing live cache entry: " << it->second << std::endl;
+			eraseLive(it);
 		}
 
-		it++;
+		numExpired++;
 	}
 }
 
 EpiChordFingerCacheEntry* EpiChordFingerCache::getNode(const NodeHandle& node)
 {
-	OverlayKey sum = node.getKey() - (thisNode.getKey() + OverlayKey::ONE);
-
-	CacheMap::iterator it = liveCache.find(sum);
+	CacheMap::iterator it = liveCache.find(getOffset(node.getKey()));
 	if (it == liveCache.end())
 		return NULL;
 
@@ -208,32 +290,37 @@ EpiChordFingerCacheEntry* EpiChordFingerCache::getNode(uint32_t pos)
 	return &it->second;
 }
 
-std::vector<EpiChordFingerCacheEntry> EpiChordFingerCache::getDeadRange(OverlayKey start, OverlayKey end)
+std::vector<EpiChordFingerCacheEntry> EpiChordFingerCache::getDeadRange(const OverlayKey& start, const OverlayKey& end)
 {
 	std::vector<EpiChordFingerCacheEntry> entries;
 
-	start -= (thisNode.getKey() + OverlayKey::ONE);
-	end -= (thisNode.getKey() + OverlayKey::ONE);
+	OverlayKey startOffset = getOffset(start);
+	OverlayKey endOffset = getOffset(end);
 
-	for (DeadMap::iterator it = deadCache.lower_bound(start);it != deadCache.end();it++) {
-		if (it->first > end)
-			break;
+	// A range from a predecessor to a successor wraps around our own key
+	DeadMap::iterator it = deadCache.lower_bound(startOffset);
+	if (startOffset > endOffset) {
+		for (;it != deadCache.end();it++)
+			entries.push_back(it->second);
 
-		entries.push_back(it->second);
+		it = deadCache.begin();
 	}
 
+	for (;it != deadCache.end() && it->first <= endOffset;it++)
+		entries.push_back(it->second);
+
 	return entries;
 }
 
-uint32_t EpiChordFingerCache::countSlice(OverlayKey start, OverlayKey end)
+uint32_t EpiChordFingerCache::countSlice(const OverlayKey& start, const OverlayKey& end)
 {
 	uint32_t count = 0;
 
-	start -= (thisNode.getKey() + OverlayKey::ONE);
-	end -= (thisNode.getKey() + OverlayKey::ONE);
+	OverlayKey startOffset = getOffset(start);
+	OverlayKey endOffset = getOffset(end);
 
-	for (CacheMap::iterator it = liveCache.lower_bound(start);it != liveCache.end();it++) {
-		if (it->first > end)
+	for (CacheMap::iterator it = liveCache.lower_bound(startOffset);it != liveCache.end();it++) {
+		if (it->first > endOffset)
 			break;
 
 		count++;
@@ -244,9 +331,7 @@ uint32_t EpiChordFingerCache::countSlice(OverlayKey start, OverlayKey end)
 
 bool EpiChordFingerCache::isDead(const NodeHandle& node)
 {
-	OverlayKey sum = node.getKey() - (thisNode.getKey() + OverlayKey::ONE);
-
-	return deadCache.find(sum) != deadCache.end();
+	return deadCache.find(getOffset(node.getKey())) != deadCache.end();
 }
 
 uint32_t EpiChordFingerCache::getSize()
@@ -306,15 +391,16 @@ uint32_t EpiChordFingerCache::countRealDead()
 	return count;
 }
 
-void EpiChordFingerCache::findBestHops(OverlayKey key, NodeVector* nodes, std::vector<simtime_t>* lastUpdates, std::set<NodeHandle>* exclude, int numRedundantNodes)
+void EpiChordFingerCache::findBestHops(const OverlayKey& key, NodeVector* nodes, std::vector<simtime_t>* lastUpdates, const std::set<NodeHandle>& exclude, int numRedundantNodes)
 {
-	key -= thisNode.getKey() + OverlayKey::ONE;
-
 	// Remove any old fingers from the cache so we don't return any expired entries
 	removeOldFingers();
 
+	if (liveCache.empty())
+		return;
+
 	// locate the node we want
-	CacheMap::iterator it = liveCache.lower_bound(key);
+	CacheMap::iterator it = liveCache.lower_bound(getOffset(key));
 	if (it == liveCache.end()) // This shouldn't happen!
 		it = liveCache.begin();
 
@@ -322,7 +408,7 @@ void EpiChordFingerCache::findBestHops(OverlayKey key, NodeVector* nodes, std::v
 	NodeHandle* first = &it->second.nodeHandle;
 
 	// Keep going forwards until we find an alive node
-	while (exclude->find(it->second.nodeHandle) != exclude->end()) {
+	while (exclude.find(it->second.nodeHandle) != exclude.end()) {
 		it++;
 
 		if (it == liveCache.end())
@@ -337,7 +423,7 @@ void EpiChordFingerCache::findBestHops(OverlayKey key, NodeVector* nodes, std::v
 
 	for (int i = 0;i < numRedundantNodes;) {
 		// Add the node
-		if (exclude->find(it->second.nodeHandle) == exclude->end()) {
+		if (exclude.find(it->second.nodeHandle) == exclude.end()) {
 			nodes->push_back(it->second.nodeHandle);
 			lastUpdates->push_back(it->second.lastUpdate);
 			i++;
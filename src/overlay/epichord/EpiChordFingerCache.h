@@ -25,6 +25,8 @@
 #define __EPICHORDFINGERCACHE_H_
 
 #include <map>
+#include <queue>
+#include <functional>
 
 #include <omnetpp.h>
 #include <GlobalNodeList.h>
@@ -48,6 +50,23 @@ struct EpiChordFingerCacheEntry
 
 typedef std::map<OverlayKey, EpiChordFingerCacheEntry> CacheMap;
 typedef std::map<OverlayKey, EpiChordFingerCacheEntry> DeadMap;
+typedef std::multimap<TransportAddress, OverlayKey> AddressMap;
+
+/**
+ * Scheduled expiry of a live or dead cache entry. Records are not
+ * removed when an entry is refreshed, a record is stale if its expiry
+ * no longer matches the entry.
+ */
+struct EpiChordFingerCacheExpiry
+{
+	simtime_t expiry;
+	OverlayKey key;
+	bool dead;
+
+	bool operator>(const EpiChordFingerCacheExpiry& rhs) const { return expiry > rhs.expiry; }
+};
+
+typedef std::priority_queue<EpiChordFingerCacheExpiry, std::vector<EpiChordFingerCacheExpiry>, std::greater<EpiChordFingerCacheExpiry> > ExpiryQueue;
 
 class EpiChord;
 
@@ -91,13 +110,20 @@ public:
 
 	bool handleFailedNode(const TransportAddress& failed);
 
+	/**
+	 * Removes expired live and dead entries
+	 *
+	 * Only the entries at the front of the expiry queue are examined,
+	 * so a sweep costs O(e log n) for e expired entries.
+	 */
 	void removeOldFingers();
 
 	EpiChordFingerCacheEntry* getNode(const NodeHandle& node);
 	EpiChordFingerCacheEntry* getNode(uint32_t pos);
-	std::vector<EpiChordFingerCacheEntry> getDeadRange(OverlayKey start, OverlayKey end);
+	const CacheMap& getLiveCache() const { return liveCache; }
+	std::vector<EpiChordFingerCacheEntry> getDeadRange(const OverlayKey& start, const OverlayKey& end);
 
-	uint32_t countSlice(OverlayKey startOffset, OverlayKey endOffset);
+	uint32_t countSlice(const OverlayKey& start, const OverlayKey& end);
 	bool isDead(const NodeHandle& node);
 
 	virtual uint32_t getSize();
@@ -107,8 +133,16 @@ public:
 	virtual uint32_t countRealDead();
 
 	virtual int getSuccessfulUpdates() { return successfulUpdates; }
+	virtual int getNumSweeps() { return numSweeps; }
+	virtual int getSweepCost() { return sweepCost; }
+	virtual int getNumExpired() { return numExpired; }
 
-	void findBestHops(OverlayKey key, NodeVector* nodes, std::vector<simtime_t>* lastUpdates, std::set<NodeHandle>* exclude, int numRedundantNodes);
+	/**
+	 * Adds the first live node at or after key and its predecessors
+	 * to nodes, skipping excluded nodes. Only the visited entries are
+	 * examined, so the cost is O(log n + numRedundantNodes + |exclude|).
+	 */
+	void findBestHops(const OverlayKey& key, NodeVector* nodes, std::vector<simtime_t>* lastUpdates, const std::set<NodeHandle>& exclude, int numRedundantNodes);
 
 	simtime_t estimateNodeLifetime(int minSampleSize = 5);
 
@@ -116,12 +150,28 @@ public:
 	virtual void display();
 
 protected:
+	OverlayKey getOffset(const OverlayKey& key) const { return key - (thisNode.getKey() + OverlayKey::ONE); }
+
+	/**
+	 * Queues the current expiry of an entry, rebuilds the queue if it
+	 * is dominated by stale records
+	 */
+	void scheduleExpiry(const OverlayKey& offset, const EpiChordFingerCacheEntry& entry, bool dead);
+	bool getExpiry(const EpiChordFingerCacheEntry& entry, bool dead, simtime_t& expiry) const;
+
+	void eraseLive(CacheMap::iterator it);
+
 	CacheMap liveCache;
 	DeadMap deadCache;
+	AddressMap liveAddresses; /**< index of liveCache by transport address */
+	ExpiryQueue expiryQueue;
 	NodeHandle thisNode;
 	EpiChord* overlay;
 	double ttl;
 	int successfulUpdates;
+	int numSweeps;
+	int sweepCost; /**< number of expiry records examined by all sweeps */
+	int numExpired;
 	GlobalNodeList* globalNodeList;
 };
 
@@ -37,6 +37,7 @@
 #include <LookupListener.h>
 #include <RpcMacros.h>
 #include <BootstrapList.h>
+#include <OracleRing.h>
 
 #include <GlobalStatistics.h>
 #include <GlobalStatisticsAccess.h>
@@ -227,6 +228,30 @@ Kademlia::~Kademlia()
     cancelAndDelete(routingTableStatsTimer);
 }
 
+void Kademlia::reportMemory(MemoryReport& report)
+{
+    BaseOverlay::reportMemory(report);
+
+    // buckets are created on demand
+    double objects = 0;
+    double bytes = routingTable.capacity() * sizeof(KademliaBucket*);
+
+    for (uint32_t i = 0; i <= routingTable.size(); i++) {
+        const KademliaBucket* bucket = (i < routingTable.size()) ?
+            routingTable[i] : siblingTable;
+        if (bucket == NULL) {
+            continue;
+        }
+        objects += bucket->size() + bucket->replacementCache.size();
+        bytes += sizeof(KademliaBucket) +
+                 bucket->capacity() * sizeof(KademliaBucketEntry) +
+                 bucket->replacementCache.size() *
+                 MemoryReport::listNodeBytes(sizeof(KademliaBucketEntry));
+    }
+
+    report.add("KademliaBucket: entries", objects, bytes);
+}
+
 void Kademlia::finishOverlay()
 {
     simtime_t time = globalStatistics->calcMeasuredLifetime(creationTime);
@@ -302,6 +327,98 @@ void Kademlia::joinOverlay()
     }
 }
 
+/**
+ * Orders NodeHandles by their XOR distance to a key
+ */
+class XorDistanceLess
+{
+public:
+    XorDistanceLess(const OverlayKey& key) : key(key) {};
+
+    bool operator()(const NodeHandle& a, const NodeHandle& b) const
+    {
+        return (a.getKey() ^ key) < (b.getKey() ^ key);
+    }
+
+private:
+    OverlayKey key;
+};
+
+bool Kademlia::installOracleState(const OracleRing& ring, size_t pos)
+{
+    // nodes in buckets have to be authenticated or pinged first
+    if (secureMaintenance || activePing) {
+        return false;
+    }
+
+    if (!thisNode.getKey().isUnspecified()) {
+        bootstrapList->removeBootstrapNode(thisNode);
+    }
+
+    routingDeinit();
+    routingInit();
+
+    const OverlayKey& ownKey = thisNode.getKey();
+    size_t first, last;
+
+    // siblings: the s closest nodes all share the longest prefix
+    // with ownKey, whose range contains more than s nodes
+    uint32_t prefixLength = OverlayKey::getLength();
+    do {
+        ring.prefixRange(ownKey, prefixLength, first, last);
+    } while ((last - first) <= s && prefixLength-- > 0);
+
+    std::vector<NodeHandle> siblings;
+    for (size_t i = first; i < last; i++) {
+        if (ring.at(i) != thisNode) {
+            siblings.push_back(ring.at(i));
+        }
+    }
+    size_t numSiblings = std::min(siblings.size(), (size_t)s);
+    std::partial_sort(siblings.begin(), siblings.begin() + numSiblings,
+                      siblings.end(), XorDistanceLess(ownKey));
+    for (size_t i = 0; i < numSiblings; i++) {
+        routingAdd(siblings[i], true);
+    }
+
+    // buckets: up to k nodes for every digit that differs from ownKey
+    for (int i = OverlayKey::getLength() - b; i >= 0; i -= b) {
+        for (uint32_t d = 0; d < (1U << b); d++) {
+            if (d == ownKey.getBitRange(i, b)) {
+                continue;
+            }
+
+            OverlayKey bucketKey = ownKey;
+            for (uint32_t bit = 0; bit < b; bit++) {
+                bucketKey.setBit(i + bit, (d >> bit) & 1);
+            }
+
+            ring.prefixRange(bucketKey, OverlayKey::getLength() - i,
+                             first, last);
+            for (size_t j = first; j < last && j - first < k; j++) {
+                routingAdd(ring.at(j), true);
+            }
+            if (last > first) {
+                setBucketUsage(bucketKey);
+            }
+        }
+    }
+
+    state = READY;
+    setOverlayReady(true);
+    siblingTable->setLastUsage(simTime());
+
+    // the routing table is converged, so start with the regular intervals
+    cancelEvent(bucketRefreshTimer);
+    scheduleAt(simTime() + minSiblingTableRefreshInterval, bucketRefreshTimer);
+    cancelEvent(bucketPingTimer);
+    scheduleAt(simTime() + bucketPingInterval, bucketPingTimer);
+    cancelEvent(siblingPingTimer);
+    scheduleAt(simTime() + siblingPingInterval, siblingPingTimer);
+
+    return true;
+}
+
 //-----------------------------------------------------------------------------
 
 void Kademlia::routingInit()
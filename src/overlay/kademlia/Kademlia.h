@@ -129,8 +129,12 @@ public:
 
     void finishOverlay();
 
+    void reportMemory(MemoryReport& report);
+
     void joinOverlay();
 
+    bool installOracleState(const OracleRing& ring, size_t pos);
+
     bool isSiblingFor(const NodeHandle& node,const OverlayKey& key,
                       int numSiblings, bool* err );
 
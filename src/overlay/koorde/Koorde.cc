@@ -25,6 +25,7 @@
 #include <IInterfaceTable.h>
 #include <IPv4InterfaceData.h>
 #include <GlobalStatistics.h>
+#include <OracleRing.h>
 
 #include "Koorde.h"
 
@@ -116,6 +117,39 @@ void Koorde::changeState(int toState)
 
 }
 
+bool Koorde::installOracleState(const OracleRing& ring, size_t pos)
+{
+    Chord::installOracleState(ring, pos);
+
+    // the de Bruijn list is already converged
+    cancelEvent(deBruijn_timer);
+    scheduleAt(simTime() + deBruijnDelay, deBruijn_timer);
+
+    return true;
+}
+
+void Koorde::installOracleFingers(const OracleRing& ring, size_t pos)
+{
+    // same lookup key as in handleDeBruijnTimerExpired()
+    OverlayKey lookup = thisNode.getKey() << shiftingBits;
+    lookup -= (successorList->getSuccessor(successorList->getSize() /
+                                      2).getKey() - thisNode.getKey());
+
+    // the de Bruijn node is the predecessor of lookup, the list contains
+    // the node responsible for lookup and its successors
+    // (see handleRpcDeBruijnRequest())
+    size_t responsible = ring.successor(lookup);
+    deBruijnNode = ring.at((long)responsible - 1);
+
+    int sucNum = std::min((size_t)deBruijnListSize,
+                          std::min((size_t)successorList->getSize() + 1,
+                                   ring.size()));
+    for (int i = 0; i < sucNum; i++) {
+        deBruijnNodes[i] = ring.at(responsible + i);
+        deBruijnNumber = i+1;
+    }
+}
+
 void Koorde::handleTimerEvent(cMessage* msg)
 {
     if (msg->isName("deBruijn_timer")) {
@@ -102,6 +102,17 @@ class Koorde : public Chord
      */
     virtual void changeState(int state);
 
+    // see BaseOverlay.h
+    virtual bool installOracleState(const OracleRing& ring, size_t pos);
+
+    /**
+     * Sets the de Bruijn node and list instead of the Chord fingers
+     *
+     * @param ring all nodes sorted by key
+     * @param pos position of this node in ring
+     */
+    virtual void installOracleFingers(const OracleRing& ring, size_t pos);
+
     /**
      * handle an expired de bruijn timer
      *
@@ -548,21 +548,32 @@ void BasePastry::determineAliveTable(const PastryStateMessage* stateMsg)
     aliveTable.pr_ns.clear();
     aliveTable.pr_ns.resize(ns_size, 1);
 
+    std::vector<TransportAddress> nodes;
+    nodes.reserve(rt_size + ls_size + ns_size);
+    for (uint32_t i = 0; i < rt_size; i++) {
+        nodes.push_back(stateMsg->getRoutingTable(i));
+    }
+    for (uint32_t i = 0; i < ls_size; i++) {
+        nodes.push_back(stateMsg->getLeafSet(i));
+    }
+    for (uint32_t i = 0; i < ns_size; i++) {
+        nodes.push_back(stateMsg->getNeighborhoodSet(i));
+    }
+
+    std::vector<Prox> proxs;
+    neighborCache->getProxBatch(nodes, proxs,
+                                NEIGHBORCACHE_DEFAULT_IMMEDIATELY);
+
     for (uint32_t i = 0; i < rt_size + ls_size + ns_size; i++) {
-        const TransportAddress* node;
         std::vector<simtime_t>::iterator tblPos;
         if (i < rt_size) {
-            node = &(stateMsg->getRoutingTable(i));
             tblPos = aliveTable.pr_rt.begin() + i;
         } else if ( i < (rt_size + ls_size) ) {
-            node = &(stateMsg->getLeafSet(i - rt_size));
             tblPos = aliveTable.pr_ls.begin() + (i - rt_size);
         } else {
-            node = &(stateMsg->getNeighborhoodSet(i - rt_size - ls_size));
             tblPos = aliveTable.pr_ns.begin() + (i - rt_size - ls_size);
         }
-        if (neighborCache->getProx(*node, NEIGHBORCACHE_DEFAULT_IMMEDIATELY) ==
-                Prox::PROX_TIMEOUT) {
+        if (proxs[i] == Prox::PROX_TIMEOUT) {
             *tblPos = PASTRY_PROX_INFINITE;
         }
     }
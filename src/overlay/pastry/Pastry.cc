@@ -32,6 +32,7 @@
 #include <RpcMacros.h>
 #include <InitStages.h>
 #include <GlobalStatistics.h>
+#include <OracleRing.h>
 
 #include "Pastry.h"
 
@@ -218,6 +219,56 @@ void Pastry::changeState(int toState)
 }
 
 
+bool Pastry::installOracleState(const OracleRing& ring, size_t pos)
+{
+    changeState(INIT);
+
+    const OverlayKey& ownKey = thisNode.getKey();
+    long n = ring.size();
+
+    // leaf set: the numberOfLeaves/2 nodes on each side of the ring
+    for (long i = 1; i <= std::min((long)numberOfLeaves / 2, n - 1); i++) {
+        leafSet->mergeNode(ring.at((long)pos + i), PASTRY_PROX_UNDEF);
+        leafSet->mergeNode(ring.at((long)pos - i), PASTRY_PROX_UNDEF);
+    }
+
+    // routing table: a random node with the matching prefix for every entry
+    size_t first, last;
+    for (uint32_t row = 0; row * bitsPerDigit < OverlayKey::getLength();
+         row++) {
+        // no other nodes share the first row digits with this node
+        ring.prefixRange(ownKey, row * bitsPerDigit, first, last);
+        if (last - first <= 1) break;
+
+        uint32_t digitPos = OverlayKey::getLength() - bitsPerDigit * (row + 1);
+        for (uint32_t d = 0; d < (1U << bitsPerDigit); d++) {
+            if (d == ownKey.getBitRange(digitPos, bitsPerDigit)) continue;
+
+            OverlayKey entryKey = ownKey;
+            for (uint32_t bit = 0; bit < bitsPerDigit; bit++) {
+                entryKey.setBit(digitPos + bit, (d >> bit) & 1);
+            }
+
+            ring.prefixRange(entryKey, bitsPerDigit * (row + 1), first, last);
+            if (last > first) {
+                routingTable->mergeNode(ring.at(intuniform(first, last - 1)),
+                                        PASTRY_PROX_UNDEF);
+            }
+        }
+    }
+
+    changeState(READY);
+
+    // all nodes are converged, so there is no need for a join update
+    notifyList.clear();
+    cancelEvent(joinUpdateWait);
+
+    updateTooltip();
+
+    return true;
+}
+
+
 void Pastry::pingResponse(PingResponse* pingResponse,
                           cPolymorphic* context, int rpcId,
                           simtime_t rtt)
@@ -171,6 +171,9 @@ class Pastry : public BasePastry
     // see BaseOverlay.h
     virtual void joinOverlay();
 
+    // see BaseOverlay.h
+    virtual bool installOracleState(const OracleRing& ring, size_t pos);
+
 };
 
 
@@ -409,6 +409,14 @@ bool PastryLeafSet::balanceLeafSet()
     return false; // should not happen
 }
 
+void PastryLeafSet::reportMemory(MemoryReport& report)
+{
+    report.add("PastryLeafSet: leaves", leaves.size(),
+               leaves.capacity() * sizeof(NodeHandle) +
+               awaitingRepair.size() * MemoryReport::treeNodeBytes(
+                   sizeof(TransportAddress) + sizeof(PLSRepairData)));
+}
+
 void PastryLeafSet::dumpToVector(std::vector<TransportAddress>& affected) const
 {
     std::vector<NodeHandle>::const_iterator it;
@@ -181,6 +181,13 @@ class PastryLeafSet : public PastryStateObject
      */
     virtual void dumpToVector(std::vector<TransportAddress>& affected) const;
 
+    /**
+     * Reports the entries of this state object
+     *
+     * @param report the memory report
+     */
+    virtual void reportMemory(MemoryReport& report);
+
     NodeVector* createSiblingVector(const OverlayKey& key, int numSiblings) const;
 
 
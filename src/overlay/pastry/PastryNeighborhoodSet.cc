@@ -125,6 +125,12 @@ bool PastryNeighborhoodSet::mergeNode(const NodeHandle& node, simtime_t prox)
     return !nodeAlreadyInVector && nodeValueWasChanged; // return whether a new entry was added
 }
 
+void PastryNeighborhoodSet::reportMemory(MemoryReport& report)
+{
+    report.add("PastryNeighborhoodSet: neighbors", neighbors.size(),
+               neighbors.capacity() * sizeof(PastryExtendedNode));
+}
+
 void PastryNeighborhoodSet::dumpToVector(std::vector<TransportAddress>& affected) const
 {
     std::vector<PastryExtendedNode>::const_iterator it;
@@ -99,6 +99,13 @@ class PastryNeighborhoodSet : public PastryStateObject
      */
     virtual void dumpToVector(std::vector<TransportAddress>& affected) const;
 
+    /**
+     * Reports the entries of this state object
+     *
+     * @param report the memory report
+     */
+    virtual void reportMemory(MemoryReport& report);
+
     /**
      * tell the neighborhood set about a failed node
      *
@@ -348,6 +348,21 @@ bool PastryRoutingTable::initStateFromHandleVector(const std::vector<PastryState
     return true;
 }
 
+void PastryRoutingTable::reportMemory(MemoryReport& report)
+{
+    double objects = 0;
+    double bytes = rows.capacity() * sizeof(PRTRow) +
+                   awaitingRepair.capacity() * sizeof(PRTTrackRepair);
+
+    for (std::vector<PRTRow>::const_iterator it = rows.begin();
+            it != rows.end(); ++it) {
+        objects += it->size();
+        bytes += it->capacity() * sizeof(PastryExtendedNode);
+    }
+
+    report.add("PastryRoutingTable: entries", objects, bytes);
+}
+
 void PastryRoutingTable::dumpToVector(std::vector<TransportAddress>& affected)
 const
 {
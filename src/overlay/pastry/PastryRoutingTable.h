@@ -183,6 +183,13 @@ class PastryRoutingTable : public PastryStateObject
      */
     virtual void dumpToVector(std::vector<TransportAddress>& affected) const;
 
+    /**
+     * Reports the entries of this state object
+     *
+     * @param report the memory report
+     */
+    virtual void reportMemory(MemoryReport& report);
+
     /**
      * returns routing table entry at specified position
      *
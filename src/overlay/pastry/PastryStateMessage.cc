@@ -0,0 +1,70 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file PastryStateMessage.cc
+ * @author agent
+ */
+
+#include <omnetpp.h>
+#include "PastryMessage_m.h"
+#include "PastryStateMessage.h"
+
+Register_Class(PastryStateMessage);
+Register_Class(PastryLeafsetMessage);
+Register_Class(PastryRoutingRowMessage);
+
+void PastryStateMessage::parsimPack(cCommBuffer *b)
+{
+    PastryStateMessage_Base::parsimPack(b);
+    doPacking(b, routingTable);
+    doPacking(b, leafSet);
+    doPacking(b, neighborhoodSet);
+}
+
+void PastryStateMessage::parsimUnpack(cCommBuffer *b)
+{
+    PastryStateMessage_Base::parsimUnpack(b);
+    doUnpacking(b, routingTable);
+    doUnpacking(b, leafSet);
+    doUnpacking(b, neighborhoodSet);
+}
+
+void PastryLeafsetMessage::parsimPack(cCommBuffer *b)
+{
+    PastryLeafsetMessage_Base::parsimPack(b);
+    doPacking(b, leafSet);
+}
+
+void PastryLeafsetMessage::parsimUnpack(cCommBuffer *b)
+{
+    PastryLeafsetMessage_Base::parsimUnpack(b);
+    doUnpacking(b, leafSet);
+}
+
+void PastryRoutingRowMessage::parsimPack(cCommBuffer *b)
+{
+    PastryRoutingRowMessage_Base::parsimPack(b);
+    doPacking(b, routingTable);
+}
+
+void PastryRoutingRowMessage::parsimUnpack(cCommBuffer *b)
+{
+    PastryRoutingRowMessage_Base::parsimUnpack(b);
+    doUnpacking(b, routingTable);
+}
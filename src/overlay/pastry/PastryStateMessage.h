@@ -0,0 +1,113 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file PastryStateMessage.h
+ * @author agent
+ */
+
+#ifndef __PASTRYSTATEMESSAGE_H_
+#define __PASTRYSTATEMESSAGE_H_
+
+#include <NodeHandleList.h>
+#include "PastryMessage_m.h"
+
+/**
+ * Pastry state transfer messages with the NodeHandle arrays stored
+ * in NodeHandleLists
+ *
+ * This header is included by PastryMessage_m.h.
+ *
+ * @author agent
+ */
+class PastryStateMessage : public PastryStateMessage_Base
+{
+public:
+    PastryStateMessage(const char *name=NULL, int kind=0) : PastryStateMessage_Base(name,kind) {}
+    PastryStateMessage(const PastryStateMessage& other) : PastryStateMessage_Base(other.getName()) {operator=(other);}
+    PastryStateMessage& operator=(const PastryStateMessage& other)
+    {
+        if (this == &other) return *this;
+        PastryStateMessage_Base::operator=(other);
+        routingTable = other.routingTable;
+        leafSet = other.leafSet;
+        neighborhoodSet = other.neighborhoodSet;
+        return *this;
+    }
+    virtual PastryStateMessage *dup() const {return new PastryStateMessage(*this);}
+
+    virtual void parsimPack(cCommBuffer *b);
+    virtual void parsimUnpack(cCommBuffer *b);
+
+    NODEHANDLELIST_ACCESSORS(RoutingTable, routingTable)
+    NODEHANDLELIST_ACCESSORS(LeafSet, leafSet)
+    NODEHANDLELIST_ACCESSORS(NeighborhoodSet, neighborhoodSet)
+
+protected:
+    NodeHandleList routingTable;
+    NodeHandleList leafSet;
+    NodeHandleList neighborhoodSet;
+};
+
+class PastryLeafsetMessage : public PastryLeafsetMessage_Base
+{
+public:
+    PastryLeafsetMessage(const char *name=NULL, int kind=0) : PastryLeafsetMessage_Base(name,kind) {}
+    PastryLeafsetMessage(const PastryLeafsetMessage& other) : PastryLeafsetMessage_Base(other.getName()) {operator=(other);}
+    PastryLeafsetMessage& operator=(const PastryLeafsetMessage& other)
+    {
+        if (this == &other) return *this;
+        PastryLeafsetMessage_Base::operator=(other);
+        leafSet = other.leafSet;
+        return *this;
+    }
+    virtual PastryLeafsetMessage *dup() const {return new PastryLeafsetMessage(*this);}
+
+    virtual void parsimPack(cCommBuffer *b);
+    virtual void parsimUnpack(cCommBuffer *b);
+
+    NODEHANDLELIST_ACCESSORS(LeafSet, leafSet)
+
+protected:
+    NodeHandleList leafSet;
+};
+
+class PastryRoutingRowMessage : public PastryRoutingRowMessage_Base
+{
+public:
+    PastryRoutingRowMessage(const char *name=NULL, int kind=0) : PastryRoutingRowMessage_Base(name,kind) {}
+    PastryRoutingRowMessage(const PastryRoutingRowMessage& other) : PastryRoutingRowMessage_Base(other.getName()) {operator=(other);}
+    PastryRoutingRowMessage& operator=(const PastryRoutingRowMessage& other)
+    {
+        if (this == &other) return *this;
+        PastryRoutingRowMessage_Base::operator=(other);
+        routingTable = other.routingTable;
+        return *this;
+    }
+    virtual PastryRoutingRowMessage *dup() const {return new PastryRoutingRowMessage(*this);}
+
+    virtual void parsimPack(cCommBuffer *b);
+    virtual void parsimUnpack(cCommBuffer *b);
+
+    NODEHANDLELIST_ACCESSORS(RoutingTable, routingTable)
+
+protected:
+    NodeHandleList routingTable;
+};
+
+#endif
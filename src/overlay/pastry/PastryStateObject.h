@@ -31,6 +31,7 @@
 
 #include <NodeHandle.h>
 #include <NodeVector.h>
+#include <MemoryReport.h>
 
 #include "PastryTypes.h"
 #include "PastryMessage_m.h"
@@ -44,7 +45,7 @@
  * @author Felix Palmen
  * @see PastryRoutingTable, LeafSet, NeighborhoodSet
  */
-class PastryStateObject : public cSimpleModule
+class PastryStateObject : public cSimpleModule, public MemoryReporter
 {
   public:
 
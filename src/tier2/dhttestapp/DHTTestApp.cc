@@ -69,6 +69,20 @@ void DHTTestApp::initializeApp(int stage)
         ttl = par("testTtl");
     }
 
+    readRatio = par("readRatio");
+    workload.initialize(par("keySkew"), par("keyDriftInterval"), readRatio,
+                        par("workloadTrace").stdstringValue());
+
+    // trace requests and modifications (if readRatio is set) are
+    // sent by the get timer, which is adapted to keep the request rate
+    if (workload.hasTrace()) {
+        getMean = mean / 3;
+    } else if (readRatio >= 0) {
+        getMean = mean / 2;
+    } else {
+        getMean = mean;
+    }
+
     globalNodeList = GlobalNodeListAccess().get();
     underlayConfigurator = UnderlayConfiguratorAccess().get();
     globalStatistics = GlobalStatisticsAccess().get();
@@ -107,14 +121,18 @@ void DHTTestApp::initializeApp(int stage)
     dhttestmod_timer = new cMessage("dhttest_mod_timer");
 
     if (mean > 0) {
-        scheduleAt(simTime() + truncnormal(mean, deviation),
-                   dhttestput_timer);
+        if (!workload.hasTrace()) {
+            scheduleAt(simTime() + truncnormal(mean, deviation),
+                       dhttestput_timer);
+        }
         scheduleAt(simTime() + truncnormal(mean + mean / 3,
                                                       deviation),
                                                       dhttestget_timer);
-        scheduleAt(simTime() + truncnormal(mean + 2 * mean / 3,
-                                                      deviation),
-                                                      dhttestmod_timer);
+        if (!workload.hasTrace() && (readRatio < 0)) {
+            scheduleAt(simTime() + truncnormal(mean + 2 * mean / 3,
+                                                          deviation),
+                                                          dhttestmod_timer);
+        }
     }
 }
 
@@ -161,6 +179,9 @@ void DHTTestApp::handlePutResponse(DHTputCAPIResponse* msg,
     if (msg->getIsSuccess()) {
         RECORD_STATS(numPutSuccess++);
         RECORD_STATS(globalStatistics->addStdDev("DHTTestApp: PUT Latency (s)",
+                               SIMTIME_DBL(simTime() - context->requestTime));
+                     globalStatistics->recordPercentiles(
+                               "DHTTestApp: PUT Latency (s)",
                                SIMTIME_DBL(simTime() - context->requestTime)));
     } else {
         RECORD_STATS(numPutError++);
@@ -180,6 +201,9 @@ void DHTTestApp::handleGetResponse(DHTgetCAPIResponse* msg,
     }
 
     RECORD_STATS(globalStatistics->addStdDev("DHTTestApp: GET Latency (s)",
+                               SIMTIME_DBL(simTime() - context->requestTime));
+                 globalStatistics->recordPercentiles(
+                               "DHTTestApp: GET Latency (s)",
                                SIMTIME_DBL(simTime() - context->requestTime)));
 
     if (!(msg->getIsSuccess())) {
@@ -192,6 +216,12 @@ void DHTTestApp::handleGetResponse(DHTgetCAPIResponse* msg,
     const DHTEntry* entry = globalDhtTestMap->findEntry(context->key);
 
     if (entry == NULL) {
+        if (workload.hasTrace() && (msg->getResultArraySize() == 0)) {
+            // traces may contain GETs for keys that were never stored
+            RECORD_STATS(numGetSuccess++);
+            delete context;
+            return;
+        }
         //unexpected key
         RECORD_STATS(numGetError++);
         //cout << "DHTTestApp: unexpected key" << endl;
@@ -307,17 +337,7 @@ void DHTTestApp::handleTimerEvent(cMessage* msg)
             if (globalDhtTestMap->p2pnsNameCount < 4*globalNodeList->getNumNodes()) {
                 for (int i = 0; i < 4; i++) {
                     // create a put test message with random destination key
-                    OverlayKey destKey = OverlayKey::random();
-                    DHTputCAPICall* dhtPutMsg = new DHTputCAPICall();
-                    dhtPutMsg->setKey(destKey);
-                    dhtPutMsg->setValue(generateRandomValue());
-                    dhtPutMsg->setTtl(ttl);
-                    dhtPutMsg->setIsModifiable(true);
-
-                    RECORD_STATS(numSent++; numPutSent++);
-                    sendInternalRpcCall(TIER1_COMP, dhtPutMsg,
-                            new DHTStatsContext(globalStatistics->isMeasuring(),
-                                                simTime(), destKey, dhtPutMsg->getValue()));
+                    sendPutRequest(OverlayKey::random());
                     globalDhtTestMap->p2pnsNameCount++;
                 }
             }
@@ -326,19 +346,9 @@ void DHTTestApp::handleTimerEvent(cMessage* msg)
         }
 
         // create a put test message with random destination key
-        OverlayKey destKey = OverlayKey::random();
-        DHTputCAPICall* dhtPutMsg = new DHTputCAPICall();
-        dhtPutMsg->setKey(destKey);
-        dhtPutMsg->setValue(generateRandomValue());
-        dhtPutMsg->setTtl(ttl);
-        dhtPutMsg->setIsModifiable(true);
-
-        RECORD_STATS(numSent++; numPutSent++);
-        sendInternalRpcCall(TIER1_COMP, dhtPutMsg,
-                new DHTStatsContext(globalStatistics->isMeasuring(),
-                                    simTime(), destKey, dhtPutMsg->getValue()));
+        sendPutRequest(OverlayKey::random());
     } else if (msg->isName("dhttest_get_timer")) {
-        scheduleAt(simTime() + truncnormal(mean, deviation), msg);
+        scheduleAt(simTime() + truncnormal(getMean, getMean / 10), msg);
 
         // do nothing if the network is still in the initialization phase
         if (((!activeNetwInitPhase) && (underlayConfigurator->isInInitPhase()))
@@ -347,11 +357,23 @@ void DHTTestApp::handleTimerEvent(cMessage* msg)
             return;
         }
 
+        if (workload.hasTrace()) {
+            // replay the next request of the trace
+            uint32_t keyId;
+            if (workload.nextRequest(0, keyId) ==
+                    WorkloadGenerator::WORKLOAD_PUT) {
+                sendPutRequest(WorkloadGenerator::getKeyForId(keyId));
+            } else {
+                sendGetRequest(WorkloadGenerator::getKeyForId(keyId));
+            }
+            return;
+        }
+
         if (p2pnsTraffic && (uniform(0, 1) > ((double)mean/1800.0))) {
             return;
         }
 
-        const OverlayKey& key = globalDhtTestMap->getRandomKey();
+        OverlayKey key = getRandomKey();
 
         if (key.isUnspecified()) {
             EV << "[DHTTestApp::handleTimerEvent() @ " << thisNode.getIp()
@@ -361,13 +383,12 @@ void DHTTestApp::handleTimerEvent(cMessage* msg)
             return;
         }
 
-        DHTgetCAPICall* dhtGetMsg = new DHTgetCAPICall();
-        dhtGetMsg->setKey(key);
-        RECORD_STATS(numSent++; numGetSent++);
-
-        sendInternalRpcCall(TIER1_COMP, dhtGetMsg,
-                new DHTStatsContext(globalStatistics->isMeasuring(),
-                                    simTime(), key));
+        if ((readRatio >= 0) && (uniform(0, 1) >= readRatio)) {
+            // modify the record instead of reading it
+            sendPutRequest(key);
+        } else {
+            sendGetRequest(key);
+        }
     } else if (msg->isName("dhttest_mod_timer")) {
         scheduleAt(simTime() + truncnormal(mean, deviation), msg);
 
@@ -380,45 +401,65 @@ void DHTTestApp::handleTimerEvent(cMessage* msg)
 
         if (p2pnsTraffic) {
             if (globalDhtTestMap->p2pnsNameCount >= 4*globalNodeList->getNumNodes()) {
-                const OverlayKey& key = globalDhtTestMap->getRandomKey();
+                OverlayKey key = getRandomKey();
 
                 if (key.isUnspecified())
                     return;
 
-                DHTputCAPICall* dhtPutMsg = new DHTputCAPICall();
-                dhtPutMsg->setKey(key);
-                dhtPutMsg->setValue(generateRandomValue());
-                dhtPutMsg->setTtl(ttl);
-                dhtPutMsg->setIsModifiable(true);
-
-                RECORD_STATS(numSent++; numPutSent++);
-                sendInternalRpcCall(TIER1_COMP, dhtPutMsg,
-                        new DHTStatsContext(globalStatistics->isMeasuring(),
-                                            simTime(), key, dhtPutMsg->getValue()));
+                sendPutRequest(key);
             }
             cancelEvent(msg);
             return;
         }
 
-        const OverlayKey& key = globalDhtTestMap->getRandomKey();
+        OverlayKey key = getRandomKey();
 
         if (key.isUnspecified())
             return;
 
-        DHTputCAPICall* dhtPutMsg = new DHTputCAPICall();
-        dhtPutMsg->setKey(key);
-        dhtPutMsg->setValue(generateRandomValue());
-        dhtPutMsg->setTtl(ttl);
-        dhtPutMsg->setIsModifiable(true);
+        sendPutRequest(key);
+    }
+}
 
-        RECORD_STATS(numSent++; numPutSent++);
-        sendInternalRpcCall(TIER1_COMP, dhtPutMsg,
-                new DHTStatsContext(globalStatistics->isMeasuring(),
-                                    simTime(), key, dhtPutMsg->getValue()));
+OverlayKey DHTTestApp::getRandomKey()
+{
+    if (globalDhtTestMap->size() == 0) {
+        return OverlayKey::UNSPECIFIED_KEY;
     }
+
+    // ranks are bound to keys by the map, independent of erased keys
+    return globalDhtTestMap->getKeyByRank(
+               workload.drawRank(globalDhtTestMap->size()),
+               workload.getEpoch());
+}
+
+void DHTTestApp::sendPutRequest(const OverlayKey& key)
+{
+    DHTputCAPICall* dhtPutMsg = new DHTputCAPICall();
+    dhtPutMsg->setKey(key);
+    dhtPutMsg->setValue(generateRandomValue());
+    dhtPutMsg->setTtl(ttl);
+    dhtPutMsg->setIsModifiable(true);
+
+    RECORD_STATS(numSent++; numPutSent++);
+    sendInternalRpcCall(TIER1_COMP, dhtPutMsg,
+            new DHTStatsContext(globalStatistics->isMeasuring(),
+                                simTime(), key, dhtPutMsg->getValue()));
+}
+
+void DHTTestApp::sendGetRequest(const OverlayKey& key)
+{
+    DHTgetCAPICall* dhtGetMsg = new DHTgetCAPICall();
+    dhtGetMsg->setKey(key);
+    RECORD_STATS(numSent++; numGetSent++);
+
+    sendInternalRpcCall(TIER1_COMP, dhtGetMsg,
+            new DHTStatsContext(globalStatistics->isMeasuring(),
+                                simTime(), key));
 }
 
 
+
 BinaryValue DHTTestApp::generateRandomValue()
 {
     char value[DHTTESTAPP_VALUE_LEN + 1];
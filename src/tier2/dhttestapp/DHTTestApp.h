@@ -34,6 +34,7 @@
 #include <InitStages.h>
 #include <BinaryValue.h>
 #include <BaseApp.h>
+#include <WorkloadGenerator.h>
 #include <set>
 #include <sstream>
 
@@ -75,10 +76,21 @@ private:
     void initializeApp(int stage);
 
     /**
-     * Get a random key of the hashmap
+     * Get a random key of the hashmap with the configured popularity
+     * distribution
      */
     OverlayKey getRandomKey();
 
+    /**
+     * Sends a put request with a random value for key
+     */
+    void sendPutRequest(const OverlayKey& key);
+
+    /**
+     * Sends a get request for key
+     */
+    void sendGetRequest(const OverlayKey& key);
+
     /**
      * generate a random human readable binary value
      */
@@ -143,9 +155,12 @@ private:
     bool debugOutput; /**< debug output yes/no?*/
     double mean; //!< mean time interval between sending test messages
     double deviation; //!< deviation of time interval
+    double getMean; //!< mean time interval of the get timer
     int ttl; /**< ttl for stored DHT records */
     bool p2pnsTraffic; //!< model p2pns application traffic */
     bool activeNetwInitPhase; //!< is app active in network init phase?
+    double readRatio; //!< fraction of GETs among GET and modify requests
+    WorkloadGenerator workload; //!< key popularity and request trace
 
     // statistics
     int numSent; /**< number of sent packets*/
@@ -21,6 +21,8 @@
  * @author Ingmar Baumgart
  */
 
+#include <algorithm>
+
 #include <omnetpp.h>
 
 #include <GlobalStatisticsAccess.h>
@@ -42,12 +44,17 @@ std::ostream& operator<<(std::ostream& stream, const DHTEntry entry)
 GlobalDhtTestMap::GlobalDhtTestMap()
 {
     periodicTimer = NULL;
+    pivotId = 0;
+    pivotEpoch = 0;
 }
 
 GlobalDhtTestMap::~GlobalDhtTestMap()
 {
     cancelAndDelete(periodicTimer);
     dataMap.clear();
+    idKeys.clear();
+    liveIds.clear();
+    liveIdTree.clear();
 }
 
 void GlobalDhtTestMap::initialize()
@@ -75,7 +82,7 @@ void GlobalDhtTestMap::handleMessage(cMessage* msg)
            "GlobalDhtTestMap: Number of stored DHT entries", dataMap.size()));
         scheduleAt(simTime() + TEST_MAP_INTERVAL, msg);
     } else if ((entryTimer = dynamic_cast<DhtTestEntryTimer*>(msg)) != NULL) {
-        dataMap.erase(entryTimer->getKey());
+        eraseEntry(entryTimer->getKey());
         delete msg;
     } else {
         throw cRuntimeError("GlobalDhtTestMap::handleMessage(): "
@@ -87,8 +94,23 @@ void GlobalDhtTestMap::insertEntry(const OverlayKey& key, const DHTEntry& entry)
 {
     Enter_Method_Silent();
 
-    dataMap.erase(key);
-    dataMap.insert(make_pair(key, entry));
+    std::map<OverlayKey, DHTEntry>::iterator it = dataMap.find(key);
+
+    if (it == dataMap.end()) {
+        if (idKeys.size() == liveIdTree.size()) {
+            rebuildLiveIdTree(std::max((size_t)1024, 2 * liveIdTree.size()));
+        }
+
+        it = dataMap.insert(make_pair(key, entry)).first;
+        it->second.keyId = idKeys.size();
+        idKeys.push_back(key);
+        liveIds.push_back(true);
+        addLiveId(it->second.keyId, 1);
+    } else {
+        uint32_t keyId = it->second.keyId;
+        it->second = entry;
+        it->second.keyId = keyId;
+    }
 
     DhtTestEntryTimer* msg = new DhtTestEntryTimer("dhtEntryTimer");
     msg->setKey(key);
@@ -98,7 +120,92 @@ void GlobalDhtTestMap::insertEntry(const OverlayKey& key, const DHTEntry& entry)
 
 void GlobalDhtTestMap::eraseEntry(const OverlayKey& key)
 {
-    dataMap.erase(key);
+    std::map<OverlayKey, DHTEntry>::iterator it = dataMap.find(key);
+
+    if (it == dataMap.end()) {
+        return;
+    }
+
+    // the id stays as a gap, so the ids of all other keys are stable
+    uint32_t keyId = it->second.keyId;
+    liveIds[keyId] = false;
+    addLiveId(keyId, -1);
+
+    dataMap.erase(it);
+
+    if (idKeys.size() > 1024 && idKeys.size() > 2 * dataMap.size()) {
+        compactIds();
+    }
+}
+
+void GlobalDhtTestMap::addLiveId(uint32_t id, int delta)
+{
+    for (size_t i = id + 1; i <= liveIdTree.size(); i += i & (~i + 1)) {
+        liveIdTree[i - 1] += delta;
+    }
+}
+
+uint32_t GlobalDhtTestMap::countLiveIdsBelow(uint32_t id) const
+{
+    uint32_t count = 0;
+    for (size_t i = std::min((size_t)id, liveIdTree.size()); i > 0;
+            i -= i & (~i + 1)) {
+        count += liveIdTree[i - 1];
+    }
+    return count;
+}
+
+uint32_t GlobalDhtTestMap::selectLiveId(uint32_t position) const
+{
+    // descend the tree, liveIdTree.size() is a power of two
+    size_t id = 0;
+    for (size_t step = liveIdTree.size(); step > 0; step >>= 1) {
+        if (id + step <= liveIdTree.size() &&
+                liveIdTree[id + step - 1] <= position) {
+            id += step;
+            position -= liveIdTree[id - 1];
+        }
+    }
+    return id;
+}
+
+void GlobalDhtTestMap::rebuildLiveIdTree(size_t capacity)
+{
+    liveIdTree.assign(capacity, 0);
+    for (size_t i = 0; i < liveIds.size(); i++) {
+        if (liveIds[i]) {
+            liveIdTree[i] = 1;
+        }
+    }
+    for (size_t i = 1; i <= capacity; i++) {
+        size_t parent = i + (i & (~i + 1));
+        if (parent <= capacity) {
+            liveIdTree[parent - 1] += liveIdTree[i - 1];
+        }
+    }
+}
+
+void GlobalDhtTestMap::compactIds()
+{
+    // renumber the live ids in the same order, which keeps all ranks
+    pivotId = countLiveIdsBelow(pivotId);
+
+    size_t numIds = 0;
+    for (size_t i = 0; i < idKeys.size(); i++) {
+        if (liveIds[i]) {
+            dataMap[idKeys[i]].keyId = numIds;
+            idKeys[numIds++] = idKeys[i];
+        }
+    }
+
+    idKeys.resize(numIds);
+    liveIds.assign(numIds, true);
+
+    size_t capacity = 1024;
+    while (capacity <= numIds) {
+        capacity *= 2;
+    }
+    rebuildLiveIdTree(capacity);
 }
 
 const DHTEntry* GlobalDhtTestMap::findEntry(const OverlayKey& key)
@@ -118,23 +225,27 @@ const OverlayKey& GlobalDhtTestMap::getRandomKey()
         return OverlayKey::UNSPECIFIED_KEY;
     }
 
-    // return random OverlayKey in O(log n)
-    std::map<OverlayKey, DHTEntry>::iterator it = dataMap.end();
-    DHTEntry tempEntry = {BinaryValue::UNSPECIFIED_VALUE, 0};
+    return idKeys[selectLiveId(intuniform(0, dataMap.size() - 1))];
+}
 
-    OverlayKey randomKey = OverlayKey::random();
-    it = dataMap.find(randomKey);
+const OverlayKey& GlobalDhtTestMap::getKeyAt(size_t index)
+{
+    return idKeys[selectLiveId(index)];
+}
 
-    if (it == dataMap.end()) {
-        it = dataMap.insert(make_pair(randomKey, tempEntry)).first;
-        dataMap.erase(it++);
+const OverlayKey& GlobalDhtTestMap::getKeyByRank(uint32_t rank, uint32_t epoch)
+{
+    if (dataMap.size() == 0) {
+        return OverlayKey::UNSPECIFIED_KEY;
     }
 
-    if (it == dataMap.end()) {
-        it = dataMap.begin();
+    if (epoch != pivotEpoch) {
+        pivotEpoch = epoch;
+        pivotId = selectLiveId(intuniform(0, dataMap.size() - 1));
     }
 
-    return it->first;
+    uint32_t first = countLiveIdsBelow(pivotId);
+    return idKeys[selectLiveId((first + rank) % dataMap.size())];
 }
 
 
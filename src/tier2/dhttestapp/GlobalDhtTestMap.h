@@ -25,6 +25,7 @@
 #define __GLOBAL_DHT_TEST_MAP_H__
 
 #include <map>
+#include <vector>
 
 #include <omnetpp.h>
 
@@ -37,6 +38,7 @@ struct DHTEntry
 {
     BinaryValue value;
     simtime_t endtime;
+    uint32_t keyId; /**< stable id of the key in GlobalDhtTestMap, ordered by insertion */
     friend std::ostream& operator<<(std::ostream& Stream, const DHTEntry entry);
 };
 
@@ -80,13 +82,37 @@ public:
 
     /*
      * Returns the key of a random currently stored DHT record from the global
-     * list of all currently stored DHT records.
+     * list of all currently stored DHT records in O(log n).
      *
      * @return The key of the record, OverlayKey::UNSPECIFIED_KEY if the
      * global list is empty
      */
     const OverlayKey& getRandomKey();
 
+    /*
+     * Returns the key of the currently stored DHT record at the given
+     * position in insertion order. Positions are in [0, size()).
+     *
+     * @param index The position of the record
+     * @return The key of the record
+     */
+    const OverlayKey& getKeyAt(size_t index);
+
+    /*
+     * Returns the key with the given popularity rank. Ranks are bound to
+     * keys: Rank 0 is the oldest key at or after a pivot key, higher
+     * ranks follow in insertion order and wrap around. Erased keys are
+     * skipped, so the popularity of a key doesn't move to a new key.
+     * The pivot is the first key for epoch 0 and is chosen randomly
+     * whenever the epoch changes (popularity drift).
+     *
+     * @param rank The popularity rank in [0, size())
+     * @param epoch The current drift epoch
+     * @return The key of the record, OverlayKey::UNSPECIFIED_KEY if the
+     * global list is empty
+     */
+    const OverlayKey& getKeyByRank(uint32_t rank, uint32_t epoch);
+
     size_t size() { return dataMap.size(); };
     uint32_t p2pnsNameCount;
 
@@ -99,6 +125,17 @@ private:
 
     GlobalStatistics* globalStatistics; /**< pointer to GlobalStatistics module in this node */
     std::map<OverlayKey, DHTEntry> dataMap; /**< The map contains all currently stored DHT records */
+    std::vector<OverlayKey> idKeys; /**< keys of dataMap indexed by their id, erased ids stay as gaps */
+    std::vector<bool> liveIds; /**< true for ids of keys in dataMap */
+    std::vector<uint32_t> liveIdTree; /**< Fenwick tree counting live ids, for selecting records by position */
+    uint32_t pivotId; /**< id of the key with rank 0 */
+    uint32_t pivotEpoch; /**< drift epoch of pivotId */
+
+    void addLiveId(uint32_t id, int delta);
+    uint32_t countLiveIdsBelow(uint32_t id) const;
+    uint32_t selectLiveId(uint32_t position) const;
+    void rebuildLiveIdTree(size_t capacity);
+    void compactIds();
     cMessage *periodicTimer; /**< timer self-message for writing periodic statistical information */
 };
 
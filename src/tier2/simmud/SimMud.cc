@@ -24,17 +24,26 @@
 #include "SimMud.h"
 #include "ScribeMessage_m.h"
 #include <limits.h>
+#include <algorithm>
 #include <GlobalStatistics.h>
 
 Define_Module(SimMud);
 
 using namespace std;
 
+/**
+ * Group keys of all region cells (sha1("x:y") at x * numSubspaces + y)
+ * per grid size and key length, shared by the SimMud instances
+ */
+static std::map<std::pair<int, uint32_t>,
+                std::vector<OverlayKey> > regionKeyTables;
+
 SimMud::SimMud()
 {
     currentRegionX = currentRegionY = INT_MIN;
     currentRegionID = OverlayKey::UNSPECIFIED_KEY;
     playerTimer = new cMessage("playerTimeout");
+    regionKeys = NULL;
 }
 
 SimMud::~SimMud()
@@ -71,6 +80,25 @@ void SimMud::initializeApp(int stage)
     maxMoveDelay = par("maxMoveDelay");
     AOIWidth = par("AOIWidth");
 
+    // hash the region names once per grid instead of on every move
+    std::vector<OverlayKey>& keys = regionKeyTables[
+        std::make_pair(numSubspaces, OverlayKey::getLength())];
+    if (keys.empty()) {
+        keys.resize(numSubspaces * numSubspaces);
+        for (int x = 0; x < numSubspaces; ++x) {
+            for (int y = 0; y < numSubspaces; ++y) {
+                std::stringstream regionstr;
+                regionstr << x << ":" << y;
+                keys[x * numSubspaces + y] =
+                    OverlayKey::sha1(BinaryValue(regionstr.str()));
+            }
+        }
+    }
+    regionKeys = &keys;
+
+    subscribedRegions.assign(numSubspaces * numSubspaces, false);
+    expectedBounds = allowedBounds = RegionBounds();
+
     WATCH(currentRegionX);
     WATCH(currentRegionY);
     WATCH(currentRegionID);
@@ -172,6 +200,31 @@ void SimMud::handleUpperMessage( cMessage *msg )
     }
 }
 
+const OverlayKey& SimMud::getRegionKey( int x, int y )
+{
+    if( x >= 0 && x < numSubspaces && y >= 0 && y < numSubspaces ) {
+        return (*regionKeys)[x * numSubspaces + y];
+    }
+
+    // positions outside of the field
+    static OverlayKey key;
+    std::stringstream regionstr;
+    regionstr << x << ":" << y;
+    key = OverlayKey::sha1( BinaryValue(regionstr.str() ));
+    return key;
+}
+
+/**
+ * Orders region cells by their group key, so groups are joined and
+ * left in the same order as with a std::set<OverlayKey>
+ */
+struct RegionKeyLess
+{
+    const std::vector<OverlayKey>& keys;
+    RegionKeyLess( const std::vector<OverlayKey>& keys ) : keys(keys) {};
+    bool operator()( int a, int b ) const { return keys[a] < keys[b]; };
+};
+
 void SimMud::handleMove( GameAPIPositionMessage* msg )
 {
     if( (int) (msg->getPosition().x/regionSize) != currentRegionX ||
@@ -181,51 +234,63 @@ void SimMud::handleMove( GameAPIPositionMessage* msg )
         // get region ID
         currentRegionX = (int) (msg->getPosition().x/regionSize);
         currentRegionY = (int) (msg->getPosition().y/regionSize);
-        std::stringstream regionstr;
-        regionstr << currentRegionX << ":" << currentRegionY;
-        OverlayKey region = OverlayKey::sha1( BinaryValue(regionstr.str() ));
-        currentRegionID = region;
+        currentRegionID = getRegionKey( currentRegionX, currentRegionY );
     }
 
-    set<OverlayKey> expectedRegions;
-    set<OverlayKey> allowedRegions;
-    int minX = (int) ((msg->getPosition().x - AOIWidth)/regionSize);
-    if( minX < 0 ) minX = 0;
-    int maxX = (int) ((msg->getPosition().x + AOIWidth)/regionSize);
-    if( maxX >= numSubspaces ) maxX = numSubspaces -1;
-    int minY = (int) ((msg->getPosition().y - AOIWidth)/regionSize);
-    if( minY < 0 ) minY = 0;
-    int maxY = (int) ((msg->getPosition().y + AOIWidth)/regionSize);
-    if( maxY >= numSubspaces ) maxY = numSubspaces -1;
+    RegionBounds expected;
+    expected.minX = (int) ((msg->getPosition().x - AOIWidth)/regionSize);
+    if( expected.minX < 0 ) expected.minX = 0;
+    expected.maxX = (int) ((msg->getPosition().x + AOIWidth)/regionSize);
+    if( expected.maxX >= numSubspaces ) expected.maxX = numSubspaces -1;
+    expected.minY = (int) ((msg->getPosition().y - AOIWidth)/regionSize);
+    if( expected.minY < 0 ) expected.minY = 0;
+    expected.maxY = (int) ((msg->getPosition().y + AOIWidth)/regionSize);
+    if( expected.maxY >= numSubspaces ) expected.maxY = numSubspaces -1;
 
     // FIXME: make parameter: unsubscription size
-    int minUnsubX = (int) ((msg->getPosition().x - 1.5*AOIWidth)/regionSize);
-    if( minUnsubX < 0 ) minUnsubX = 0;
-    int maxUnsubX = (int) ((msg->getPosition().x + 1.5*AOIWidth)/regionSize);
-    if( maxUnsubX >= numSubspaces ) maxUnsubX = numSubspaces -1;
-    int minUnsubY = (int) ((msg->getPosition().y - 1.5*AOIWidth)/regionSize);
-    if( minUnsubY < 0 ) minUnsubY = 0;
-    int maxUnsubY = (int) ((msg->getPosition().y + 1.5+AOIWidth)/regionSize);
-    if( maxUnsubY >= numSubspaces ) maxUnsubY = numSubspaces -1;
-
-    for( int x = minUnsubX; x <= maxUnsubX; ++x ){
-        for( int y = minUnsubY; y <= maxUnsubY; ++y ){
-            std::stringstream regionstr;
-            regionstr << x << ":" << y;
-            if( x >= minX && x <=maxX && y >= minY && y <= maxY ){
-                expectedRegions.insert( OverlayKey::sha1( BinaryValue(regionstr.str() )));
+    RegionBounds allowed;
+    allowed.minX = (int) ((msg->getPosition().x - 1.5*AOIWidth)/regionSize);
+    if( allowed.minX < 0 ) allowed.minX = 0;
+    allowed.maxX = (int) ((msg->getPosition().x + 1.5*AOIWidth)/regionSize);
+    if( allowed.maxX >= numSubspaces ) allowed.maxX = numSubspaces -1;
+    allowed.minY = (int) ((msg->getPosition().y - 1.5*AOIWidth)/regionSize);
+    if( allowed.minY < 0 ) allowed.minY = 0;
+    allowed.maxY = (int) ((msg->getPosition().y + 1.5+AOIWidth)/regionSize);
+    if( allowed.maxY >= numSubspaces ) allowed.maxY = numSubspaces -1;
+
+    // The expected cells are always within the allowed ones, so all
+    // subscribed cells are within allowedBounds and all cells of
+    // expectedBounds are subscribed. Subscriptions only change if
+    // the bounding cells do.
+    if( !(expected == expectedBounds) || !(allowed == allowedBounds) ) {
+        const std::vector<OverlayKey>& keys = *regionKeys;
+        std::vector<int> leaveRegions;
+        std::vector<int> joinRegions;
+
+        for( int x = allowedBounds.minX; x <= allowedBounds.maxX; ++x ){
+            for( int y = allowedBounds.minY; y <= allowedBounds.maxY; ++y ){
+                int cell = x * numSubspaces + y;
+                if( subscribedRegions[cell] && !allowed.contains( x, y )) {
+                    leaveRegions.push_back( cell );
+                }
+            }
+        }
+        for( int x = expected.minX; x <= expected.maxX; ++x ){
+            for( int y = expected.minY; y <= expected.maxY; ++y ){
+                int cell = x * numSubspaces + y;
+                if( !subscribedRegions[cell] ) {
+                    joinRegions.push_back( cell );
+                }
             }
-            allowedRegions.insert( OverlayKey::sha1( BinaryValue(regionstr.str() )));
         }
-    }
-
-    set<OverlayKey>::iterator subIt = subscribedRegions.begin();
-    while( subIt != subscribedRegions.end() ){
 
-        expectedRegions.erase( *subIt );
+        std::sort( leaveRegions.begin(), leaveRegions.end(),
+                   RegionKeyLess( keys ));
+        std::sort( joinRegions.begin(), joinRegions.end(),
+                   RegionKeyLess( keys ));
 
-        // unsubscribe region if to far away
-        if( allowedRegions.find( *subIt ) == allowedRegions.end() ){
+        // unsubscribe regions that are to far away
+        for( size_t i = 0; i < leaveRegions.size(); ++i ){
             // Inform other players about region leave
             SimMudMoveMessage* moveMsg = new SimMudMoveMessage("MOVE/LEAVE_REGION");
             moveMsg->setSrc( overlay->getThisNode() );
@@ -234,33 +299,33 @@ void SimMud::handleMove( GameAPIPositionMessage* msg )
             moveMsg->setTimestamp( simTime() );
             moveMsg->setLeaveRegion( true );
             ALMMulticastMessage* mcastMsg = new ALMMulticastMessage("MOVE/LEAVE_REGION");
-            mcastMsg->setGroupId(*subIt);
+            mcastMsg->setGroupId( keys[leaveRegions[i]] );
             mcastMsg->encapsulate( moveMsg );
 
             send(mcastMsg, "to_lowerTier");
 
              // leave old region's multicastGroup
             ALMLeaveMessage* leaveMsg = new ALMLeaveMessage("LEAVE_REGION_GROUP");
-            leaveMsg->setGroupId(*subIt);
+            leaveMsg->setGroupId( keys[leaveRegions[i]] );
             send(leaveMsg, "to_lowerTier");
             // TODO: leave old simMud region
 
-           // Erase subspace from subscribedList and increase iterator
-            subscribedRegions.erase( subIt++ );
-        } else {
-            ++subIt;
+            subscribedRegions[leaveRegions[i]] = false;
         }
-    }
 
-    // if any "near" region is not yet subscribed, subscribe
-    for( set<OverlayKey>::iterator regionIt = expectedRegions.begin(); regionIt != expectedRegions.end(); ++regionIt ){
-        // join region's multicast group
-        ALMSubscribeMessage* subMsg = new ALMSubscribeMessage;
-        subMsg->setGroupId(*regionIt);
-        send( subMsg, "to_lowerTier" );
+        // if any "near" region is not yet subscribed, subscribe
+        for( size_t i = 0; i < joinRegions.size(); ++i ){
+            // join region's multicast group
+            ALMSubscribeMessage* subMsg = new ALMSubscribeMessage;
+            subMsg->setGroupId( keys[joinRegions[i]] );
+            send( subMsg, "to_lowerTier" );
+
+            subscribedRegions[joinRegions[i]] = true;
+            // TODO: join simMud region
+        }
 
-        subscribedRegions.insert( *regionIt );
-        // TODO: join simMud region
+        expectedBounds = expected;
+        allowedBounds = allowed;
     }
 
     // publish movement
@@ -33,10 +33,35 @@
 class SimMud : public BaseApp
 {
     private:
+        /**
+         * Inclusive range of region cells, empty if minX > maxX
+         */
+        struct RegionBounds {
+            int minX, maxX, minY, maxY;
+
+            RegionBounds() : minX(0), maxX(-1), minY(0), maxY(-1) {};
+            bool contains( int x, int y ) const {
+                return x >= minX && x <= maxX && y >= minY && y <= maxY;
+            };
+            bool operator==( const RegionBounds& b ) const {
+                return minX == b.minX && maxX == b.maxX &&
+                       minY == b.minY && maxY == b.maxY;
+            };
+        };
+
         int currentRegionX;
         int currentRegionY;
         OverlayKey currentRegionID;
-        std::set<OverlayKey> subscribedRegions;
+        std::vector<bool> subscribedRegions; //!< subscription flag per region cell
+        RegionBounds expectedBounds; //!< AOI cells of the last move
+        RegionBounds allowedBounds; //!< unsubscribe window of the last move
+
+        /**
+         * Returns the multicast group key of region cell x:y
+         */
+        const OverlayKey& getRegionKey( int x, int y );
+
+        const std::vector<OverlayKey>* regionKeys; //!< group keys of the region cells of this grid
 
         int fieldSize;
         int numSubspaces;
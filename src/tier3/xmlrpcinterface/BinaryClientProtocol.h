@@ -0,0 +1,214 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file BinaryClientProtocol.h
+ * @author agent
+ *
+ * The binary client protocol of XmlRpcInterface
+ *
+ * A client selects the binary protocol instead of XML-RPC by sending
+ * the 4 bytes BINARY_PROTOCOL_MAGIC at the start of a connection.
+ * Afterwards both sides exchange frames. All integers are in network
+ * byte order, byte strings are encoded as uint32 length + data:
+ *
+ *   uint32 length       length of the rest of the frame
+ *   uint32 requestId    chosen by the client, copied into the response
+ *   uint8  opcode       request opcode or response status
+ *   ...    payload
+ *
+ * Requests may be pipelined, responses are sent in completion order.
+ *
+ * Request payloads and the payloads of BIN_OK responses:
+ *
+ *   BIN_PUT       key, value, uint32 ttl  -> (empty)
+ *   BIN_GET       key                     -> uint32 n, n * value
+ *   BIN_LOOKUP    key, uint32 numSiblings, uint32 routingType
+ *                 -> uint32 n, n * (ip, uint32 port, nodeId in hex)
+ *   BIN_REGISTER  name, uint32 kind, uint32 id, address, uint32 ttl
+ *                 -> (empty)
+ *   BIN_RESOLVE   name, uint32 kind
+ *                 -> uint32 n, n * (address, uint32 kind, uint32 id)
+ *   BIN_DUMP_DHT  (empty)
+ *                 -> uint32 n, n * (key in hex, value, uint32 ttl)
+ *                 in any number of BIN_MORE frames and a final BIN_OK
+ *   BIN_BATCH     uint32 n, n * (uint32 requestId, uint8 opcode, payload)
+ *                 each request is answered with its own requestId
+ *
+ * All other status codes carry an error message.
+ */
+
+#ifndef __BINARYCLIENTPROTOCOL_H_
+#define __BINARYCLIENTPROTOCOL_H_
+
+#include <string>
+#include <stdint.h>
+
+#include <BinaryValue.h>
+
+static const char BINARY_PROTOCOL_MAGIC[] = "\x89OSB";
+static const uint32_t BINARY_PROTOCOL_MAGIC_L = 4;
+static const uint32_t BINARY_MAX_FRAME_L = 16 * 1024 * 1024;
+static const uint32_t BINARY_DUMP_RECORDS_PER_FRAME = 64;
+
+enum BinaryOpcode {
+    BIN_PUT = 1,
+    BIN_GET = 2,
+    BIN_LOOKUP = 3,
+    BIN_REGISTER = 4,
+    BIN_RESOLVE = 5,
+    BIN_DUMP_DHT = 6,
+    BIN_BATCH = 7
+};
+
+enum BinaryStatus {
+    BIN_OK = 0,
+    BIN_MORE = 1,
+    BIN_FAILED = 2,
+    BIN_TIMEOUT = 3,
+    BIN_INVALID = 4,
+    BIN_NOT_ALLOWED = 5,
+    BIN_NO_SERVICE = 6
+};
+
+/**
+ * Reads the fields of a frame payload
+ */
+class BinaryFrameReader
+{
+public:
+    BinaryFrameReader(const char* data, uint32_t length)
+        : data(data), left(length), valid(true) {};
+
+    uint8_t readUint8()
+    {
+        if (!check(1)) return 0;
+        uint8_t value = (uint8_t)data[0];
+        data++; left--;
+        return value;
+    }
+
+    uint32_t readUint32()
+    {
+        if (!check(4)) return 0;
+        const unsigned char* p = (const unsigned char*)data;
+        uint32_t value = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+                         ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+        data += 4; left -= 4;
+        return value;
+    }
+
+    BinaryValue readBytes()
+    {
+        uint32_t length = readUint32();
+        if (!check(length)) return BinaryValue();
+        BinaryValue value(data, data + length);
+        data += length; left -= length;
+        return value;
+    }
+
+    /**
+     * Returns a reader for a nested byte string without copying it
+     */
+    BinaryFrameReader readNested()
+    {
+        uint32_t length = readUint32();
+        if (!check(length)) return BinaryFrameReader(NULL, 0, false);
+        BinaryFrameReader nested(data, length);
+        data += length; left -= length;
+        return nested;
+    }
+
+    /** true, if all fields read so far were complete */
+    bool isValid() const { return valid; };
+
+private:
+    BinaryFrameReader(const char* data, uint32_t length, bool valid)
+        : data(data), left(length), valid(valid) {};
+
+    bool check(uint32_t length)
+    {
+        if (length > left) valid = false;
+        return valid;
+    }
+
+    const char* data;
+    uint32_t left;
+    bool valid;
+};
+
+/**
+ * Builds a frame
+ */
+class BinaryFrameWriter
+{
+public:
+    BinaryFrameWriter(uint32_t requestId, uint8_t status)
+    {
+        frame.reserve(64);
+        writeUint32(0); // length, set by getFrame()
+        writeUint32(requestId);
+        writeUint8(status);
+    };
+
+    void writeUint8(uint8_t value) { frame.push_back((char)value); };
+
+    void writeUint32(uint32_t value)
+    {
+        char buf[4] = { (char)(value >> 24), (char)(value >> 16),
+                        (char)(value >> 8), (char)value };
+        frame.append(buf, 4);
+    };
+
+    void writeBytes(const char* data, uint32_t length)
+    {
+        writeUint32(length);
+        frame.append(data, length);
+    };
+
+    void writeBytes(const std::vector<char>& value)
+    {
+        writeBytes(value.empty() ? NULL : &value[0], value.size());
+    };
+
+    void writeBytes(const BinaryValue& value)
+    {
+        writeBytes(value.data(), value.size());
+    };
+
+    void writeBytes(const std::string& value)
+    {
+        writeBytes(value.data(), value.size());
+    };
+
+    /** Sets the length field and returns the complete frame */
+    const std::string& getFrame()
+    {
+        uint32_t length = frame.size() - 4;
+        frame[0] = (char)(length >> 24);
+        frame[1] = (char)(length >> 16);
+        frame[2] = (char)(length >> 8);
+        frame[3] = (char)length;
+        return frame;
+    };
+
+private:
+    std::string frame;
+};
+
+#endif
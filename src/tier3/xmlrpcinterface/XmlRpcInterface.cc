@@ -33,6 +33,7 @@
 #include <NodeVector.h>
 #include <P2pns.h>
 #include <sstream>
+#include <algorithm>
 #include "XmlRpcInterface.h"
 
 using namespace XmlRpc;
@@ -200,6 +201,46 @@ public:
     }
 };
 
+// Store multiple values in the DHT
+class MultiPut : public XmlRpcServerMethod
+{
+public:
+    MultiPut(XmlRpcServer* s) :
+        XmlRpcServerMethod("multiPut", s)
+    {
+    }
+
+    void execute(XmlRpcValue& params, XmlRpcValue& result)
+    {
+        (dynamic_cast<XmlRpcInterface*>(_server))->multiPut(params, result);
+    }
+
+    std::string help()
+    {
+        return std::string("Store multiple values in the DHT in parallel");
+    }
+};
+
+// Get multiple values from the DHT
+class MultiGet : public XmlRpcServerMethod
+{
+public:
+    MultiGet(XmlRpcServer* s) :
+        XmlRpcServerMethod("multiGet", s)
+    {
+    }
+
+    void execute(XmlRpcValue& params, XmlRpcValue& result)
+    {
+        (dynamic_cast<XmlRpcInterface*>(_server))->multiGet(params, result);
+    }
+
+    std::string help()
+    {
+        return std::string("Get multiple values from the DHT in parallel");
+    }
+};
+
 void XmlRpcInterface::p2pnsRegister(XmlRpcValue& params, XmlRpcValue& result)
 {
     if ((params.size() != 5) ||
@@ -421,6 +462,183 @@ void XmlRpcInterface::dumpDht(XmlRpcValue& params, XmlRpcValue& result)
     sendInternalRpcWithTimeout(TIER1_COMP, call);
 }
 
+void XmlRpcInterface::multiPut(XmlRpcValue& params, XmlRpcValue& result)
+{
+    if ((params.size() != 2)
+            || (params[0].getType() != XmlRpcValue::TypeArray)
+            || (params[1].getType() != XmlRpcValue::TypeString))
+        throw XmlRpcException("multiPut(array entries, string application): "
+                              "Invalid argument type");
+
+    if (state[curAppFd].multiIndex != -1)
+        throw XmlRpcException("multiPut(): Not allowed within a multicall");
+
+    startMulticall(params[0].size(), false);
+
+    // each entry is executed as put(key, value, ttl, application)
+    for (int i = 0; i < params[0].size(); i++) {
+        XmlRpcValue& entry = params[0][i];
+
+        if ((entry.getType() != XmlRpcValue::TypeArray)
+                || (entry.size() != 3)) {
+            setMulticallFault(i, "multiPut(): Invalid entry (expected an "
+                              "array of base64 key, base64 value, int ttl)",
+                              -1);
+            continue;
+        }
+
+        XmlRpcValue putParams;
+        putParams.setSize(4);
+        putParams[0] = entry[0];
+        putParams[1] = entry[1];
+        putParams[2] = entry[2];
+        putParams[3] = params[1];
+
+        executeMulticallEntry(i, "put", putParams);
+    }
+
+    finishMulticall(result);
+}
+
+void XmlRpcInterface::multiGet(XmlRpcValue& params, XmlRpcValue& result)
+{
+    if ((params.size() != 2)
+            || (params[0].getType() != XmlRpcValue::TypeArray)
+            || (params[1].getType() != XmlRpcValue::TypeString))
+        throw XmlRpcException("multiGet(array keys, string application): "
+                              "Invalid argument type");
+
+    if (state[curAppFd].multiIndex != -1)
+        throw XmlRpcException("multiGet(): Not allowed within a multicall");
+
+    startMulticall(params[0].size(), false);
+
+    // each key is executed as get(key, 1, "", application)
+    for (int i = 0; i < params[0].size(); i++) {
+        XmlRpcValue getParams;
+        getParams.setSize(4);
+        getParams[0] = params[0][i];
+        getParams[1] = 1;
+        getParams[2] = XmlRpcValue((void*)NULL, 0);
+        getParams[3] = params[1];
+
+        executeMulticallEntry(i, "get", getParams);
+    }
+
+    finishMulticall(result);
+}
+
+bool XmlRpcInterface::executeMulticall(const std::string& methodName,
+                                       XmlRpcValue& params,
+                                       XmlRpcValue& result)
+{
+    if (methodName != "system.multicall") {
+        return false;
+    }
+
+    if ((params.size() != 1) || (params[0].getType() != XmlRpcValue::TypeArray))
+        throw XmlRpcException("system.multicall: Invalid argument "
+                              "(expected an array)");
+
+    if (state[curAppFd].multiIndex != -1)
+        throw XmlRpcException("system.multicall: Not allowed within a "
+                              "multicall");
+
+    startMulticall(params[0].size(), true);
+
+    for (int i = 0; i < params[0].size(); i++) {
+        XmlRpcValue& call = params[0][i];
+
+        if ((call.getType() != XmlRpcValue::TypeStruct)
+                || !call.hasMember(METHODNAME)
+                || !call.hasMember(PARAMS)) {
+            setMulticallFault(i, "system.multicall: Invalid argument "
+                              "(expected a struct with members methodName "
+                              "and params)", -1);
+            continue;
+        }
+
+        executeMulticallEntry(i, call[METHODNAME], call[PARAMS]);
+    }
+
+    finishMulticall(result);
+
+    return true;
+}
+
+void XmlRpcInterface::startMulticall(int numCalls, bool wrap)
+{
+    state[curAppFd]._multiResult.clear();
+    state[curAppFd]._multiResult.setSize(numCalls);
+    state[curAppFd].multiWrap = wrap;
+}
+
+void XmlRpcInterface::executeMulticallEntry(int index,
+                                            const std::string& methodName,
+                                            XmlRpcValue& params)
+{
+    // RPCs sent by the method are assigned to index
+    // (see sendInternalRpcWithTimeout())
+    state[curAppFd].multiIndex = index;
+    size_t numPending = state[curAppFd].multiRequests.size();
+
+    try {
+        XmlRpcValue resultValue;
+        if (!executeMethod(methodName, params, resultValue)) {
+            setMulticallFault(index, methodName + ": unknown method name", -1);
+        } else if (state[curAppFd].multiRequests.size() == numPending) {
+            // the method finished without sending a RPC
+            setMulticallResult(index, resultValue);
+        }
+    } catch (const XmlRpcException& fault) {
+        setMulticallFault(index, fault.getMessage(), fault.getCode());
+    }
+
+    state[curAppFd].multiIndex = -1;
+}
+
+void XmlRpcInterface::finishMulticall(XmlRpcValue& result)
+{
+    if (state[curAppFd].multiRequests.empty()) {
+        result = state[curAppFd]._multiResult;
+        state[curAppFd]._multiResult.clear();
+    }
+}
+
+void XmlRpcInterface::setMulticallResult(int index, XmlRpcValue& value)
+{
+    if (state[curAppFd].multiWrap) {
+        state[curAppFd]._multiResult[index].setSize(1);
+        state[curAppFd]._multiResult[index][0] = value;
+    } else {
+        state[curAppFd]._multiResult[index] = value;
+    }
+}
+
+void XmlRpcInterface::setMulticallFault(int index, const std::string& message,
+                                        int code)
+{
+    state[curAppFd]._multiResult[index][FAULTCODE] = code;
+    state[curAppFd]._multiResult[index][FAULTSTRING] = message;
+}
+
+void XmlRpcInterface::completeMulticall()
+{
+    if (!state[curAppFd].multiRequests.empty() ||
+        state[curAppFd]._connectionState != EXECUTE_REQUEST) {
+        return;
+    }
+
+    state[curAppFd]._response =
+        generateResponse(state[curAppFd]._multiResult.toXml());
+    state[curAppFd]._multiResult.clear();
+
+    state[curAppFd]._connectionState = WRITE_RESPONSE;
+    if (!writeResponse()) {
+        closeConnection();
+    }
+}
+
 bool XmlRpcInterface::isPrivileged()
 {
     if (limitAccess) {
@@ -458,6 +676,8 @@ void XmlRpcInterface::initializeApp(int stage)
     _get = new Get(this);
     _dumpDht = new DumpDht(this);
     _joinOverlay = new JoinOverlay(this);
+    _multiPut = new MultiPut(this);
+    _multiGet = new MultiGet(this);
 
     enableIntrospection(true);
 
@@ -476,6 +696,8 @@ XmlRpcInterface::XmlRpcInterface()
     _get = NULL;
     _dumpDht = NULL;
     _joinOverlay = NULL;
+    _multiPut = NULL;
+    _multiGet = NULL;
 
     packetNotification = NULL;
 }
@@ -490,6 +712,8 @@ XmlRpcInterface::~XmlRpcInterface()
     delete _get;
     delete _dumpDht;
     delete _joinOverlay;
+    delete _multiPut;
+    delete _multiGet;
 
     cancelAndDelete(packetNotification);
 }
@@ -500,6 +724,24 @@ void XmlRpcInterface::resetConnectionState()
         cancelRpcMessage(state[curAppFd].pendingRpc);
     }
 
+    if (state.count(curAppFd)) {
+        std::map<uint32_t, uint32_t>& requests =
+            state[curAppFd].binaryRequests;
+        for (std::map<uint32_t, uint32_t>::iterator it = requests.begin();
+             it != requests.end(); ++it) {
+            cancelRpcMessage(it->first);
+        }
+        requests.clear();
+
+        std::map<uint32_t, int>& multiRequests =
+            state[curAppFd].multiRequests;
+        for (std::map<uint32_t, int>::iterator it = multiRequests.begin();
+             it != multiRequests.end(); ++it) {
+            cancelRpcMessage(it->first);
+        }
+        multiRequests.clear();
+    }
+
     state[curAppFd].appFd = INVALID_SOCKET;
     state[curAppFd].localhost = false;
     state[curAppFd]._header = "";
@@ -508,6 +750,12 @@ void XmlRpcInterface::resetConnectionState()
     state[curAppFd]._connectionState = READ_HEADER;
     state[curAppFd]._keepAlive = true;
     state[curAppFd].pendingRpc = 0;
+    state[curAppFd].binary = false;
+    state[curAppFd].binaryMagic = false;
+    state[curAppFd]._input = "";
+    state[curAppFd].multiIndex = -1;
+    state[curAppFd].multiWrap = false;
+    state[curAppFd]._multiResult.clear();
 }
 
 void XmlRpcInterface::closeConnection()
@@ -519,9 +767,14 @@ void XmlRpcInterface::closeConnection()
 void XmlRpcInterface::sendInternalRpcWithTimeout(CompType destComp,
                                                  BaseCallMessage *call)
 {
-    state[curAppFd].pendingRpc = sendInternalRpcCall(destComp, call, NULL,
-                                                     XMLRPC_TIMEOUT, 0,
-                                                     curAppFd);
+    uint32_t nonce = sendInternalRpcCall(destComp, call, NULL,
+                                         XMLRPC_TIMEOUT, 0, curAppFd);
+
+    if (state[curAppFd].multiIndex != -1) {
+        state[curAppFd].multiRequests[nonce] = state[curAppFd].multiIndex;
+    } else {
+        state[curAppFd].pendingRpc = nonce;
+    }
 }
 
 void XmlRpcInterface::handleMessage(cMessage *msg)
@@ -626,6 +879,26 @@ void XmlRpcInterface::handleRpcTimeout(BaseCallMessage* msg,
     if (state.count(curAppFd) == 0)
         return;
 
+    if (state[curAppFd].binary) {
+        std::map<uint32_t, uint32_t>::iterator it =
+            state[curAppFd].binaryRequests.find(msg->getNonce());
+        if (it == state[curAppFd].binaryRequests.end()) return;
+
+        uint32_t requestId = it->second;
+        state[curAppFd].binaryRequests.erase(it);
+        sendBinaryError(requestId, BIN_TIMEOUT, "timeout");
+        return;
+    }
+
+    std::map<uint32_t, int>::iterator it =
+        state[curAppFd].multiRequests.find(msg->getNonce());
+    if (it != state[curAppFd].multiRequests.end()) {
+        setMulticallFault(it->second, "XML-RPC timeout", 22);
+        state[curAppFd].multiRequests.erase(it);
+        completeMulticall();
+        return;
+    }
+
     std::cout << "XmlRpcInterface(): XML-RPC failed!" << endl;
     state[curAppFd]._response = generateFaultResponse("XML-RPC timeout", 22);
     state[curAppFd]._connectionState = WRITE_RESPONSE;
@@ -741,6 +1014,20 @@ void XmlRpcInterface::deliverTunneledMessage(const BinaryValue& payload)
 
 void XmlRpcInterface::handleRealworldPacket(char *buf, uint32_t length)
 {
+    // the first byte of a binary protocol connection is never part of a
+    // valid HTTP header
+    if (!state[curAppFd].binary &&
+        state[curAppFd]._connectionState == READ_HEADER &&
+        state[curAppFd]._header.empty() && length > 0 &&
+        buf[0] == BINARY_PROTOCOL_MAGIC[0]) {
+        state[curAppFd].binary = true;
+    }
+
+    if (state[curAppFd].binary) {
+        handleBinaryPacket(buf, length);
+        return;
+    }
+
     if (state[curAppFd]._connectionState == READ_HEADER) {
         if (!readHeader(buf, length)) {
             // discard data, if the header is invalid
@@ -776,162 +1063,515 @@ void XmlRpcInterface::handleRpcResponse(BaseResponseMessage* msg,
         return;
     }
 
-    RPC_SWITCH_START(msg)
-    RPC_ON_RESPONSE(Lookup) {
-        if (state[curAppFd]._connectionState != EXECUTE_REQUEST) break;
+    if (state[curAppFd].binary) {
+        handleBinaryRpcResponse(msg);
+        return;
+    }
 
-        XmlRpcValue resultValue;
-        resultValue.setSize(_LookupResponse->getSiblingsArraySize());
+    std::map<uint32_t, int>::iterator it =
+        state[curAppFd].multiRequests.find(msg->getNonce());
+    if (it != state[curAppFd].multiRequests.end()) {
+        int index = it->second;
+        state[curAppFd].multiRequests.erase(it);
 
-        if (_LookupResponse->getIsValid() == true) {
-            for (uint32_t i=0; i < _LookupResponse->getSiblingsArraySize();
-                    i++) {
-                resultValue[i].setSize(3);
-                resultValue[i][0] =
-                    _LookupResponse->getSiblings(i).getIp().str();
-                resultValue[i][1] =
-                    _LookupResponse->getSiblings(i).getPort();
-                resultValue[i][2] =
-                    _LookupResponse->getSiblings(i).getKey().toString(16);
+        try {
+            XmlRpcValue resultValue;
+            if (getRpcResult(msg, resultValue)) {
+                setMulticallResult(index, resultValue);
             }
-            state[curAppFd]._response = generateResponse(resultValue.toXml());
-        } else {
-            std::cout << "XmlRpcInterface(): lookup() failed!" << endl;
-            state[curAppFd]._response = generateFaultResponse("lookup() failed", 22);
+        } catch (const XmlRpcException& fault) {
+            setMulticallFault(index, fault.getMessage(), fault.getCode());
         }
 
-        state[curAppFd]._connectionState = WRITE_RESPONSE;
-        if (!writeResponse()) {
-            closeConnection();
-        }
-        break;
+        completeMulticall();
+        return;
     }
-    RPC_ON_RESPONSE(P2pnsRegister) {
-        if (state[curAppFd]._connectionState != EXECUTE_REQUEST)
-            break;
 
+    if (state[curAppFd]._connectionState != EXECUTE_REQUEST) {
+        return;
+    }
+
+    try {
         XmlRpcValue resultValue;
+        if (!getRpcResult(msg, resultValue)) {
+            return;
+        }
+        state[curAppFd]._response = generateResponse(resultValue.toXml());
+    } catch (const XmlRpcException& fault) {
+        state[curAppFd]._response = generateFaultResponse(fault.getMessage(),
+                                                          fault.getCode());
+    }
 
-        if (_P2pnsRegisterResponse->getIsSuccess() == true) {
-            resultValue = 0;
-            state[curAppFd]._response = generateResponse(resultValue.toXml());
-        } else {
-            std::cout << "XmlRpcInterface(): register() failed!" << endl;
-            state[curAppFd]._response = generateFaultResponse("register() failed", 22);
+    state[curAppFd]._connectionState = WRITE_RESPONSE;
+    if (!writeResponse()) {
+        closeConnection();
+    }
+}
+
+bool XmlRpcInterface::getRpcResult(BaseResponseMessage* msg,
+                                   XmlRpcValue& resultValue)
+{
+    RPC_SWITCH_START(msg)
+    RPC_ON_RESPONSE(Lookup) {
+        if (_LookupResponse->getIsValid() != true) {
+            std::cout << "XmlRpcInterface(): lookup() failed!" << endl;
+            throw XmlRpcException("lookup() failed", 22);
         }
 
-        state[curAppFd]._connectionState = WRITE_RESPONSE;
-        if (!writeResponse() ) {
-            closeConnection();
+        resultValue.setSize(_LookupResponse->getSiblingsArraySize());
+        for (uint32_t i=0; i < _LookupResponse->getSiblingsArraySize(); i++) {
+            resultValue[i].setSize(3);
+            resultValue[i][0] =
+                _LookupResponse->getSiblings(i).getIp().str();
+            resultValue[i][1] =
+                _LookupResponse->getSiblings(i).getPort();
+            resultValue[i][2] =
+                _LookupResponse->getSiblings(i).getKey().toString(16);
         }
-        break;
+        return true;
+    }
+    RPC_ON_RESPONSE(P2pnsRegister) {
+        if (_P2pnsRegisterResponse->getIsSuccess() != true) {
+            std::cout << "XmlRpcInterface(): register() failed!" << endl;
+            throw XmlRpcException("register() failed", 22);
+        }
+
+        resultValue = 0;
+        return true;
     }
     RPC_ON_RESPONSE(P2pnsResolve) {
-        if (state[curAppFd]._connectionState != EXECUTE_REQUEST)
-            break;
+        if (_P2pnsResolveResponse->getIsSuccess() != true) {
+            std::cout << "XmlRpcInterface(): resolve() failed!" << endl;
+            throw XmlRpcException("resolve() failed: Name not found", 9);
+        }
 
-        XmlRpcValue resultValue;
         resultValue.setSize(_P2pnsResolveResponse->getAddressArraySize());
+        for (uint i=0; i < _P2pnsResolveResponse->getAddressArraySize(); i++) {
+            resultValue[i].setSize(3);
+            const BinaryValue& addr = _P2pnsResolveResponse->getAddress(i);
+            resultValue[i][0] = XmlRpcValue((void*)addr.data(), addr.size());
+            resultValue[i][1] = (int)_P2pnsResolveResponse->getKind(i);
+            resultValue[i][2] = (int)_P2pnsResolveResponse->getId(i);
+        }
+        return true;
+    }
+    RPC_ON_RESPONSE(DHTputCAPI) {
+        if (_DHTputCAPIResponse->getIsSuccess() != true) {
+            std::cout << "XmlRpcInterface(): put() failed!" << endl;
+            throw XmlRpcException("put() failed", 22);
+        }
 
-        if (_P2pnsResolveResponse->getIsSuccess() == true) {
-            for (uint i=0; i < _P2pnsResolveResponse->getAddressArraySize(); i++) {
-                resultValue[i].setSize(3);
-                BinaryValue& addr = _P2pnsResolveResponse->getAddress(i);
-                resultValue[i][0] = XmlRpcValue(&addr[0], addr.size());
-                resultValue[i][1] = (int)_P2pnsResolveResponse->getKind(i);
-                resultValue[i][2] = (int)_P2pnsResolveResponse->getId(i);
-            }
-            state[curAppFd]._response = generateResponse(resultValue.toXml());
-        } else {
-            std::cout << "XmlRpcInterface(): resolve() failed!" << endl;
-            state[curAppFd]._response = generateFaultResponse("resolve() failed: Name not found", 9);
+        resultValue = 0;
+        return true;
+    }
+    RPC_ON_RESPONSE(DHTgetCAPI) {
+        if (_DHTgetCAPIResponse->getIsSuccess() != true) {
+            std::cout << "XmlRpcInterface(): get() failed!" << endl;
+            throw XmlRpcException("get() failed", 22);
         }
 
-        state[curAppFd]._connectionState = WRITE_RESPONSE;
-        if (!writeResponse() ) {
+        resultValue.setSize(2);
+        resultValue[0].setSize(_DHTgetCAPIResponse->getResultArraySize());
+        for (uint i=0; i < _DHTgetCAPIResponse->getResultArraySize(); i++) {
+            const BinaryValue& value =
+                _DHTgetCAPIResponse->getResult(i).getValue();
+            resultValue[0][i] = XmlRpcValue((void*)value.data(),
+                                            value.size());
+        }
+        resultValue[1] = std::string();
+        return true;
+    }
+    RPC_ON_RESPONSE(DHTdump) {
+        resultValue.setSize(_DHTdumpResponse->getRecordArraySize());
+
+        for (uint32_t i=0; i < _DHTdumpResponse->getRecordArraySize();
+             i++) {
+            resultValue[i].setSize(3);
+            resultValue[i][0] =
+                _DHTdumpResponse->getRecord(i).getKey().toString(16);
+            const BinaryValue& value =
+                _DHTdumpResponse->getRecord(i).getValue();
+            resultValue[i][1] = XmlRpcValue((void*)value.data(), value.size());
+            resultValue[i][2] =
+                _DHTdumpResponse->getRecord(i).getTtl();
+        }
+        return true;
+    }
+    RPC_SWITCH_END( )
+
+    return false;
+}
+
+void XmlRpcInterface::handleBinaryPacket(char *buf, uint32_t length)
+{
+    // take the buffered input, so frames stay valid even if a request
+    // closes the connection
+    std::string input;
+    input.swap(state[curAppFd]._input);
+    input.append(buf, length);
+
+    size_t offset = 0;
+
+    if (!state[curAppFd].binaryMagic) {
+        if (input.size() < BINARY_PROTOCOL_MAGIC_L) {
+            state[curAppFd]._input.swap(input);
+            return;
+        }
+
+        if (input.compare(0, BINARY_PROTOCOL_MAGIC_L, BINARY_PROTOCOL_MAGIC,
+                          BINARY_PROTOCOL_MAGIC_L) != 0) {
+            EV << "XmlRpcInterface::handleBinaryPacket(): "
+                  "Invalid protocol magic - closing connection" << endl;
             closeConnection();
+            return;
         }
-        break;
+
+        state[curAppFd].binaryMagic = true;
+        offset = BINARY_PROTOCOL_MAGIC_L;
     }
-    RPC_ON_RESPONSE(DHTputCAPI) {
-        if (state[curAppFd]._connectionState != EXECUTE_REQUEST)
+
+    while (input.size() - offset >= 4) {
+        BinaryFrameReader lengthReader(input.data() + offset, 4);
+        uint32_t frameLength = lengthReader.readUint32();
+
+        if (frameLength < 5 || frameLength > BINARY_MAX_FRAME_L) {
+            EV << "XmlRpcInterface::handleBinaryPacket(): "
+                  "Invalid frame length " << frameLength
+               << " - closing connection" << endl;
+            closeConnection();
+            return;
+        }
+
+        if (input.size() - offset - 4 < frameLength) {
             break;
+        }
 
-        XmlRpcValue resultValue;
+        BinaryFrameReader reader(input.data() + offset + 4, frameLength);
+        offset += 4 + frameLength;
 
-        if (_DHTputCAPIResponse->getIsSuccess() == true) {
-            resultValue = 0;
-            state[curAppFd]._response = generateResponse(resultValue.toXml());
-        } else {
-            std::cout << "XmlRpcInterface(): put() failed!" << endl;
-            state[curAppFd]._response = generateFaultResponse("put() failed", 22);
+        uint32_t requestId = reader.readUint32();
+        uint8_t opcode = reader.readUint8();
+
+        handleBinaryRequest(requestId, opcode, reader);
+
+        // the connection was closed due to a write error
+        if (!state[curAppFd].binary) {
+            return;
         }
+    }
 
-        state[curAppFd]._connectionState = WRITE_RESPONSE;
-        if (!writeResponse() ) {
-            closeConnection();
+    state[curAppFd]._input.assign(input, offset, std::string::npos);
+}
+
+void XmlRpcInterface::handleBinaryRequest(uint32_t requestId, uint8_t opcode,
+                                          BinaryFrameReader& reader)
+{
+    switch (opcode) {
+    case BIN_PUT: {
+        BinaryValue key = reader.readBytes();
+        BinaryValue value = reader.readBytes();
+        uint32_t ttl = reader.readUint32();
+
+        if (!reader.isValid()) {
+            sendBinaryError(requestId, BIN_INVALID,
+                            "put(key, value, ttl): Invalid argument type");
+        } else if (!isPrivileged()) {
+            sendBinaryError(requestId, BIN_NOT_ALLOWED, "put(): Not allowed");
+        } else if (overlay->getCompModule(TIER1_COMP) == NULL) {
+            sendBinaryError(requestId, BIN_NO_SERVICE, "put(): No DHT service");
+        } else {
+            DHTputCAPICall* dhtPutMsg = new DHTputCAPICall();
+            dhtPutMsg->setKey(OverlayKey::sha1(key));
+            dhtPutMsg->setValue(value);
+            dhtPutMsg->setTtl(ttl);
+            dhtPutMsg->setIsModifiable(true);
+            sendBinaryRpc(TIER1_COMP, dhtPutMsg, requestId);
         }
         break;
     }
-    RPC_ON_RESPONSE(DHTgetCAPI) {
-        if (state[curAppFd]._connectionState != EXECUTE_REQUEST)
-            break;
+    case BIN_GET: {
+        BinaryValue key = reader.readBytes();
+
+        if (!reader.isValid()) {
+            sendBinaryError(requestId, BIN_INVALID,
+                            "get(key): Invalid argument type");
+        } else if (overlay->getCompModule(TIER1_COMP) == NULL) {
+            sendBinaryError(requestId, BIN_NO_SERVICE, "get(): No DHT service");
+        } else {
+            DHTgetCAPICall* dhtGetMsg = new DHTgetCAPICall();
+            dhtGetMsg->setKey(OverlayKey::sha1(key));
+            sendBinaryRpc(TIER1_COMP, dhtGetMsg, requestId);
+        }
+        break;
+    }
+    case BIN_LOOKUP: {
+        BinaryValue key = reader.readBytes();
+        uint32_t numSiblings = reader.readUint32();
+        uint32_t routingType = reader.readUint32();
+
+        if (!reader.isValid()) {
+            sendBinaryError(requestId, BIN_INVALID,
+                            "lookup(key, numSiblings, routingType): "
+                            "Invalid argument type");
+        } else if (numSiblings > (uint32_t)overlay->getMaxNumSiblings()) {
+            sendBinaryError(requestId, BIN_INVALID,
+                            "lookup(): numSiblings to big");
+        } else if ((routingType != DEFAULT_ROUTING) &&
+                   (routingType != ITERATIVE_ROUTING) &&
+                   (routingType != EXHAUSTIVE_ITERATIVE_ROUTING) &&
+                   (routingType != SEMI_RECURSIVE_ROUTING) &&
+                   (routingType != FULL_RECURSIVE_ROUTING) &&
+                   (routingType != RECURSIVE_SOURCE_ROUTING)) {
+            sendBinaryError(requestId, BIN_INVALID,
+                            "lookup(): invalid routingType");
+        } else {
+            LookupCall* lookupCall = new LookupCall();
+            lookupCall->setKey(OverlayKey::sha1(key));
+            lookupCall->setNumSiblings(numSiblings);
+            lookupCall->setRoutingType(routingType);
+            sendBinaryRpc(OVERLAY_COMP, lookupCall, requestId);
+        }
+        break;
+    }
+    case BIN_REGISTER: {
+        BinaryValue name = reader.readBytes();
+        uint32_t kind = reader.readUint32();
+        uint32_t id = reader.readUint32();
+        BinaryValue address = reader.readBytes();
+        uint32_t ttl = reader.readUint32();
+
+        if (!reader.isValid()) {
+            sendBinaryError(requestId, BIN_INVALID,
+                            "register(name, kind, id, address, ttl): "
+                            "Invalid argument type");
+        } else if (overlay->getCompModule(TIER2_COMP) == NULL) {
+            sendBinaryError(requestId, BIN_NO_SERVICE,
+                            "register(): No P2PNS service");
+        } else if (!isPrivileged()) {
+            sendBinaryError(requestId, BIN_NOT_ALLOWED,
+                            "register(): Not allowed");
+        } else {
+            P2pnsRegisterCall* registerCall = new P2pnsRegisterCall();
+            registerCall->setP2pName(name);
+            registerCall->setKind(kind);
+            registerCall->setId(id);
+            registerCall->setAddress(address);
+            registerCall->setTtl(ttl);
+            sendBinaryRpc(TIER2_COMP, registerCall, requestId);
+        }
+        break;
+    }
+    case BIN_RESOLVE: {
+        BinaryValue name = reader.readBytes();
+        uint32_t kind = reader.readUint32();
+
+        if (!reader.isValid()) {
+            sendBinaryError(requestId, BIN_INVALID,
+                            "resolve(name, kind): Invalid argument type");
+        } else if (overlay->getCompModule(TIER2_COMP) == NULL) {
+            sendBinaryError(requestId, BIN_NO_SERVICE,
+                            "resolve(): No P2PNS service");
+        } else {
+            P2pnsResolveCall* resolveCall = new P2pnsResolveCall();
+            resolveCall->setP2pName(name);
+            resolveCall->setKind(kind);
+            resolveCall->setId(0);
+            sendBinaryRpc(TIER2_COMP, resolveCall, requestId);
+        }
+        break;
+    }
+    case BIN_DUMP_DHT: {
+        if (!isPrivileged()) {
+            sendBinaryError(requestId, BIN_NOT_ALLOWED,
+                            "dump_dht(): Not allowed");
+        } else if (overlay->getCompModule(TIER1_COMP) == NULL) {
+            sendBinaryError(requestId, BIN_NO_SERVICE,
+                            "dump_dht(): No DHT service");
+        } else {
+            sendBinaryRpc(TIER1_COMP, new DHTdumpCall(), requestId);
+        }
+        break;
+    }
+    case BIN_BATCH: {
+        uint32_t num = reader.readUint32();
 
-        XmlRpcValue resultValue;
-        resultValue.setSize(2);
-        resultValue[0].setSize(_DHTgetCAPIResponse->getResultArraySize());
+        for (uint32_t i = 0; i < num && reader.isValid(); i++) {
+            uint32_t subId = reader.readUint32();
+            uint8_t subOpcode = reader.readUint8();
+            BinaryFrameReader subReader = reader.readNested();
 
-        if (_DHTgetCAPIResponse->getIsSuccess() == true) {
-            for (uint i=0; i < _DHTgetCAPIResponse->getResultArraySize(); i++) {
-                resultValue[i].setSize(2);
-                DhtDumpEntry& entry = _DHTgetCAPIResponse->getResult(i);
-                resultValue[0][i] = XmlRpcValue(&(*(entry.getValue().begin())),
-                                                entry.getValue().size());
+            if (!reader.isValid()) {
+                break;
             }
-            resultValue[1] = std::string();
 
-//            resultValue[0][0] = XmlRpcValue(
-//                      &(*(_DHTgetCAPIResponse->getValue().begin())),
-//                      _DHTgetCAPIResponse->getValue().size());
-            state[curAppFd]._response = generateResponse(resultValue.toXml());
-        } else {
-            std::cout << "XmlRpcInterface(): get() failed!" << endl;
-            state[curAppFd]._response = generateFaultResponse("get() failed", 22);
+            if (subOpcode == BIN_BATCH) {
+                sendBinaryError(subId, BIN_INVALID, "nested batch");
+            } else {
+                handleBinaryRequest(subId, subOpcode, subReader);
+            }
+
+            if (!state[curAppFd].binary) {
+                return;
+            }
         }
 
-        state[curAppFd]._connectionState = WRITE_RESPONSE;
-        if (!writeResponse() ) {
+        if (!reader.isValid()) {
+            sendBinaryError(requestId, BIN_INVALID, "batch: truncated request");
+        }
+        break;
+    }
+    default:
+        sendBinaryError(requestId, BIN_INVALID, "unknown opcode");
+    }
+}
+
+void XmlRpcInterface::sendBinaryRpc(CompType destComp, BaseCallMessage *call,
+                                    uint32_t requestId)
+{
+    uint32_t nonce = sendInternalRpcCall(destComp, call, NULL,
+                                         XMLRPC_TIMEOUT, 0, curAppFd);
+    state[curAppFd].binaryRequests[nonce] = requestId;
+}
+
+void XmlRpcInterface::sendBinaryError(uint32_t requestId, BinaryStatus status,
+                                      const std::string& message)
+{
+    BinaryFrameWriter writer(requestId, status);
+    writer.writeBytes(message);
+    writeBinaryFrame(writer);
+}
+
+bool XmlRpcInterface::writeBinaryFrame(BinaryFrameWriter& writer)
+{
+    const std::string& frame = writer.getFrame();
+    size_t bytesWritten = 0;
+
+    // the scheduler refuses writes larger than the mtu
+    while (bytesWritten < frame.size()) {
+        size_t chunk = std::min((size_t)mtu, frame.size() - bytesWritten);
+        int curBytesWritten = scheduler->sendBytes(frame.data() + bytesWritten,
+                                                   chunk, 0, 0, true,
+                                                   curAppFd);
+
+        if (curBytesWritten <= 0) {
+            EV << "XmlRpcInterface::writeBinaryFrame(): write error" << endl;
             closeConnection();
+            return false;
+        }
+
+        bytesWritten += curBytesWritten;
+    }
+
+    return true;
+}
+
+void XmlRpcInterface::handleBinaryRpcResponse(BaseResponseMessage* msg)
+{
+    std::map<uint32_t, uint32_t>::iterator it =
+        state[curAppFd].binaryRequests.find(msg->getNonce());
+
+    if (it == state[curAppFd].binaryRequests.end()) {
+        return;
+    }
+
+    uint32_t requestId = it->second;
+    state[curAppFd].binaryRequests.erase(it);
+
+    RPC_SWITCH_START(msg)
+    RPC_ON_RESPONSE(Lookup) {
+        if (!_LookupResponse->getIsValid()) {
+            sendBinaryError(requestId, BIN_FAILED, "lookup() failed");
+            break;
+        }
+
+        BinaryFrameWriter writer(requestId, BIN_OK);
+        writer.writeUint32(_LookupResponse->getSiblingsArraySize());
+        for (uint32_t i = 0; i < _LookupResponse->getSiblingsArraySize(); i++) {
+            const NodeHandle& sibling = _LookupResponse->getSiblings(i);
+            writer.writeBytes(sibling.getIp().str());
+            writer.writeUint32(sibling.getPort());
+            writer.writeBytes(sibling.getKey().toString(16));
         }
+        writeBinaryFrame(writer);
         break;
     }
-    RPC_ON_RESPONSE(DHTdump) {
-        if (state[curAppFd]._connectionState != EXECUTE_REQUEST)
+    RPC_ON_RESPONSE(P2pnsRegister) {
+        if (!_P2pnsRegisterResponse->getIsSuccess()) {
+            sendBinaryError(requestId, BIN_FAILED, "register() failed");
             break;
+        }
 
-        XmlRpcValue resultValue;
-        resultValue.setSize(_DHTdumpResponse->getRecordArraySize());
+        BinaryFrameWriter writer(requestId, BIN_OK);
+        writeBinaryFrame(writer);
+        break;
+    }
+    RPC_ON_RESPONSE(P2pnsResolve) {
+        if (!_P2pnsResolveResponse->getIsSuccess()) {
+            sendBinaryError(requestId, BIN_FAILED,
+                            "resolve() failed: Name not found");
+            break;
+        }
 
-        for (uint32_t i=0; i < _DHTdumpResponse->getRecordArraySize();
+        BinaryFrameWriter writer(requestId, BIN_OK);
+        writer.writeUint32(_P2pnsResolveResponse->getAddressArraySize());
+        for (uint32_t i = 0; i < _P2pnsResolveResponse->getAddressArraySize();
              i++) {
-            resultValue[i].setSize(3);
-            resultValue[i][0] =
-                _DHTdumpResponse->getRecord(i).getKey().toString(16);
-            resultValue[i][1] = XmlRpcValue(
-                 &(*(_DHTdumpResponse->getRecord(i).getValue().begin())),
-                 _DHTdumpResponse->getRecord(i).getValue().size());
-            resultValue[i][2] =
-                _DHTdumpResponse->getRecord(i).getTtl();
+            writer.writeBytes(_P2pnsResolveResponse->getAddress(i));
+            writer.writeUint32(_P2pnsResolveResponse->getKind(i));
+            writer.writeUint32(_P2pnsResolveResponse->getId(i));
+        }
+        writeBinaryFrame(writer);
+        break;
+    }
+    RPC_ON_RESPONSE(DHTputCAPI) {
+        if (!_DHTputCAPIResponse->getIsSuccess()) {
+            sendBinaryError(requestId, BIN_FAILED, "put() failed");
+            break;
         }
 
-        state[curAppFd]._response = generateResponse(resultValue.toXml());
+        BinaryFrameWriter writer(requestId, BIN_OK);
+        writeBinaryFrame(writer);
+        break;
+    }
+    RPC_ON_RESPONSE(DHTgetCAPI) {
+        if (!_DHTgetCAPIResponse->getIsSuccess()) {
+            sendBinaryError(requestId, BIN_FAILED, "get() failed");
+            break;
+        }
 
-        state[curAppFd]._connectionState = WRITE_RESPONSE;
-         if (!writeResponse()) {
-             closeConnection();
-         }
-         break;
+        BinaryFrameWriter writer(requestId, BIN_OK);
+        writer.writeUint32(_DHTgetCAPIResponse->getResultArraySize());
+        for (uint32_t i = 0; i < _DHTgetCAPIResponse->getResultArraySize(); i++) {
+            writer.writeBytes(_DHTgetCAPIResponse->getResult(i).getValue());
+        }
+        writeBinaryFrame(writer);
+        break;
+    }
+    RPC_ON_RESPONSE(DHTdump) {
+        // stream the records, so large dumps don't have to be buffered
+        // in a single frame by the client
+        uint32_t numRecords = _DHTdumpResponse->getRecordArraySize();
+        uint32_t i = 0;
+
+        do {
+            uint32_t num = std::min(numRecords - i,
+                                    BINARY_DUMP_RECORDS_PER_FRAME);
+            bool last = (i + num == numRecords);
+
+            BinaryFrameWriter writer(requestId, last ? BIN_OK : BIN_MORE);
+            writer.writeUint32(num);
+            for (uint32_t end = i + num; i < end; i++) {
+                const DhtDumpEntry& entry = _DHTdumpResponse->getRecord(i);
+                writer.writeBytes(entry.getKey().toString(16));
+                writer.writeBytes(entry.getValue());
+                writer.writeUint32(entry.getTtl());
+            }
 
+            if (!writeBinaryFrame(writer)) {
+                break;
+            }
+        } while (i < numRecords);
+        break;
     }
     RPC_SWITCH_END( )
 }
@@ -1074,16 +1714,24 @@ bool XmlRpcInterface::writeResponse()
         }
     }
 
-    // Try to write the response
-    int curBytesWritten = scheduler->sendBytes(state[curAppFd]._response.c_str(),
-                                               state[curAppFd]._response.length(),
-                                               0, 0, true, curAppFd);
-
-    if (curBytesWritten <= 0) {
-        XmlRpcUtil::error("XmlRpcServerConnection::writeResponse: write error.");
-        return false;
-    } else {
-        state[curAppFd]._bytesWritten += curBytesWritten;
+    // Try to write the response (the scheduler refuses writes larger
+    // than the mtu, so large multicall responses are split)
+    while (state[curAppFd]._bytesWritten <
+           int(state[curAppFd]._response.length())) {
+        size_t chunk = std::min((size_t)mtu,
+                                state[curAppFd]._response.length() -
+                                state[curAppFd]._bytesWritten);
+        int curBytesWritten = scheduler->sendBytes(
+                state[curAppFd]._response.c_str() +
+                state[curAppFd]._bytesWritten,
+                chunk, 0, 0, true, curAppFd);
+
+        if (curBytesWritten <= 0) {
+            XmlRpcUtil::error("XmlRpcServerConnection::writeResponse: write error.");
+            return false;
+        } else {
+            state[curAppFd]._bytesWritten += curBytesWritten;
+        }
     }
 
     XmlRpcUtil::log(3,
@@ -32,6 +32,7 @@
 #include <tunoutscheduler.h>
 #include <realtimescheduler.h>
 #include <XmlRpc.h>
+#include "BinaryClientProtocol.h"
 
 class P2pns;
 
@@ -93,6 +94,30 @@ protected:
 
         //! the nonce of the pending internal RPC this connection is waiting for
         uint32_t pendingRpc;
+
+        //! true, if the connection uses the binary client protocol
+        bool binary;
+
+        //! true, if the magic of the binary protocol has been received
+        bool binaryMagic;
+
+        //! received bytes not yet parsed into binary frames
+        std::string _input;
+
+        //! maps the nonces of pending binary requests to their requestIds
+        std::map<uint32_t, uint32_t> binaryRequests;
+
+        //! index of the call currently executed by a multicall, or -1
+        int multiIndex;
+
+        //! true, if multicall results are wrapped in an array (system.multicall)
+        bool multiWrap;
+
+        //! results of the current multicall
+        XmlRpc::XmlRpcValue _multiResult;
+
+        //! maps the nonces of pending internal RPCs to their multicall index
+        std::map<uint32_t, int> multiRequests;
     };
 
     std::map<int, XmlRpcConnectionState> state;
@@ -107,6 +132,8 @@ protected:
     XmlRpc::XmlRpcServerMethod* _get;
     XmlRpc::XmlRpcServerMethod* _dumpDht;
     XmlRpc::XmlRpcServerMethod* _joinOverlay;
+    XmlRpc::XmlRpcServerMethod* _multiPut;
+    XmlRpc::XmlRpcServerMethod* _multiGet;
 
     /**
      * Check if the connected application is allowed to call privileged
@@ -132,6 +159,66 @@ protected:
 
     void closeConnection();
     void sendInternalRpcWithTimeout(CompType destComp, BaseCallMessage *call);
+
+    /**
+     * Converts the response of an internal RPC into the XML-RPC result
+     *
+     * @throws XmlRpc::XmlRpcException if the RPC failed
+     * @return false, if the response type is unknown
+     */
+    bool getRpcResult(BaseResponseMessage* msg, XmlRpc::XmlRpcValue& result);
+
+    /**
+     * system.multicall implementation which executes the RPCs of all
+     * calls in parallel. The response is sent when all RPCs are finished.
+     */
+    virtual bool executeMulticall(const std::string& methodName,
+                                  XmlRpc::XmlRpcValue& params,
+                                  XmlRpc::XmlRpcValue& result);
+
+    //! Prepares the connection state for a multicall with numCalls calls
+    void startMulticall(int numCalls, bool wrap);
+
+    //! Executes a single call of a multicall
+    void executeMulticallEntry(int index, const std::string& methodName,
+                               XmlRpc::XmlRpcValue& params);
+
+    //! Returns the results, if no internal RPCs of the multicall are pending
+    void finishMulticall(XmlRpc::XmlRpcValue& result);
+
+    void setMulticallResult(int index, XmlRpc::XmlRpcValue& value);
+    void setMulticallFault(int index, const std::string& message, int code);
+
+    //! Sends the multicall response after the last pending RPC finished
+    void completeMulticall();
+
+    /**
+     * Parses the frames of a connection using the binary client protocol
+     * (see BinaryClientProtocol.h)
+     */
+    void handleBinaryPacket(char *buf, uint32_t length);
+
+    /**
+     * Executes a single binary request. Errors are reported with a
+     * response frame, results are sent when the internal RPC returns.
+     */
+    void handleBinaryRequest(uint32_t requestId, uint8_t opcode,
+                             BinaryFrameReader& reader);
+
+    void handleBinaryRpcResponse(BaseResponseMessage* msg);
+
+    void sendBinaryRpc(CompType destComp, BaseCallMessage *call,
+                       uint32_t requestId);
+
+    void sendBinaryError(uint32_t requestId, BinaryStatus status,
+                         const std::string& message);
+
+    /**
+     * Writes a frame to the current connection, which is closed on error
+     *
+     * @return true, if the frame was written
+     */
+    bool writeBinaryFrame(BinaryFrameWriter& writer);
     virtual void handleReadyMessage(CompReadyMessage* msg);
 
     SOCKET appTunFd; /**< FD of the application TUN socket used for tunneling */
@@ -165,6 +252,8 @@ public:
     void get(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result);
     void dumpDht(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result);
     void joinOverlay(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result);
+    void multiPut(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result);
+    void multiGet(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result);
 };
 
 #endif
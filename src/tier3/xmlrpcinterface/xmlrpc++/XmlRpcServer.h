@@ -131,7 +131,7 @@ namespace XmlRpc {
 
     //! Execute multiple calls and return the results in an array.
     //! System.multicall implementation
-    bool executeMulticall(const std::string& methodName, XmlRpcValue& params, XmlRpcValue& result);
+    virtual bool executeMulticall(const std::string& methodName, XmlRpcValue& params, XmlRpcValue& result);
 
     //! Construct a response from the result XML.
     std::string generateResponse(std::string const& resultXml);
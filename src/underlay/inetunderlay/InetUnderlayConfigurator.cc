@@ -38,6 +38,8 @@
 
 #include <InetInfo.h>
 
+#include "ShortestPathMatrix.h"
+
 Define_Module(InetUnderlayConfigurator);
 
 void InetUnderlayConfigurator::initializeUnderlay(int stage)
@@ -377,13 +379,15 @@ void InetUnderlayConfigurator::setUpIPv4(cTopology &topo)
         }
     }
 
-    // Fill in routing tables.
-    for (int i = 0; i < topo.getNumNodes(); i++) {
-        cTopology::Node* destNode = topo.getNode(i);
-        uint32 destAddr = nodeAddresses[i];
+    // calculate shortest paths between all routers
+    ShortestPathMatrix paths;
+    paths.calculate(topo, par("routingThreads"),
+                    par("routingCacheDir").stdstringValue());
 
-        // calculate shortest paths from everywhere towards destNode
-        topo.calculateUnweightedSingleShortestPathsTo(destNode);
+    int numNodes = topo.getNumNodes();
+
+    for (int i = 0; i < numNodes; i++) {
+        cTopology::Node* destNode = topo.getNode(i);
 
         // add overlayAccessRouters and overlayBackboneRouters
         // to the GlobalNodeList
@@ -394,7 +398,6 @@ void InetUnderlayConfigurator::setUpIPv4(cTopology &topo)
             globalNodeList->addPeer(IPvXAddress(nodeAddresses[i]), info);
         }
 
-
         // If destNode is the outRouter, add a default route
         // to outside network via the TunOutDevice and a route to the
         // Gateway
@@ -416,55 +419,75 @@ void InetUnderlayConfigurator::setUpIPv4(cTopology &topo)
             gwRoute->setSource(IPRoute::MANUAL);
             IPAddressResolver().routingTableOf(destNode->getModule())->addRoute(gwRoute);
         }
+    }
 
-        // add route (with host=destNode) to every routing table in the network
-        for (int j = 0; j < topo.getNumNodes(); j++) {
+    // Fill in routing tables.
+    for (int j = 0; j < numNodes; j++) {
+        cTopology::Node* atNode = topo.getNode(j);
+
+        // find atNode's interface and routing table
+        IInterfaceTable* ift = IPAddressResolver().interfaceTableOf(atNode->getModule());
+        IRoutingTable* rt = IPAddressResolver().routingTableOf(atNode->getModule());
+
+        for (int i = 0; i < numNodes; i++) {
             // continue if same node
             if (i == j)
                 continue;
 
             // cancel simulation if node is not connected with destination
-            cTopology::Node* atNode = topo.getNode(j);
-
-            if (atNode->getNumPaths() == 0) {
+            if (paths.getPath(j, i) == NULL) {
                 error((std::string(atNode->getModule()->getName()) + ": Network is not entirely connected."
                         "Please increase your value for the "
                         "connectivity parameter").c_str());
             }
+        }
+
+        std::vector<int> routePrefixBits;
+        aggregateRoutes(paths, nodeAddresses, j, routePrefixBits);
+
+        for (int i = 0; i < numNodes; i++) {
+            // continue if same node
+            if (i == j)
+                continue;
+
+            cTopology::Node* destNode = topo.getNode(i);
+            uint32 destAddr = nodeAddresses[i];
+            cTopology::LinkOut* path = paths.getPath(j, i);
 
             //
             // Add routes at the atNode.
             //
 
-            // find atNode's interface and routing table
-            IInterfaceTable* ift = IPAddressResolver().interfaceTableOf(atNode->getModule());
-            IRoutingTable* rt = IPAddressResolver().routingTableOf(atNode->getModule());
-
             // find atNode's interface entry for the next hop node
-            int outputGateId = atNode->getPath(0)->getLocalGate()->getId();
+            int outputGateId = path->getLocalGate()->getId();
             InterfaceEntry *ie = ift->getInterfaceByNodeOutputGateId(outputGateId);
 
             // find the next hop node on the path towards destNode
-            cModule* next_hop = atNode->getPath(0)->getRemoteNode()->getModule();
+            cModule* next_hop = path->getRemoteNode()->getModule();
             IPAddress next_hop_ip = IPAddressResolver().addressOf(next_hop).get4();
 
-
             // Requirement 1: Each router has exactly one routing entry
-            // (netmask 255.255.0.0) to each other router
-            IPRoute* re = new IPRoute();
-
-            re->setHost(IPAddress(destAddr));
-            re->setInterface(ie);
-            re->setSource(IPRoute::MANUAL);
-            re->setNetmask(IPAddress(255, 255, 0, 0));
-            re->setGateway(IPAddress(next_hop_ip));
-            re->setType(IPRoute::REMOTE);
-
-            rt->addRoute(re);
+            // (netmask 255.255.0.0) to each other router. Consecutive
+            // router prefixes with the same next hop are aggregated
+            // into a single entry, if they fill an aligned block.
+            int prefixBits = routePrefixBits[i];
+            if (prefixBits >= 0) {
+                IPRoute* re = new IPRoute();
+                uint32 netmask = prefixBits ? ~(uint32)0 << (32 - prefixBits) : 0;
+
+                re->setHost(IPAddress(destAddr & netmask));
+                re->setInterface(ie);
+                re->setSource(IPRoute::MANUAL);
+                re->setNetmask(IPAddress(netmask));
+                re->setGateway(IPAddress(next_hop_ip));
+                re->setType(IPRoute::REMOTE);
+
+                rt->addRoute(re);
+            }
 
             // Requirement 2: Each router has a point-to-point routing
             // entry (netmask 255.255.255.255) for each immediate neighbour
-            if (atNode->getDistanceToTarget() == 1) {
+            if (path->getRemoteNode() == destNode) {
                 IPRoute* re2 = new IPRoute();
 
                 re2->setHost(IPAddress(destAddr));
@@ -493,6 +516,67 @@ void InetUnderlayConfigurator::setUpIPv4(cTopology &topo)
     }
 }
 
+void InetUnderlayConfigurator::aggregateRoutes(const ShortestPathMatrix& paths,
+                                               const std::vector<uint32>& nodeAddresses,
+                                               int atNode,
+                                               std::vector<int>& prefixBits)
+{
+    // router i owns the /16 prefix (nodeAddresses[0] >> 16) + i
+    uint32 firstPrefix = nodeAddresses[0] >> 16;
+    uint32 numNodes = nodeAddresses.size();
+
+    prefixBits.assign(numNodes, -1);
+
+    // hops[b][t - (firstPrefix >> b)] is the next hop of all routers in
+    // the aligned block t of 2^b prefixes, or NULL if the next hops
+    // differ, the block contains atNode or isn't complete
+    std::vector<std::vector<cTopology::LinkOut*> > hops(17);
+
+    hops[0].resize(numNodes);
+    for (uint32 k = 0; k < numNodes; k++) {
+        hops[0][k] = ((int)k == atNode) ? NULL : paths.getPath(atNode, k);
+    }
+
+    for (int b = 1; b <= 16; b++) {
+        uint32 base = firstPrefix >> b;
+        uint32 childBase = firstPrefix >> (b - 1);
+        const std::vector<cTopology::LinkOut*>& children = hops[b - 1];
+
+        hops[b].resize(((firstPrefix + numNodes - 1) >> b) - base + 1);
+        for (uint32 idx = 0; idx < hops[b].size(); idx++) {
+            uint32 left = 2 * (base + idx);
+            cTopology::LinkOut* hop = NULL;
+
+            // both halves have to be complete and use the same next hop
+            if (left >= childBase && left + 1 - childBase < children.size()) {
+                hop = children[left - childBase];
+                if (hop != children[left + 1 - childBase]) {
+                    hop = NULL;
+                }
+            }
+            hops[b][idx] = hop;
+        }
+    }
+
+    // one route per maximal block, added by the first router of the block
+    for (int b = 0; b <= 16; b++) {
+        uint32 base = firstPrefix >> b;
+        for (uint32 idx = 0; idx < hops[b].size(); idx++) {
+            if (hops[b][idx] == NULL) {
+                continue;
+            }
+
+            uint32 block = base + idx;
+            if (b < 16 &&
+                hops[b + 1][(block >> 1) - (firstPrefix >> (b + 1))] != NULL) {
+                continue;
+            }
+
+            prefixBits[(block << b) - firstPrefix] = 16 - b;
+        }
+    }
+}
+
 void InetUnderlayConfigurator::setUpIPv6(cTopology &topo)
 {
     // Assign IP addresses to all router modules.
@@ -551,13 +635,14 @@ void InetUnderlayConfigurator::setUpIPv6(cTopology &topo)
         }
     }
 
+    // calculate shortest paths between all routers
+    ShortestPathMatrix paths;
+    paths.calculate(topo, par("routingThreads"),
+                    par("routingCacheDir").stdstringValue());
+
     // Fill in routing tables.
     for (int i = 0; i < topo.getNumNodes(); i++) {
         cTopology::Node* destNode = topo.getNode(i);
-        IPv6Words destAddr = nodeAddresses[i];
-
-        // calculate shortest paths from everywhere towards destNode
-        topo.calculateUnweightedSingleShortestPathsTo(destNode);
 
         // add overlayAccessRouters and overlayBackboneRouters
         // to the GlobalNodeList
@@ -577,7 +662,9 @@ void InetUnderlayConfigurator::setUpIPv6(cTopology &topo)
             // cancel simulation if node is not connected with destination
             cTopology::Node* atNode = topo.getNode(j);
 
-            if (atNode->getNumPaths() == 0) {
+            cTopology::LinkOut* path = paths.getPath(j, i);
+
+            if (path == NULL) {
                 error((std::string(atNode->getModule()->getName()) + ": Network is not entirely connected."
                         "Please increase your value for the "
                         "connectivity parameter").c_str());
@@ -592,14 +679,14 @@ void InetUnderlayConfigurator::setUpIPv6(cTopology &topo)
             RoutingTable6* rt = IPAddressResolver().routingTable6Of(atNode->getModule());
 
             // find atNode's interface entry for the next hop node
-            int outputGateId = atNode->getPath(0)->getLocalGate()->getId();
+            int outputGateId = path->getLocalGate()->getId();
             InterfaceEntry *ie = ift->getInterfaceByNodeOutputGateId(outputGateId);
 
             // find the next hop node on the path towards destNode
-            cModule* next_hop = atNode->getPath(0)->getRemoteNode()->getModule();
+            cModule* next_hop = path->getRemoteNode()->getModule();
             int destGateId = destNode->getLinkIn(0)->getLocalGateId();
             IInterfaceTable* destIft = IPAddressResolver().interfaceTableOf(destNode->getModule());
-            int remoteGateId = atNode->getPath(0)->getRemoteGateId();
+            int remoteGateId = path->getRemoteGateId();
             IInterfaceTable* remoteIft = IPAddressResolver().interfaceTableOf(next_hop);
             IPv6Address next_hop_ip = remoteIft->getInterfaceByNodeInputGateId(remoteGateId)->ipv6Data()->getLinkLocalAddress();
             IPv6InterfaceData::AdvPrefix destPrefix = destIft->getInterfaceByNodeInputGateId(destGateId)->ipv6Data()->getAdvPrefix(0);
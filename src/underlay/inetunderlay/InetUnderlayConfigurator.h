@@ -31,6 +31,7 @@
 #include <UnderlayConfigurator.h>
 
 class IPvXAddress;
+class ShortestPathMatrix;
 
 /**
  * Configurator module for the InetUnderlay
@@ -85,6 +86,22 @@ protected:
     void setUpIPv4(cTopology &topo);
     void setUpIPv6(cTopology &topo);
 
+    /**
+     * Aggregates the routes of atNode to all other routers into
+     * maximal aligned prefix blocks with the same next hop, in a single
+     * bottom-up pass over the next hops of atNode
+     *
+     * @param paths the paths between all routers
+     * @param nodeAddresses the addresses of all routers
+     * @param atNode index of the router, whose routes are calculated
+     * @param prefixBits returns the prefix length of the route to each
+     *        router, or -1 if the route is added together with the
+     *        route of the first router of its block
+     */
+    void aggregateRoutes(const ShortestPathMatrix& paths,
+                         const std::vector<uint32>& nodeAddresses,
+                         int atNode, std::vector<int>& prefixBits);
+
     /**
      * process timer messages
      *
@@ -0,0 +1,303 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file ShortestPathMatrix.cc
+ * @author agent
+ */
+
+#include <map>
+#include <deque>
+#include <cstdio>
+#include <cstring>
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#include "ShortestPathMatrix.h"
+
+static const char CACHE_MAGIC[8] = "OSROUTE";
+static const uint32_t CACHE_VERSION = 1;
+
+struct ShortestPathCacheHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t numNodes;
+    uint64_t hash;
+};
+
+const uint16_t ShortestPathMatrix::NO_PATH;
+
+ShortestPathMatrix::ShortestPathMatrix()
+{
+    topo = NULL;
+    numNodes = 0;
+    cached = false;
+}
+
+void ShortestPathMatrix::calculate(cTopology& topology, int numThreads,
+                                   const std::string& cacheDir)
+{
+    topo = &topology;
+    numNodes = topo->getNumNodes();
+    cached = false;
+    outLinks.clear();
+
+    if (numNodes == 0) {
+        return;
+    }
+
+    extractGraph();
+
+    std::string fileName;
+    uint64_t hash = 0;
+
+    if (cacheDir.size()) {
+        hash = hashGraph();
+        char name[32];
+        sprintf(name, "/%016llx.routes", (unsigned long long)hash);
+        fileName = cacheDir + name;
+
+        if (readCache(fileName, hash)) {
+            cached = true;
+            return;
+        }
+    }
+
+    outLinks.assign((size_t)numNodes * numNodes, NO_PATH);
+
+#ifndef _WIN32
+    if (numThreads <= 0) {
+        numThreads = sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (numThreads > numNodes) {
+        numThreads = numNodes;
+    }
+
+    if (numThreads > 1) {
+        std::vector<pthread_t> threads(numThreads);
+        std::vector<SearchTask> tasks(numThreads);
+        int started = 0;
+
+        for (int i = 0; i < numThreads; i++) {
+            tasks[i].matrix = this;
+            tasks[i].first = i;
+            tasks[i].step = numThreads;
+            if (pthread_create(&threads[i], NULL, searchThread,
+                               &tasks[i]) != 0) {
+                break;
+            }
+            started++;
+        }
+
+        // destinations of threads that couldn't be started
+        for (int i = started; i < numThreads; i++) {
+            search(i, numThreads);
+        }
+
+        for (int i = 0; i < started; i++) {
+            pthread_join(threads[i], NULL);
+        }
+    } else {
+        search(0, 1);
+    }
+#else
+    search(0, 1);
+#endif
+
+    if (fileName.size()) {
+        writeCache(fileName, hash);
+    }
+}
+
+void* ShortestPathMatrix::searchThread(void* arg)
+{
+    SearchTask* task = static_cast<SearchTask*>(arg);
+    task->matrix->search(task->first, task->step);
+    return NULL;
+}
+
+void ShortestPathMatrix::search(int first, int step)
+{
+    // same search as cTopology::calculateUnweightedSingleShortestPathsTo()
+    std::vector<int> dist(numNodes);
+    std::deque<int> queue;
+
+    for (int dest = first; dest < numNodes; dest += step) {
+        uint16_t* paths = &outLinks[(size_t)dest * numNodes];
+
+        dist.assign(numNodes, -1);
+        dist[dest] = 0;
+        queue.push_back(dest);
+
+        while (!queue.empty()) {
+            int v = queue.front();
+            queue.pop_front();
+
+            for (int i = inLinkStart[v]; i < inLinkStart[v + 1]; i++) {
+                int w = inLinkSource[i];
+                if (!nodeEnabled[w] || dist[w] >= 0) {
+                    continue;
+                }
+                dist[w] = dist[v] + 1;
+                paths[w] = inLinkSourceOut[i];
+                queue.push_back(w);
+            }
+        }
+    }
+}
+
+void ShortestPathMatrix::extractGraph()
+{
+    std::map<cTopology::Node*, int> nodeIndex;
+    for (int i = 0; i < numNodes; i++) {
+        nodeIndex[topo->getNode(i)] = i;
+    }
+
+    // position of every link in the outgoing links of its source
+    std::map<cTopology::Link*, uint16_t> outIndex;
+    for (int i = 0; i < numNodes; i++) {
+        cTopology::Node* node = topo->getNode(i);
+        if (node->getNumOutLinks() >= NO_PATH) {
+            throw cRuntimeError("ShortestPathMatrix::extractGraph(): "
+                                "Too many links at node %s",
+                                node->getModule()->getFullPath().c_str());
+        }
+        for (int j = 0; j < node->getNumOutLinks(); j++) {
+            outIndex[node->getLinkOut(j)] = j;
+        }
+    }
+
+    inLinkStart.assign(numNodes + 1, 0);
+    inLinkSource.clear();
+    inLinkSourceOut.clear();
+    nodeEnabled.assign(numNodes, false);
+
+    // disabled links are left out, the order of the remaining links
+    // determines which of several shortest paths is chosen
+    for (int i = 0; i < numNodes; i++) {
+        cTopology::Node* node = topo->getNode(i);
+        nodeEnabled[i] = node->isEnabled();
+        inLinkStart[i] = inLinkSource.size();
+
+        for (int j = 0; j < node->getNumInLinks(); j++) {
+            cTopology::LinkIn* link = node->getLinkIn(j);
+            if (!link->isEnabled()) {
+                continue;
+            }
+            inLinkSource.push_back(nodeIndex[link->getRemoteNode()]);
+            inLinkSourceOut.push_back(outIndex[link]);
+        }
+    }
+    inLinkStart[numNodes] = inLinkSource.size();
+}
+
+uint64_t ShortestPathMatrix::hashGraph() const
+{
+    // FNV-1a over the node names and the extracted links
+    uint64_t hash = 14695981039346656037ULL;
+
+#define HASH_BYTES(p, n) \
+    for (size_t k = 0; k < (size_t)(n); k++) { \
+        hash ^= ((const unsigned char*)(p))[k]; \
+        hash *= 1099511628211ULL; \
+    }
+
+    HASH_BYTES(&numNodes, sizeof(numNodes));
+
+    for (int i = 0; i < numNodes; i++) {
+        std::string path = topo->getNode(i)->getModule()->getFullPath();
+        HASH_BYTES(path.c_str(), path.size() + 1);
+        bool enabled = nodeEnabled[i];
+        HASH_BYTES(&enabled, sizeof(enabled));
+    }
+
+    HASH_BYTES(&inLinkStart[0], inLinkStart.size() * sizeof(int));
+    if (inLinkSource.size()) {
+        HASH_BYTES(&inLinkSource[0], inLinkSource.size() * sizeof(int));
+        HASH_BYTES(&inLinkSourceOut[0],
+                   inLinkSourceOut.size() * sizeof(uint16_t));
+    }
+
+#undef HASH_BYTES
+
+    return hash;
+}
+
+bool ShortestPathMatrix::readCache(const std::string& fileName, uint64_t hash)
+{
+    FILE* file = fopen(fileName.c_str(), "rb");
+    if (file == NULL) {
+        return false;
+    }
+
+    ShortestPathCacheHeader header;
+    bool valid = (fread(&header, sizeof(header), 1, file) == 1) &&
+        (memcmp(header.magic, CACHE_MAGIC, sizeof(header.magic)) == 0) &&
+        (header.version == CACHE_VERSION) &&
+        (header.numNodes == (uint32_t)numNodes) &&
+        (header.hash == hash);
+
+    if (valid) {
+        outLinks.resize((size_t)numNodes * numNodes);
+        valid = (fread(&outLinks[0], sizeof(uint16_t), outLinks.size(), file)
+                 == outLinks.size());
+    }
+
+    fclose(file);
+
+    if (!valid) {
+        EV << "[ShortestPathMatrix::readCache()]\n"
+           << "    Ignoring invalid route cache " << fileName << endl;
+    }
+
+    return valid;
+}
+
+void ShortestPathMatrix::writeCache(const std::string& fileName,
+                                    uint64_t hash) const
+{
+    // write to a temporary file first, so concurrent runs never read
+    // an incomplete matrix
+    std::string tmpName = fileName + ".tmp";
+    FILE* file = fopen(tmpName.c_str(), "wb");
+    if (file == NULL) {
+        EV << "[ShortestPathMatrix::writeCache()]\n"
+           << "    Can't write route cache " << fileName << endl;
+        return;
+    }
+
+    ShortestPathCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+    header.version = CACHE_VERSION;
+    header.numNodes = numNodes;
+    header.hash = hash;
+
+    bool ok = (fwrite(&header, sizeof(header), 1, file) == 1) &&
+        (fwrite(&outLinks[0], sizeof(uint16_t), outLinks.size(), file)
+         == outLinks.size());
+
+    if ((fclose(file) != 0) || !ok ||
+            (rename(tmpName.c_str(), fileName.c_str()) != 0)) {
+        remove(tmpName.c_str());
+    }
+}
@@ -0,0 +1,126 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file ShortestPathMatrix.h
+ * @author agent
+ */
+
+#ifndef __SHORTESTPATHMATRIX_H__
+#define __SHORTESTPATHMATRIX_H__
+
+#include <vector>
+#include <string>
+#include <stdint.h>
+
+#include <omnetpp.h>
+
+/**
+ * Unweighted shortest paths between all pairs of nodes of a cTopology
+ *
+ * The paths are the same as those of
+ * cTopology::calculateUnweightedSingleShortestPathsTo() for every node
+ * (same breadth-first search order), but the searches run in parallel
+ * on plain arrays and only the first link of every path is stored in
+ * an n x n matrix. The matrix can be cached in a file, which is keyed
+ * by a hash of the topology (module paths and links), so repeated runs
+ * with the same topology skip the calculation.
+ *
+ * @author agent
+ */
+class ShortestPathMatrix
+{
+  public:
+    ShortestPathMatrix();
+
+    /**
+     * Calculates the paths between all pairs of nodes of topo,
+     * disabled nodes and links are ignored
+     *
+     * @param topo the topology, must not be changed while the
+     *             ShortestPathMatrix is used
+     * @param numThreads number of threads, 0 for one thread per core
+     * @param cacheDir directory of the cached matrices, "" to disable
+     *                 the cache
+     */
+    void calculate(cTopology& topo, int numThreads = 0,
+                   const std::string& cacheDir = "");
+
+    /**
+     * Returns the first link on the path from node src to node dest,
+     * like src->getPath(0) after
+     * calculateUnweightedSingleShortestPathsTo(dest)
+     *
+     * @param src index of the source node in the topology
+     * @param dest index of the destination node in the topology
+     * @return the link, NULL if dest isn't reachable from src
+     */
+    cTopology::LinkOut* getPath(int src, int dest) const
+    {
+        uint16_t link = outLinks[(size_t)dest * numNodes + src];
+        return (link == NO_PATH) ? NULL : topo->getNode(src)->getLinkOut(link);
+    };
+
+    /**
+     * Returns true, if the path from src to dest consists of a single link
+     */
+    bool isNeighbor(int src, int dest) const
+    {
+        cTopology::LinkOut* link = getPath(src, dest);
+        return link && (link->getRemoteNode() == topo->getNode(dest));
+    };
+
+    /** Returns true, if the matrix has been loaded from the cache */
+    bool isCached() const { return cached; };
+
+  private:
+    static const uint16_t NO_PATH = 0xffff;
+
+    /** arguments of the search threads */
+    struct SearchTask
+    {
+        ShortestPathMatrix* matrix;
+        int first; /**< first destination of the thread */
+        int step; /**< number of threads */
+    };
+
+    static void* searchThread(void* arg);
+
+    /** breadth-first searches towards the destinations first, first+step, ... */
+    void search(int first, int step);
+
+    void extractGraph();
+    uint64_t hashGraph() const;
+    bool readCache(const std::string& fileName, uint64_t hash);
+    void writeCache(const std::string& fileName, uint64_t hash) const;
+
+    cTopology* topo;
+    int numNodes;
+    bool cached;
+
+    // incoming links of all nodes in compressed row format
+    std::vector<int> inLinkStart; /**< first link of node i, size numNodes + 1 */
+    std::vector<int> inLinkSource; /**< index of the source node of a link */
+    std::vector<uint16_t> inLinkSourceOut; /**< index of the link at the source node */
+    std::vector<bool> nodeEnabled;
+
+    /** index of the first outgoing link of node src towards dest at dest * numNodes + src */
+    std::vector<uint16_t> outLinks;
+};
+
+#endif
@@ -25,6 +25,8 @@
 #include "RUNetworkConfigurator.h"
 #include <sstream>
 
+#include <ShortestPathMatrix.h>
+
 
 Define_Module( RUNetworkConfigurator);
 
@@ -326,18 +328,22 @@ void RUNetworkConfigurator::setIntraASRoutes(cTopology &topology, nodeInfoAS &as
     // calculate static routes from each of the AS's router-level nodes to all
     // other nodes of the AS
 
+    //
+    // calculate shortest paths between all nodes of the AS
+    //
+    ShortestPathMatrix paths;
+    paths.calculate(topology, par("routingThreads"),
+                    par("routingCacheDir").stdstringValue());
+
     for (int i = 0; i < topology.getNumNodes(); i++) {
         nodeInfoRL destNode = asInfo.nodeMap[topology.getNode(i)->getModule()->getId()];
-        //
-        // calculate shortest path form everywhere toward destNode
-        //
-        topology.calculateUnweightedSingleShortestPathsTo(destNode.node);
         for (int j = 0; j < topology.getNumNodes(); j++) {
             if (j == i)
                 continue;
             nodeInfoRL srcNode = asInfo.nodeMap[topology.getNode(j)->getModule()->getId()];
+            cTopology::LinkOut* path = paths.getPath(j, i);
             // no route exists at all
-            if (srcNode.node->getNumPaths() == 0)
+            if (path == NULL)
                 continue;
             // end systems only know a default route to the edge router
             else if (srcNode.routerType == ENDSYS)
@@ -345,7 +351,7 @@ void RUNetworkConfigurator::setIntraASRoutes(cTopology &topology, nodeInfoAS &as
             else if (destNode.routerType == ENDSYS) {
                 if (srcNode.routerType != EDGE)
                         continue;
-                InterfaceEntry *ie = srcNode.ift->getInterfaceByNodeOutputGateId(srcNode.node->getPath(0)->getLocalGate()->getId());
+                InterfaceEntry *ie = srcNode.ift->getInterfaceByNodeOutputGateId(path->getLocalGate()->getId());
                 if (ie == srcNode.defaultRouteIE)
                     continue;
 
@@ -376,7 +382,7 @@ void RUNetworkConfigurator::setIntraASRoutes(cTopology &topology, nodeInfoAS &as
                 e->setSource(IPRoute::MANUAL);
                 destNode.rt->addRoute(e);
 
-                ie = srcNode.ift->getInterfaceByNodeOutputGateId(srcNode.node->getPath(0)->getLocalGate()->getId());
+                ie = srcNode.ift->getInterfaceByNodeOutputGateId(path->getLocalGate()->getId());
                 e = new IPRoute();
                 e->setHost(destNode.addr);
                 e->setNetmask(IPAddress(255, 255, 255, 255));
@@ -389,7 +395,7 @@ void RUNetworkConfigurator::setIntraASRoutes(cTopology &topology, nodeInfoAS &as
                 //
                 // if destination is reachable through default route, no routing entry is necessary
                 //
-                InterfaceEntry *ie = srcNode.ift->getInterfaceByNodeOutputGateId(srcNode.node->getPath(0)->getLocalGate()->getId());
+                InterfaceEntry *ie = srcNode.ift->getInterfaceByNodeOutputGateId(path->getLocalGate()->getId());
                 if (ie == srcNode.defaultRouteIE)
                     continue;
                 else {
@@ -0,0 +1,154 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file LatencyMatrix.cc
+ * @author agent
+ */
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#else
+#include <io.h>
+#endif
+
+#include "LatencyMatrix.h"
+
+static const char LATENCY_MATRIX_MAGIC[8] = "OSRTT";
+static const uint32_t LATENCY_MATRIX_VERSION = 1;
+
+LatencyMatrix::LatencyMatrix()
+{
+    data = NULL;
+    dataSize = 0;
+    rtts = NULL;
+    numNodes = 0;
+    delayScale = 0;
+}
+
+LatencyMatrix::~LatencyMatrix()
+{
+    close();
+}
+
+void LatencyMatrix::open(const std::string& name)
+{
+    if (data != NULL && fileName == name) {
+        return;
+    }
+
+    close();
+
+    int fd = ::open(name.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw cRuntimeError("LatencyMatrix::open(): Can't open file %s: %s",
+                            name.c_str(), strerror(errno));
+    }
+
+    struct stat filestat;
+    if (fstat(fd, &filestat)) {
+        ::close(fd);
+        throw cRuntimeError("LatencyMatrix::open(): Error calling stat: %s",
+                            strerror(errno));
+    }
+    dataSize = filestat.st_size;
+
+    if (dataSize < sizeof(LatencyMatrixHeader)) {
+        ::close(fd);
+        throw cRuntimeError("LatencyMatrix::open(): %s is not a latency "
+                            "matrix file!", name.c_str());
+    }
+
+#ifndef _WIN32
+    // shared mapping, so parallel runs use the same pages
+    void* mapping = mmap(0, dataSize, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        ::close(fd);
+        throw cRuntimeError("LatencyMatrix::open(): Error mapping file to "
+                            "memory: %s", strerror(errno));
+    }
+    data = (const char*)mapping;
+#else
+    char* buffer = new char[dataSize];
+    size_t numRead = 0;
+    while (numRead < dataSize) {
+        int n = read(fd, buffer + numRead, dataSize - numRead);
+        if (n <= 0) {
+            delete[] buffer;
+            ::close(fd);
+            throw cRuntimeError("LatencyMatrix::open(): Error reading %s",
+                                name.c_str());
+        }
+        numRead += n;
+    }
+    data = buffer;
+#endif
+    ::close(fd);
+
+    const LatencyMatrixHeader* header = (const LatencyMatrixHeader*)data;
+    uint64_t matrixSize = (uint64_t)header->numNodes * header->numNodes *
+        sizeof(uint16_t);
+
+    if (memcmp(header->magic, LATENCY_MATRIX_MAGIC, sizeof(header->magic)) ||
+        header->version != LATENCY_MATRIX_VERSION ||
+        header->resolution <= 0 ||
+        dataSize != sizeof(LatencyMatrixHeader) + matrixSize) {
+        close();
+        throw cRuntimeError("LatencyMatrix::open(): %s is not a valid "
+                            "latency matrix file!", name.c_str());
+    }
+
+    if (header->numNodes == 0) {
+        close();
+        throw cRuntimeError("LatencyMatrix::open(): %s contains no nodes!",
+                            name.c_str());
+    }
+
+    fileName = name;
+    numNodes = header->numNodes;
+    delayScale = header->resolution / 2;
+    rtts = (const uint16_t*)(data + sizeof(LatencyMatrixHeader));
+
+    EV << "[LatencyMatrix::open()]\n"
+       << "    Using RTTs of " << numNodes << " nodes from " << fileName
+       << endl;
+}
+
+void LatencyMatrix::close()
+{
+    if (data != NULL) {
+#ifndef _WIN32
+        munmap((void*)data, dataSize);
+#else
+        delete[] data;
+#endif
+    }
+
+    fileName = "";
+    data = NULL;
+    dataSize = 0;
+    rtts = NULL;
+    numNodes = 0;
+    delayScale = 0;
+}
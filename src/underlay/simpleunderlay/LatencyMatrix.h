@@ -0,0 +1,98 @@
+//
+// Copyright (C) 2026 agent <agent@local>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+/**
+ * @file LatencyMatrix.h
+ * @author agent
+ */
+
+#ifndef __LATENCYMATRIX_H__
+#define __LATENCYMATRIX_H__
+
+#include <string>
+#include <stdint.h>
+
+#include <omnetpp.h>
+
+/**
+ * Header of a latency matrix file
+ *
+ * The header is followed by numNodes * numNodes uint16_t RTTs in
+ * row-major order, i.e. the RTT from node i to node j is stored at
+ * position i * numNodes + j in units of resolution seconds. All fields
+ * are in host byte order. Files are created with
+ * simulations/tools/latencymatrix.py.
+ */
+struct LatencyMatrixHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t numNodes;
+    double resolution; /**< seconds per unit of the stored RTTs */
+};
+
+/**
+ * Measured round trip times between all pairs of a set of hosts,
+ * mapped read-only into memory
+ *
+ * The SimpleUnderlayConfigurator assigns a row of the matrix to every
+ * overlay terminal, SimpleNodeEntry uses half of the RTT between the
+ * rows as one-way delay. Several simulations running on the same
+ * machine share the pages of the mapped file.
+ *
+ * @author agent
+ */
+class LatencyMatrix
+{
+  public:
+    LatencyMatrix();
+    ~LatencyMatrix();
+
+    /**
+     * Maps the given file, does nothing if the file is already open
+     *
+     * @param fileName the latency matrix file
+     */
+    void open(const std::string& fileName);
+
+    /**
+     * Unmaps the current file
+     */
+    void close();
+
+    /** Returns the number of hosts (rows) of the matrix */
+    uint32_t getNumNodes() const { return numNodes; };
+
+    /**
+     * Returns the one-way delay from row src to row dest
+     */
+    simtime_t getDelay(uint32_t src, uint32_t dest) const
+    {
+        return rtts[(size_t)src * numNodes + dest] * delayScale;
+    };
+
+  private:
+    std::string fileName; /**< name of the mapped file */
+    const char* data; /**< mapped file */
+    size_t dataSize;
+    const uint16_t* rtts; /**< the matrix */
+    uint32_t numNodes;
+    double delayScale; /**< one-way delay in s per unit of the stored RTTs */
+};
+
+#endif
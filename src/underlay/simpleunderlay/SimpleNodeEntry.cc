@@ -27,6 +27,7 @@
 #include "SimpleNodeEntry.h"
 #include "SimpleUDP.h"
 #include "SimpleTCP.h"
+#include "LatencyMatrix.h"
 #include "SHA1.h"
 #include "OverlayKey.h"
 #include "BinaryValue.h"
@@ -81,6 +82,8 @@ SimpleNodeEntry::SimpleNodeEntry(cModule* node,
 
     nodeRecord = new NodeRecord;
     index = -1;
+    latencyMatrix = NULL;
+    latencyRow = 0;
 
     //use random values as coordinates
     nodeRecord->coords[0] = uniform(0, fieldSize) - fieldSize / 2;
@@ -122,6 +125,8 @@ SimpleNodeEntry::SimpleNodeEntry(cModule* node,
 
     this->nodeRecord = nodeRecord;
     this->index = index;
+    latencyMatrix = NULL;
+    latencyRow = 0;
 
     cDatarateChannel* tempRx = dynamic_cast<cDatarateChannel*>(typeRx->create("temp"));
     cDatarateChannel* tempTx = dynamic_cast<cDatarateChannel*>(typeTx->create("temp"));
@@ -152,6 +157,22 @@ float SimpleNodeEntry::operator-(const SimpleNodeEntry& entry) const
     return sqrt(sum_of_squares);
 }
 
+simtime_t SimpleNodeEntry::getPathDelay(const SimpleNodeEntry& dest,
+                                        bool faultyDelay) const
+{
+    // measured delays already violate the triangle inequality
+    if (latencyMatrix) {
+        return latencyMatrix->getDelay(latencyRow, dest.latencyRow);
+    }
+
+    simtime_t coordDelay = 0.001 * (*this - dest);
+
+    if (faultyDelay)
+        coordDelay = getFaultyDelay(coordDelay);
+
+    return coordDelay;
+}
+
 SimpleNodeEntry::SimpleDelay SimpleNodeEntry::calcDelay(cPacket* msg,
                                                         const SimpleNodeEntry& dest,
                                                         bool faultyDelay)
@@ -162,8 +183,12 @@ SimpleNodeEntry::SimpleDelay SimpleNodeEntry::calcDelay(cPacket* msg,
     }
 
     simtime_t now = simTime();
-    simtime_t bandwidthDelay= ((msg->getByteLength() * 8) / tx.bandwidth);
-    simtime_t newTxFinished = std::max(tx.finished, now) + bandwidthDelay;
+    simtime_t start = std::max(tx.finished, now);
+
+    // packets share the access links with the active flows
+    double txRate = tx.bandwidth / (getActiveFlows(tx, start) + 1);
+    simtime_t bandwidthDelay= ((msg->getByteLength() * 8) / txRate);
+    simtime_t newTxFinished = start + bandwidthDelay;
 
     // send queue
     if ((newTxFinished > now + tx.maxQueueTime) && (tx.maxQueueTime != 0)) {
@@ -182,11 +207,9 @@ SimpleNodeEntry::SimpleDelay SimpleNodeEntry::calcDelay(cPacket* msg,
 
     tx.finished = newTxFinished;
 
-    simtime_t destBandwidthDelay = (msg->getByteLength() * 8) / dest.rx.bandwidth;
-    simtime_t coordDelay = 0.001 * (*this - dest);
-
-    if (faultyDelay)
-        coordDelay = getFaultyDelay(coordDelay);
+    double rxRate = dest.rx.bandwidth / (getActiveFlows(dest.rx, now) + 1);
+    simtime_t destBandwidthDelay = (msg->getByteLength() * 8) / rxRate;
+    simtime_t coordDelay = getPathDelay(dest, faultyDelay);
 
     return SimpleDelay(tx.finished - now
                        + tx.accessDelay
@@ -194,6 +217,46 @@ SimpleNodeEntry::SimpleDelay SimpleNodeEntry::calcDelay(cPacket* msg,
                        + destBandwidthDelay + dest.rx.accessDelay, true);
 }
 
+size_t SimpleNodeEntry::getActiveFlows(const Channel& channel,
+                                       simtime_t time)
+{
+    while (!channel.flows.empty() && channel.flows.top() <= time) {
+        channel.flows.pop();
+    }
+
+    return channel.flows.size();
+}
+
+SimpleNodeEntry::SimpleDelay SimpleNodeEntry::calcFlowDelay(cPacket* msg,
+                                                            SimpleNodeEntry& dest,
+                                                            bool faultyDelay)
+{
+    simtime_t now = simTime();
+
+    // the flow starts after the packets in the send queue
+    simtime_t start = std::max(tx.finished, now);
+
+    // max-min fair share of the bottleneck access link at admission,
+    // later flows and packets don't slow this flow down (approximation).
+    // The tx channel is only queried at its own start times, the rx
+    // channel is shared by all senders, so it's queried at the current time.
+    double txRate = tx.bandwidth / (getActiveFlows(tx, start) + 1);
+    double rxRate = dest.rx.bandwidth / (getActiveFlows(dest.rx, now) + 1);
+
+    simtime_t completion = start + (msg->getByteLength() * 8) /
+                                   std::min(txRate, rxRate);
+
+    tx.flows.push(completion);
+    dest.rx.flows.push(completion);
+
+    simtime_t coordDelay = getPathDelay(dest, faultyDelay);
+
+    return SimpleDelay(completion - now
+                       + tx.accessDelay
+                       + coordDelay
+                       + dest.rx.accessDelay, true);
+}
+
 simtime_t SimpleNodeEntry::getFaultyDelay(simtime_t oldDelay) {
 
     // hash over string of oldDelay
@@ -279,7 +342,8 @@ std::ostream& operator<<(std::ostream& out, const SimpleNodeEntry& entry)
         << ",\ndelay = " << entry.tx.accessDelay
         << ",\nerrorRate = " << entry.tx.errorRate
         << ",\ntxMaxQueueTime = " << entry.tx.maxQueueTime
-        << ",\ntxFinished = " << entry.tx.finished;
+        << ",\ntxFinished = " << entry.tx.finished
+        << ",\nflows = " << entry.tx.flows.size();
 
     return out;
 }
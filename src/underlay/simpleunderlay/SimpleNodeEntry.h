@@ -27,12 +27,17 @@
 #define __SIMPLENODEENTRY_H
 
 
+#include <vector>
+#include <queue>
+#include <functional>
+
 #include <omnetpp.h>
 #include <IPvXAddress.h>
 
 #include "UDPPacket_m.h"
 #include "TCPSegment.h"
 
+class LatencyMatrix;
 
 class NodeRecord
 {
@@ -145,6 +150,26 @@ public:
                           const SimpleNodeEntry& dest,
                           bool faultyDelay = false);
 
+    /**
+     * Calculates the completion time of a bulk transfer between two nodes
+     * in the flow-level model. The flow starts when the send queue
+     * is drained and gets the max-min fair share of the bottleneck access
+     * link, i.e. the bandwidth is shared equally between the flows
+     * active on the sender's tx and the receiver's rx channel.
+     * Flows already in progress keep their rate, so the share is an
+     * approximation fixed at the start of the flow. Packets sent by
+     * calcDelay() during a flow get an equal share of the link, too. Flows are reliable,
+     * so they are never dropped due to queue overruns or bit errors.
+     *
+     * @param msg pointer to message to get its length
+     * @param dest destination terminal
+     * @param faultyDelay violate triangle inequality?
+     * @return delay in s until the last byte arrived (always valid)
+     */
+    SimpleDelay calcFlowDelay(cPacket* msg,
+                              SimpleNodeEntry& dest,
+                              bool faultyDelay = false);
+
     /**
      * OMNeT++ info method
      *
@@ -182,6 +207,25 @@ public:
     int getRecordIndex() const { return index; };
     NodeRecord* getNodeRecord() const { return nodeRecord; };
 
+    /**
+     * Uses the measured delays of the given row of a latency matrix
+     * instead of the coordinate based delays
+     *
+     * @param matrix the latency matrix
+     * @param row the row of this node
+     */
+    void setLatencyRow(const LatencyMatrix* matrix, uint32_t row)
+    {
+        latencyMatrix = matrix;
+        latencyRow = row;
+    };
+
+    /**
+     * Returns the row of this node in the latency matrix, -1 if the
+     * delays are coordinate based
+     */
+    int getLatencyRow() const { return latencyMatrix ? (int)latencyRow : -1; };
+
     /**
      * Calculates SHA1 hash over errorfree delay (always the same uniform distributed
      * value), uses this to generate a realistic error distribution and
@@ -211,10 +255,30 @@ protected:
         simtime_t accessDelay; //!< first hop delay
         double bandwidth; //!< bandwidth in access net
         double errorRate; //!< packet loss rate
+        //! completion times of the active flow-level transfers, earliest first
+        mutable std::priority_queue<simtime_t, std::vector<simtime_t>,
+                                    std::greater<simtime_t> > flows;
     } rx, tx;
 
+    /**
+     * Removes the flows finished at the given time and returns the
+     * number of flows still active. The time must not decrease between
+     * calls for the same channel.
+     */
+    static size_t getActiveFlows(const Channel& channel, simtime_t time);
+
+    /**
+     * Returns the delay between the access routers of two nodes
+     * (latency matrix or coordinate based)
+     */
+    simtime_t getPathDelay(const SimpleNodeEntry& dest,
+                           bool faultyDelay) const;
+
     NodeRecord* nodeRecord;
     int index;
+
+    const LatencyMatrix* latencyMatrix; //!< measured delays, NULL for coordinate based delays
+    uint32_t latencyRow; //!< row of this node in latencyMatrix
 };
 
 
@@ -39,6 +39,7 @@
 #include "IPDatagram_m.h"
 #include "TCPSegment.h"
 #include "SimpleTCP.h"
+#include "SimpleTCPFlow_m.h"
 #include "TCPCommand_m.h"
 #include "IPControlInfo.h"
 #include "IPv6ControlInfo.h"
@@ -98,9 +99,11 @@ void SimpleTCP::initialize(int stage)
         sad.numQueueLost = 0;
         sad.numPartitionLost = 0;
         sad.numDestUnavailableLost = 0;
+        sad.numFlows = 0;
         WATCH(sad.numQueueLost);
         WATCH(sad.numPartitionLost);
         WATCH(sad.numDestUnavailableLost);
+        WATCH(sad.numFlows);
 
         sad.globalNodeList = GlobalNodeListAccess().get();
         sad.globalStatistics = GlobalStatisticsAccess().get();
@@ -123,6 +126,7 @@ void SimpleTCP::initialize(int stage)
         }
 
         sad.jitter = par("jitter");
+        sad.flowLevelModel = par("flowLevelModel");
         sad.nodeEntry = NULL;
         WATCH_PTR(sad.nodeEntry);
     }
@@ -138,6 +142,10 @@ void SimpleTCP::finish()
                                 sad.numPartitionLost);
     sad.globalStatistics->addStdDev("SimpleTCP: Packets dropped due to unavailable destination",
                                 sad.numDestUnavailableLost);
+    if (sad.flowLevelModel) {
+        sad.globalStatistics->addStdDev("SimpleTCP: Flows sent",
+                                    sad.numFlows);
+    }
 }
 
 void SimpleTCP::handleMessage(cMessage *msg)
@@ -151,7 +159,11 @@ void SimpleTCP::handleMessage(cMessage *msg)
     }
     else if (msg->arrivedOn("ipIn") || msg->arrivedOn("ipv6In"))
     {
-        if (dynamic_cast<ICMPMessage *>(msg) || dynamic_cast<ICMPv6Message *>(msg))
+        if (dynamic_cast<SimpleTCPFlow*>(msg))
+        {
+            handleFlow(static_cast<SimpleTCPFlow*>(msg));
+        }
+        else if (dynamic_cast<ICMPMessage *>(msg) || dynamic_cast<ICMPv6Message *>(msg))
         {
             tcpEV << "ICMP error received -- discarding\n"; // FIXME can ICMP packets really make it up to TCP???
             delete msg;
@@ -218,15 +230,60 @@ void SimpleTCP::handleMessage(cMessage *msg)
 
             tcpEV << "TCP connection created for " << msg << "\n";
         }
-        bool ret = conn->processAppCommand(msg);
-        if (!ret)
-            removeConnection(conn);
+
+        if (sad.flowLevelModel && msg->getKind() == TCP_C_SEND &&
+            conn->canSendFlow()) {
+            conn->sendFlow(check_and_cast<cPacket*>(msg));
+        } else {
+            bool ret = conn->processAppCommand(msg);
+            if (!ret)
+                removeConnection(conn);
+        }
     }
 
     if (ev.isGUI())
         updateDisplayString();
 }
 
+void SimpleTCP::handleFlow(SimpleTCPFlow* flow)
+{
+    IPvXAddress srcAddr, destAddr;
+    cObject* controlInfo = flow->removeControlInfo();
+
+    if (dynamic_cast<IPControlInfo*>(controlInfo) != NULL) {
+        srcAddr = static_cast<IPControlInfo*>(controlInfo)->getSrcAddr();
+        destAddr = static_cast<IPControlInfo*>(controlInfo)->getDestAddr();
+    } else if (dynamic_cast<IPv6ControlInfo*>(controlInfo) != NULL) {
+        srcAddr = static_cast<IPv6ControlInfo*>(controlInfo)->getSrcAddr();
+        destAddr = static_cast<IPv6ControlInfo*>(controlInfo)->getDestAddr();
+    } else {
+        error("(%s)%s arrived without control info", flow->getClassName(), flow->getName());
+    }
+    delete controlInfo;
+
+    SockPair key;
+    key.localAddr = destAddr;
+    key.remoteAddr = srcAddr;
+    key.localPort = flow->getDestPort();
+    key.remotePort = flow->getSrcPort();
+
+    cPacket* payload = flow->decapsulate();
+    delete flow;
+
+    TcpConnMap::iterator it = tcpConnMap.find(key);
+
+    if (it == tcpConnMap.end()) {
+        EV << "[SimpleTCP::handleFlow() @ " << destAddr << "]\n"
+           << "    No connection for flow from " << srcAddr << ":"
+           << key.remotePort << " -- discarding"
+           << endl;
+        delete payload;
+        return;
+    }
+
+    static_cast<SimpleTCPConnection*>(it->second)->sendFlowToApp(payload);
+}
+
 void SimpleTCP::setNodeEntry(SimpleNodeEntry* entry)
 {
     sad.nodeEntry = entry;
@@ -311,6 +368,134 @@ void SimpleTCPConnection::sendRstAck(uint32 seq, uint32 ack, IPvXAddress src, IP
     SimpleTCPConnection::sendToIP(tcpseg, src, dest);
 }
 
+simtime_t SimpleTCPConnection::getInOrderDelay(simtime_t delay)
+{
+    simtime_t now = simTime();
+
+    if (now + delay < lastArrival) {
+        delay = lastArrival - now;
+    }
+    lastArrival = now + delay;
+
+    return delay;
+}
+
+void SimpleTCPConnection::sendFlowToApp(cPacket* msg)
+{
+    msg->setKind(TCP_I_DATA);
+    TCPCommand *cmd = new TCPCommand();
+    cmd->setConnId(connId);
+    msg->setControlInfo(cmd);
+    sendToApp(msg);
+}
+
+bool SimpleTCPConnection::canSendFlow()
+{
+    if (getFsmState() != TCP_S_ESTABLISHED &&
+        getFsmState() != TCP_S_CLOSE_WAIT) {
+        return false;
+    }
+
+    // a flow must not overtake segment data, which is still queued
+    // or not yet acknowledged
+    return (state->snd_una == state->snd_max) &&
+           (sendQueue->getBytesAvailable(state->snd_max) == 0);
+}
+
+void SimpleTCPConnection::sendFlow(cPacket* msg)
+{
+    StatisticsAndDelay& sad = dynamic_cast<SimpleTCP*>(tcpMain)->sad;
+
+    delete msg->removeControlInfo();
+
+    // one header for the whole flow
+    SimpleTCPFlow* flow = new SimpleTCPFlow(msg->getName());
+    flow->setSrcPort(localPort);
+    flow->setDestPort(remotePort);
+    flow->setByteLength(TCP_HEADER_OCTETS + (remoteAddr.isIPv6() ?
+                                             IPv6_HEADER_BYTES :
+                                             IP_HEADER_BYTES));
+    flow->encapsulate(msg);
+
+    const IPvXAddress& src = IPAddressResolver().addressOf(tcpMain->getParentModule());
+    const IPvXAddress& dest = remoteAddr;
+
+    SimpleInfo* info = dynamic_cast<SimpleInfo*>(sad.globalNodeList->getPeerInfo(dest));
+    SimpleInfo* thisInfo = dynamic_cast<SimpleInfo*>(sad.globalNodeList->getPeerInfo(src));
+
+    if (info == NULL) {
+        EV << "[SimpleTCPConnection::sendFlow() @ " << src << "]\n"
+           << "    No route to host " << dest
+           << endl;
+
+        delete flow;
+        sad.numDestUnavailableLost++;
+        return;
+    }
+
+    if (!sad.globalNodeList->areNodeTypesConnected(thisInfo->getTypeID(), info->getTypeID())) {
+        EV << "[SimpleTCPConnection::sendFlow() @ " << src << "]\n"
+                   << "    Partition " << thisInfo->getTypeID() << "->" << info->getTypeID()
+                   << " is not connected"
+                   << endl;
+        delete flow;
+        sad.numPartitionLost++;
+        return;
+    }
+
+    SimpleNodeEntry* destEntry = info->getEntry();
+    sad.numFlows++;
+
+    // completion time of the flow
+    simtime_t totalDelay = 0;
+    if (src != dest) {
+        SimpleNodeEntry::SimpleDelay temp =
+            sad.nodeEntry->calcFlowDelay(flow, *destEntry, sad.faultyDelay &&
+                                         !(thisInfo->getNpsLayer() == 0 ||
+                                           info->getNpsLayer() == 0));
+        if (sad.useCoordinateBasedDelay == false) {
+            totalDelay = sad.constantDelay;
+        } else {
+            totalDelay = temp.first;
+        }
+    }
+
+    if (sad.jitter) {
+        // jitter, see sendToIP()
+        double temp = truncnormal(0, SIMTIME_DBL(totalDelay) * sad.jitter);
+        while (temp == INFINITY || temp != temp) { // reroll if temp is INF or NaN
+            temp = truncnormal(0, SIMTIME_DBL(totalDelay) * sad.jitter);
+        }
+
+        totalDelay += temp;
+    }
+
+    totalDelay = getInOrderDelay(totalDelay);
+
+    EV << "[SimpleTCPConnection::sendFlow() @ " << src << "]\n"
+       << "    Flow " << flow << " (" << flow->getByteLength()
+       << " bytes) completes after " << totalDelay
+       << endl;
+
+    if (!dest.isIPv6()) {
+        IPControlInfo *controlInfo = new IPControlInfo();
+        controlInfo->setProtocol(IP_PROT_TCP);
+        controlInfo->setSrcAddr(src.get4());
+        controlInfo->setDestAddr(dest.get4());
+        flow->setControlInfo(controlInfo);
+
+        tcpMain->sendDirect(flow, totalDelay, 0, destEntry->getTcpIPv4Gate());
+    } else {
+        IPv6ControlInfo *controlInfo = new IPv6ControlInfo();
+        controlInfo->setProtocol(IP_PROT_TCP);
+        controlInfo->setSrcAddr(src.get6());
+        controlInfo->setDestAddr(dest.get6());
+        flow->setControlInfo(controlInfo);
+
+        tcpMain->sendDirect(flow, totalDelay, 0, destEntry->getTcpIPv6Gate());
+    }
+}
+
 void SimpleTCPConnection::sendToIP(TCPSegment *tcpseg)
 {
     StatisticsAndDelay& sad = dynamic_cast<SimpleTCP*>(tcpMain)->sad;
@@ -416,7 +601,10 @@ void SimpleTCPConnection::sendToIP(TCPSegment *tcpseg)
         totalDelay += temp;
     }
 
-
+    if (sad.flowLevelModel) {
+        // don't overtake flows sent before
+        totalDelay = getInOrderDelay(totalDelay);
+    }
 
     EV << "[SimpleTCPConnection::sendToIP() @ " << src << "]\n"
        << "    Packet " << tcpseg << " sent with delay = " << totalDelay
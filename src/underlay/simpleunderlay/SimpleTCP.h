@@ -38,6 +38,7 @@
 #include <InitStages.h>
 
 class SimpleNodeEntry;
+class SimpleTCPFlow;
 
 
 struct StatisticsAndDelay {
@@ -59,11 +60,13 @@ public:
     int numQueueLost; /**< number of lost packets due to queue full */
     int numPartitionLost; /**< number of lost packets due to network partitions */
     int numDestUnavailableLost; /**< number of lost packets due to unavailable destination */
+    int numFlows; /**< number of sent flows in the flow-level model */
     simtime_t delay; /**< simulated delay between sending and receiving udp module */
 
     simtime_t constantDelay; /**< constant delay between two peers */
     bool useCoordinateBasedDelay; /**< delay should be calculated from euklidean distance between two peers */
     double jitter; /**< amount of jitter in % of total delay */
+    bool flowLevelModel; /**< deliver the data of each send command as a single flow */
     bool faultyDelay; /** violate the triangle inequality?*/
     GlobalNodeList* globalNodeList; /**< pointer to GlobalNodeList */
     GlobalStatistics* globalStatistics; /**< pointer to GlobalStatistics */
@@ -73,12 +76,32 @@ public:
 class SimpleTCPConnection : public TCPConnection {
 
 public:
-    SimpleTCPConnection():TCPConnection(){};
-    SimpleTCPConnection(TCP* mod, int appGateIndex, int connId):TCPConnection(mod, appGateIndex, connId){};
+    SimpleTCPConnection():TCPConnection(){ lastArrival = 0; };
+    SimpleTCPConnection(TCP* mod, int appGateIndex, int connId):TCPConnection(mod, appGateIndex, connId){ lastArrival = 0; };
 
     /** Utility: adds control info to segment and sends it to the destination node */
     virtual void sendToIP(TCPSegment *tcpseg);
 
+    /**
+     * Flow-level model: sends the payload of a send command as one flow,
+     * which arrives when its last byte would have been received. The
+     * TCP state machine is bypassed, only connection setup and teardown
+     * use segments.
+     *
+     * @param msg the payload from the application
+     */
+    void sendFlow(cPacket* msg);
+
+    /**
+     * Flow-level model: returns true, if the connection is established
+     * and all segment data sent before has been acknowledged, so the
+     * next send command can be sent as a flow
+     */
+    bool canSendFlow();
+
+    /** Flow-level model: passes a received flow payload to the application */
+    void sendFlowToApp(cPacket* msg);
+
     static StatisticsAndDelay sad;
 
     /** Utility: sends RST; does not use connection state */
@@ -93,6 +116,14 @@ protected:
     /** Utility: clone a listening connection. Used for forking. */
     SimpleTCPConnection *cloneListeningConnection();
 
+    /**
+     * Flow-level model: delays a segment or flow until everything sent
+     * before has arrived, so flows and segments (e.g. FIN) stay in order
+     */
+    simtime_t getInOrderDelay(simtime_t delay);
+
+    simtime_t lastArrival; /**< arrival time of the last segment or flow sent */
+
 };
 
 class SimpleTCP : public TCP {
@@ -112,6 +143,9 @@ protected:
   virtual void initialize(int stage);
   virtual void handleMessage(cMessage *msg);
 
+  /** Flow-level model: delivers an arrived flow to its connection */
+  void handleFlow(SimpleTCPFlow* flow);
+
   virtual int numInitStages() const
   {
       return MAX_STAGE_UNDERLAY + 1;
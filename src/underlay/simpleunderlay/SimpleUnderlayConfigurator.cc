@@ -38,10 +38,12 @@
 #include <cxmlelement.h>
 #include "ChurnGenerator.h"
 #include "GlobalNodeList.h"
+#include <GlobalCheckpointAccess.h>
 #include <StringConvert.h>
 
 #include "SimpleUDP.h"
 #include "SimpleTCP.h"
+#include "LatencyMatrix.h"
 
 #include "SimpleUnderlayConfigurator.h"
 
@@ -49,6 +51,27 @@ Define_Module(SimpleUnderlayConfigurator);
 
 using namespace std;
 
+/**
+ * The coordinates of the last parsed coordinate file. Cmdenv executes
+ * consecutive runs in the same process (e.g. with the sweep runner in
+ * simulations/tools), so the xml file only has to be parsed once.
+ */
+struct CoordFileCache
+{
+    std::string fileName;
+    int dimensions;
+    uint32_t maxCoordinate;
+    std::vector<double> coords; /**< dimensions coordinates per node */
+};
+
+static CoordFileCache coordFileCache;
+
+/**
+ * The mapped latency matrix, which stays mapped for consecutive runs
+ * with the same file
+ */
+static LatencyMatrix latencyMatrix;
+
 SimpleUnderlayConfigurator::~SimpleUnderlayConfigurator()
 {
     for (uint32_t i = 0; i < nodeRecordPool.size(); ++i) {
@@ -98,9 +121,25 @@ void SimpleUnderlayConfigurator::initializeUnderlay(int stage)
         << "    (no XML coordinate source file was specified)" << endl;
     }
 
+    // measured delays between the nodes
+    latencyMatrixFile = par("latencyMatrixFile").stdstringValue();
+    useLatencyMatrix = (latencyMatrixFile != "");
+    latencyRowPool.clear();
+
+    if (useLatencyMatrix) {
+        latencyMatrix.open(latencyMatrixFile);
+        latencyRowPool.resize(latencyMatrix.getNumNodes(), true);
+
+        EV << "[SimpleNetConfigurator::initializeUnderlay()]\n"
+           << "    Using delays of '" << latencyMatrixFile
+           << "' instead of coordinate based delays" << endl;
+    }
+
     // FIXME get address from parameter
     nextFreeAddress = 0x1000001;
 
+    globalCheckpoint = GlobalCheckpointAccess().get();
+
     // count the overlay clients
     overlayTerminalCount = 0;
 
@@ -141,7 +180,27 @@ TransportAddress* SimpleUnderlayConfigurator::createNode(NodeType type,
     }
 
     IPvXAddress addr;
-    if (useIPv6) {
+    std::vector<double> restoredCoords;
+    int32_t restoredRecordIndex = -1;
+    int32_t restoredLatencyRow = -1;
+    bool restored = (globalCheckpoint != NULL) &&
+        globalCheckpoint->restoreNode(type.typeID, addr, restoredCoords,
+                                      restoredRecordIndex, restoredLatencyRow);
+
+    if (restored) {
+        if (globalNodeList->getPeerInfo(addr) != NULL) {
+            throw cRuntimeError("SimpleUnderlayConfigurator::createNode(): "
+                                "Restored address %s is already in use!",
+                                addr.str().c_str());
+        }
+
+        // new nodes get addresses behind all restored addresses
+        uint32 counter = addr.isIPv6() ? addr.get6().words()[1]
+                                       : addr.get4().getInt();
+        if (counter >= nextFreeAddress) {
+            nextFreeAddress = counter + 1;
+        }
+    } else if (useIPv6) {
         addr = IPv6Address(0, nextFreeAddress++, 0, 0);
     } else {
         addr = IPAddress(nextFreeAddress++);
@@ -158,7 +217,24 @@ TransportAddress* SimpleUnderlayConfigurator::createNode(NodeType type,
 
     SimpleNodeEntry* entry;
 
-    if (!useXmlCoords) {
+    if (restored && restoredCoords.size() == NodeRecord::dim) {
+        if (useXmlCoords && restoredRecordIndex >= 0 &&
+            (uint32_t)restoredRecordIndex < nodeRecordPool.size() &&
+            nodeRecordPool[restoredRecordIndex].second) {
+            // same coordinate source file as in the checkpoint
+            entry = new SimpleNodeEntry(node, rxChan, txChan, sendQueueLength,
+                                        nodeRecordPool[restoredRecordIndex].first,
+                                        restoredRecordIndex);
+            nodeRecordPool[restoredRecordIndex].second = false;
+        } else {
+            NodeRecord* record = new NodeRecord;
+            for (uint32_t i = 0; i < NodeRecord::dim; i++) {
+                record->coords[i] = restoredCoords[i];
+            }
+            entry = new SimpleNodeEntry(node, rxChan, txChan, sendQueueLength,
+                                        record, -1);
+        }
+    } else if (!useXmlCoords) {
         entry = new SimpleNodeEntry(node, rxChan, txChan, sendQueueLength, fieldSize);
     } else {
         // get random unused node
@@ -183,6 +259,33 @@ TransportAddress* SimpleUnderlayConfigurator::createNode(NodeType type,
         nodeRecordPool[volunteer].second = false;
     }
 
+    if (useLatencyMatrix) {
+        uint32_t row;
+        if (restored && restoredLatencyRow >= 0 &&
+            (uint32_t)restoredLatencyRow < latencyRowPool.size() &&
+            latencyRowPool[restoredLatencyRow]) {
+            row = restoredLatencyRow;
+        } else {
+            // get random unused row
+            row = intuniform(0, latencyRowPool.size() - 1);
+            uint32_t temp = row;
+            while (latencyRowPool[row] == false) {
+                ++row;
+                if (row >= latencyRowPool.size())
+                    row = 0;
+                // stop with errormessage if no more unused rows available
+                if (temp == row)
+                    throw cRuntimeError("No unused rows left -> "
+                        "cannot create any more nodes. "
+                        "Provide %s-file with more nodes!\n",
+                        latencyMatrixFile.c_str());
+            }
+        }
+
+        entry->setLatencyRow(&latencyMatrix, row);
+        latencyRowPool[row] = false;
+    }
+
     SimpleUDP* simpleUdp = check_and_cast<SimpleUDP*> (node->getSubmodule("udp"));
     simpleUdp->setNodeEntry(entry);
     SimpleTCP* simpleTcp = dynamic_cast<SimpleTCP*> (node->getSubmodule("tcp", 0));
@@ -253,6 +356,30 @@ TransportAddress* SimpleUnderlayConfigurator::createNode(NodeType type,
 
 uint32_t SimpleUnderlayConfigurator::parseCoordFile(const char* nodeCoordinateSource)
 {
+    if (coordFileCache.fileName == nodeCoordinateSource) {
+        dimensions = coordFileCache.dimensions;
+        NodeRecord::setDim(dimensions);
+
+        const std::vector<double>& coords = coordFileCache.coords;
+        for (size_t pos = 0; pos + dimensions <= coords.size();
+             pos += dimensions) {
+            NodeRecord* tmpNode = new NodeRecord;
+            for (int i = 0; i < dimensions; i++) {
+                tmpNode->coords[i] = coords[pos + i];
+            }
+            nodeRecordPool.push_back(make_pair(tmpNode, true));
+        }
+
+        EV << "[SimpleNetConfigurator::parseCoordFile()]\n"
+           << "    " << nodeRecordPool.size()
+           << " nodes added from cached coordinate file" << endl;
+
+        return coordFileCache.maxCoordinate;
+    }
+
+    coordFileCache.fileName = "";
+    coordFileCache.coords.clear();
+
     cXMLElement* rootElement = ev.getXMLDocument(nodeCoordinateSource);
 
     // get number of dimensions from attribute of xml rootelement
@@ -291,6 +418,10 @@ uint32_t SimpleUnderlayConfigurator::parseCoordFile(const char* nodeCoordinateSo
             i++;
         }
 
+        coordFileCache.coords.insert(coordFileCache.coords.end(),
+                                     tmpNode->coords,
+                                     tmpNode->coords + dimensions);
+
         // add to vector
         nodeRecordPool.push_back(make_pair(tmpNode, true));
 
@@ -305,7 +436,11 @@ uint32_t SimpleUnderlayConfigurator::parseCoordFile(const char* nodeCoordinateSo
     ev.forgetXMLDocument(nodeCoordinateSource);
     malloc_trim(0);
 #endif
-    
+
+    coordFileCache.fileName = nodeCoordinateSource;
+    coordFileCache.dimensions = dimensions;
+    coordFileCache.maxCoordinate = (uint32_t)ceil(max_coord);
+
     return (uint32_t)ceil(max_coord);
 }
 
@@ -422,16 +557,26 @@ void SimpleUnderlayConfigurator::migrateNode(NodeType type, TransportAddress* ad
              "channels.ned");
 
     if (useXmlCoords) {
+       // records restored from a checkpoint are owned by their entry
+       NodeRecord* record = entry->getNodeRecord();
+       if (entry->getRecordIndex() < 0) {
+           record = new NodeRecord(*record);
+       }
        newentry = new SimpleNodeEntry(node,
                                       rxChan,
                                       txChan,
                                       sendQueueLength,
-                                      entry->getNodeRecord(), entry->getRecordIndex());
+                                      record, entry->getRecordIndex());
         //newentry->getNodeRecord()->ip = address;
     } else {
         newentry = new SimpleNodeEntry(node, rxChan, txChan, fieldSize, sendQueueLength);
     }
 
+    // the node keeps its row of the latency matrix
+    if (entry->getLatencyRow() >= 0) {
+        newentry->setLatencyRow(&latencyMatrix, entry->getLatencyRow());
+    }
+
     node->bubble("I am migrating!");
 
     //remove node from bootstrap oracle
@@ -487,10 +632,14 @@ void SimpleUnderlayConfigurator::handleTimerEvent(cMessage* msg)
     cGate* gate = entry->getUdpIPv4Gate();
     cModule* node = gate->getOwnerModule()->getParentModule();
 
-    if (useXmlCoords) {
+    if (useXmlCoords && entry->getRecordIndex() >= 0) {
         nodeRecordPool[entry->getRecordIndex()].second = true;
     }
 
+    if (entry->getLatencyRow() >= 0) {
+        latencyRowPool[entry->getLatencyRow()] = true;
+    }
+
     scheduledID.erase(node->getId());
     globalNodeList->killPeer(addr);
 
@@ -34,6 +34,8 @@
 #include <InitStages.h>
 #include <SimpleInfo.h>
 
+class GlobalCheckpoint;
+
 
 /**
  * Sets up a SimpleNetwork.
@@ -112,6 +114,12 @@ protected:
 
     std::vector<std::pair<NodeRecord*, bool> > nodeRecordPool;
 
+    bool useLatencyMatrix; /**< use measured delays of latencyMatrixFile */
+    std::string latencyMatrixFile;
+    std::vector<bool> latencyRowPool; /**< true for unused rows of the latency matrix */
+
+    GlobalCheckpoint* globalCheckpoint; /**< restores nodes of a checkpoint */
+
     // statistics
     int numCreated; /**< number of overall created overlay terminals */
     int numKilled; /**< number of overall killed overlay terminals */